@@ -20,6 +20,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::lock_guard<recursive_mutex> guard(latch_);
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   
@@ -27,6 +28,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   if(iter != page_table_.end()){
     frame_id_t P=iter->second;
     pages_[P].pin_count_++;
+    replacer_->Pin(P);
     return &pages_[P];
   }
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -58,6 +60,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::lock_guard<recursive_mutex> guard(latch_);
   // 0.   Make sure you call AllocatePage!
    
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
@@ -93,11 +96,11 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-  // 0.   Make sure you call DeallocatePage!
-  DeallocatePage(page_id);
+  std::lock_guard<recursive_mutex> guard(latch_);
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
   if(page_table_.find(page_id) == page_table_.end()){
+    DeallocatePage(page_id);
     return true;
   }
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
@@ -110,7 +113,9 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
     pages_[P].is_dirty_ = 0;
   }
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+  // 0.   Make sure you call DeallocatePage!
   page_table_.erase(page_id);
+  replacer_->Pin(P);
   // pages_[P].ResetMemory();
   DeallocatePage(page_id);
   pages_[P].page_id_ = INVALID_PAGE_ID;
@@ -119,8 +124,16 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
   return true;
 }
 
+void BufferPoolManager::DeletePageWhenUnpinned(page_id_t page_id) {
+  std::lock_guard<recursive_mutex> guard(latch_);
+  if (!DeletePage(page_id)) {
+    deferred_deletes_.insert(page_id);
+  }
+}
+
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-if(page_table_.find(page_id) == page_table_.end()){
+  std::lock_guard<recursive_mutex> guard(latch_);
+  if(page_table_.find(page_id) == page_table_.end()){
     return false;
   }
   frame_id_t P = page_table_[page_id];
@@ -136,10 +149,14 @@ if(page_table_.find(page_id) == page_table_.end()){
   if(is_dirty){
     pages_[P].is_dirty_ = true;
   }
+  if(pages_[P].pin_count_ == 0 && deferred_deletes_.erase(page_id) > 0){
+    DeletePage(page_id);
+  }
   return true;
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::lock_guard<recursive_mutex> guard(latch_);
   if(page_table_.find(page_id) == page_table_.end()){
     return false;
   }
@@ -161,11 +178,13 @@ void BufferPoolManager::DeallocatePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
+  std::lock_guard<recursive_mutex> guard(latch_);
   return disk_manager_->IsPageFree(page_id);
 }
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::lock_guard<recursive_mutex> guard(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -133,18 +133,22 @@ CatalogManager::~CatalogManager() {
 }
 
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema,
-                                    Transaction *txn, TableInfo *&table_info, uint32_t prim_idx) {
+                                    Transaction *txn, TableInfo *&table_info, uint32_t prim_idx, TableLayout layout) {
   if(GetTable(table_name, table_info) != DB_TABLE_NOT_EXIST){
     table_info = nullptr;
     return DB_TABLE_ALREADY_EXIST;
   }
+  if (layout == TableLayout::kPaxLayout && PaxLayout(schema).GetCapacity() == 0) {
+    table_info = nullptr;
+    return DB_FAILED;
+  }
   // next_table_id_ = catalog_meta_->GetNextTableId();
   table_id_t table_id = next_table_id_++; //tables_.size();
   table_names_[table_name] = table_id;
 
-  TableHeap * table_heap = TableHeap::Create(buffer_pool_manager_, schema, nullptr, log_manager_, lock_manager_, heap_);
+  TableHeap * table_heap = TableHeap::Create(buffer_pool_manager_, schema, nullptr, log_manager_, lock_manager_, heap_, layout);
   TableMetadata * table_meta = TableMetadata::Create(table_id, table_name, \
-  table_heap->GetFirstPageId(), schema, heap_, prim_idx);
+  table_heap->GetFirstPageId(), schema, heap_, prim_idx, layout, table_heap->GetDictionaryPageId());
   table_info = TableInfo::Create(heap_);
   table_info->Init(table_meta, table_heap);
 
@@ -193,7 +197,8 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) {
+                                    IndexInfo *&index_info, IndexType index_type, bool unique,
+                                    const std::vector<std::string> &include_columns) {
   // next_index_id_ = catalog_meta_->GetNextIndexId();
   TableInfo * table_info;
   if(GetTable(table_name, table_info) == DB_TABLE_NOT_EXIST){
@@ -218,6 +223,28 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
     }
     key_map.emplace_back(column_id);
   }
+  //包含列只存放在索引中，不属于键
+  std::vector<uint32_t> include_map;
+  uint32_t max_key_size = unique || index_type == IndexType::kHash ? 0 : KEY_ROW_ID_SIZE;
+  for (auto column : key_map) {
+    max_key_size += IndexInfo::GetMaxKeySize(table_schema->GetColumn(column));
+  }
+  for (auto &name : include_columns) {
+    if (table_schema->GetColumnIndex(name, column_id) == DB_COLUMN_NAME_NOT_EXIST) {
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
+    if (find(key_map.begin(), key_map.end(), column_id) != key_map.end() ||
+        find(include_map.begin(), include_map.end(), column_id) != include_map.end()) {
+      cout << "包含列与索引键或其他包含列重复\n";
+      return DB_FAILED;
+    }
+    include_map.emplace_back(column_id);
+    max_key_size += IndexInfo::GetMaxKeySize(table_schema->GetColumn(column_id));
+  }
+  if (!include_map.empty() && max_key_size > MAX_INDEX_KEY_SIZE) {
+    cout << "索引键和包含列的总长度超过索引键的最大宽度\n";
+    return DB_FAILED;
+  }
   //把index_key里面说的column换算成对应的列号放到key_map里面；
   // printf("key_map.size = %ld\n",key_map.size());
   // for(auto iter = key_map.begin();iter != key_map.end(); iter++)
@@ -227,7 +254,7 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   
 
   IndexMetadata * meta_data = IndexMetadata::Create(index_id, index_name, \
-  table_info->GetTableId(), key_map, heap_);
+  table_info->GetTableId(), key_map, heap_, index_type, unique, include_map);
   index_info = IndexInfo::Create(heap_);
   // std::cout << "CatalogManager::CreateIndex flag1\n";
   index_info -> Init(meta_data, table_info, buffer_pool_manager_);
@@ -338,6 +365,73 @@ dberr_t CatalogManager::FlushCatalogMetaPage() const {
     return DB_FAILED;
 }
 
+dberr_t CatalogManager::AnalyzeTable(const std::string &table_name, TableStatistics *&statistics,
+                                     const TableSample *sample) {
+  TableInfo *table_info;
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    statistics = nullptr;
+    return DB_TABLE_NOT_EXIST;
+  }
+  statistics = TableStatistics::Collect(table_info->GetTableHeap(), table_info->GetSchema(), table_info->GetMemHeap(),
+                                       sample);
+  FreeStatistics(table_info->GetStatisticsPageId());
+  table_info->SetStatistics(statistics, WriteStatistics(statistics));
+  return DB_SUCCESS;
+}
+
+page_id_t CatalogManager::WriteStatistics(const TableStatistics *statistics) {
+  uint32_t length = statistics->GetSerializedSize();
+  std::unique_ptr<char[]> data(new char[length]);
+  statistics->SerializeTo(data.get());
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  uint32_t written = 0;
+  do {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(page_id));
+    page->Init();
+    uint32_t size = std::min(length - written, OverflowPage::MAX_DATA_SIZE);
+    memcpy(page->GetPayload(), data.get() + written, size);
+    page->SetDataSize(size);
+    written += size;
+    if (prev_page != nullptr) {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_page = page;
+    prev_page_id = page_id;
+  } while (written < length);
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  return first_page_id;
+}
+
+TableStatistics *CatalogManager::ReadStatistics(page_id_t page_id, MemHeap *heap) {
+  std::string data;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    data.append(page->GetPayload(), page->GetDataSize());
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  TableStatistics *statistics;
+  TableStatistics::DeserializeFrom(&data[0], statistics, heap);
+  return statistics;
+}
+
+void CatalogManager::FreeStatistics(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
 dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t page_id) {
   TableInfo * table_info = TableInfo::Create(heap_);
   TableMetadata * table_meta;
@@ -347,8 +441,13 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
   string table_name = table_meta->GetTableName();
   table_names_[table_name] = table_id;
 
-  TableHeap * table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(), nullptr, nullptr, table_info->GetMemHeap());
+  TableHeap * table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(), nullptr, nullptr, table_info->GetMemHeap(), table_meta->GetLayout(),
+                                             table_meta->GetDictionaryPageId());
   table_info->Init(table_meta, table_heap);//这里的table_heap怎么办？
+  if (table_meta->GetStatisticsPageId() != INVALID_PAGE_ID) {
+    TableStatistics *statistics = ReadStatistics(table_meta->GetStatisticsPageId(), table_info->GetMemHeap());
+    table_info->SetStatistics(statistics, table_meta->GetStatisticsPageId());
+  }
   tables_[table_id] = table_info;
 
   return DB_SUCCESS;
@@ -1,10 +1,28 @@
+#include <algorithm>
+
 #include "catalog/indexes.h"
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name,
                                      const table_id_t table_id, const vector<uint32_t> &key_map,
-                                     MemHeap *heap) {
+                                     MemHeap *heap, IndexType index_type, bool unique,
+                                     const vector<uint32_t> &include_map) {
   void *buf = heap->Allocate(sizeof(IndexMetadata));
-  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map);
+  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map, index_type, unique, include_map);
+}
+
+bool IndexMetadata::GetIndexTypeByName(const std::string &type_name, IndexType &index_type) {
+  std::string name = type_name;
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  if (name == "btree") {
+    index_type = IndexType::kBPlusTree;
+  } else if (name == "olc") {
+    index_type = IndexType::kOptimisticBPlusTree;
+  } else if (name == "hash") {
+    index_type = IndexType::kHash;
+  } else {
+    return false;
+  }
+  return true;
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -30,15 +48,27 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     MACH_WRITE_UINT32(buf, key_map_[i]);//write magic_num
     buf += sizeof(uint32_t);//update the buf
   }
-  return static_cast<uint32_t>( sizeof(uint32_t)*4 + \
-  index_name_.length() +  sizeof(int) +\
-  key_map_.size() * sizeof(uint32_t) );
+
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(index_type_));//write the type of the index
+  buf += sizeof(uint32_t);
+
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(unique_));//write whether keys are unique
+  buf += sizeof(uint32_t);
+
+  MACH_WRITE_UINT32(buf, include_map_.size());//write the included columns
+  buf += sizeof(uint32_t);
+  for (auto column : include_map_)
+  {
+    MACH_WRITE_UINT32(buf, column);
+    buf += sizeof(uint32_t);
+  }
+  return GetSerializedSize();
 }
 
 uint32_t IndexMetadata::GetSerializedSize() const {
-  return static_cast<uint32_t>( sizeof(uint32_t)*4 + \
+  return static_cast<uint32_t>( sizeof(uint32_t)*7 + \
   index_name_.length() + sizeof(int) +\
-  key_map_.size() * sizeof(uint32_t) );
+  (key_map_.size() + include_map_.size()) * sizeof(uint32_t) );
 }
 
 uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, MemHeap *heap) {
@@ -76,11 +106,53 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
     key_map.push_back(new_key_map);
   }
 
-  index_meta = ALLOC_P(heap,IndexMetadata)(index_id,index_name,table_id,key_map);
+  auto index_type = static_cast<IndexType>(MACH_READ_FROM(uint32_t, buf));
+  buf += sizeof(uint32_t);
+
+  bool unique = MACH_READ_FROM(uint32_t, buf) != 0;
+  buf += sizeof(uint32_t);
+
+  std::vector<uint32_t> include_map(MACH_READ_FROM(uint32_t, buf));
+  buf += sizeof(uint32_t);
+  for (auto &column : include_map)
+  {
+    column = MACH_READ_FROM(uint32_t, buf);
+    buf += sizeof(uint32_t);
+  }
+
+  index_meta = ALLOC_P(heap,IndexMetadata)(index_id,index_name,table_id,key_map,index_type,unique,include_map);
   
-  return static_cast<uint32_t>( sizeof(uint32_t)*4 + \
-  name_len +  sizeof(int) +\
-  n_key_map * sizeof(uint32_t) );
+  return index_meta->GetSerializedSize();
+}
+
+uint32_t IndexInfo::GetMaxKeySize(const Column *column) {
+  return column->IsNullable() + (column->GetType() == TypeId::kTypeChar ? column->GetLength() + 2 : sizeof(uint32_t));
+}
+
+bool IndexInfo::FitsKey(const Field &value) const {
+  const Column *column = key_schema_->GetColumn(0);
+  if (value.IsNull() || column->GetType() != TypeId::kTypeChar) {
+    return GetMaxKeySize(column) <= key_size_;
+  }
+  //0字节编码时被转义，多占一个字节
+  uint32_t size = column->IsNullable() + value.GetLength() + 2;
+  size += std::count(value.GetData(), value.GetData() + value.GetLength(), 0);
+  return size <= key_size_;
+}
+
+uint32_t IndexInfo::ChooseKeySize(const Schema *key_schema, bool unique) {
+  //按不含转义的最大长度选择，SQL中的字符串不含0字节，不会被转义
+  //非唯一索引的键后附加了row id
+  uint32_t max_size = unique ? 0 : KEY_ROW_ID_SIZE;
+  for (auto column : key_schema->GetColumns()) {
+    max_size += GetMaxKeySize(column);
+  }
+  for (auto key_size : INDEX_KEY_SIZES) {
+    if (max_size <= key_size) {
+      return key_size;
+    }
+  }
+  return MAX_INDEX_KEY_SIZE;
 }
 
 void IndexInfo::Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPoolManager *buffer_pool_manager) {
@@ -100,6 +172,8 @@ void IndexInfo::Init(IndexMetadata *meta_data, TableInfo *table_info, BufferPool
     // attrs.emplace_back((uint32_t)i);
     for(auto iter = meta_data->key_map_.begin();iter != meta_data->key_map_.end(); iter++)
       attrs.emplace_back(*(iter));
+    //包含列存放在键之后
+    attrs.insert(attrs.end(), meta_data->include_map_.begin(), meta_data->include_map_.end());
     //static Schema *ShallowCopySchema(const Schema *table_schema, const std::vector<uint32_t> &attrs, MemHeap *heap)
     //按照attrs里标记的顺序，把table_schema的列进行浅拷贝并返回
     
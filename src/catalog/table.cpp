@@ -23,11 +23,20 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
   MACH_WRITE_UINT32(buf, prim_idx_);//write prim_idx_
   buf += sizeof(uint32_t);
 
+  MACH_WRITE_UINT32(buf, static_cast<uint32_t>(layout_));//write layout_
+  buf += sizeof(uint32_t);
+
+  MACH_WRITE_INT32(buf, dictionary_page_id_);//write dictionary_page_id_
+  buf += sizeof(int32_t);
+
+  MACH_WRITE_INT32(buf, statistics_page_id_);//write statistics_page_id_
+  buf += sizeof(int32_t);
+
   return GetSerializedSize();
 }
 
 uint32_t TableMetadata::GetSerializedSize() const {
-  return static_cast<uint32_t>( sizeof(uint32_t)*4 + \
+  return static_cast<uint32_t>( sizeof(uint32_t)*7 + \
   table_name_.length() + sizeof(int) +\
   schema_->GetSerializedSize() );
 }
@@ -61,11 +70,18 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
   buf += Schema::DeserializeFrom(buf, schema, heap);
   prim_idx = MACH_READ_FROM(uint32_t, buf);
   buf += sizeof(uint32_t);
+  TableLayout layout = static_cast<TableLayout>(MACH_READ_FROM(uint32_t, buf));
+  buf += sizeof(uint32_t);
+  page_id_t dictionary_page_id = MACH_READ_FROM(int32_t, buf);
+  buf += sizeof(int32_t);
+  page_id_t statistics_page_id = MACH_READ_FROM(int32_t, buf);
+  buf += sizeof(int32_t);
 
-  table_meta = ALLOC_P(heap,TableMetadata)(table_id, table_name, root_page_id, schema, prim_idx);
+  table_meta = ALLOC_P(heap,TableMetadata)(table_id, table_name, root_page_id, schema, prim_idx, layout,
+                                           dictionary_page_id);
+  table_meta->statistics_page_id_ = statistics_page_id;
 
-  return static_cast<uint32_t>( sizeof(uint32_t)*4 + \
-  sizeof(std::string) +  schema->GetSerializedSize() );
+  return table_meta->GetSerializedSize();
 }
 
 
@@ -75,12 +91,15 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta, M
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name,
-                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap, uint32_t prim_idx) {
+                                     page_id_t root_page_id, TableSchema *schema, MemHeap *heap, uint32_t prim_idx,
+                                     TableLayout layout, page_id_t dictionary_page_id) {
   // allocate space for table metadata
   Schema * copy_schema = Schema::DeepCopySchema(schema, heap); 
   void *buf = heap->Allocate(sizeof(TableMetadata));
-  return new(buf)TableMetadata(table_id, table_name, root_page_id, copy_schema, prim_idx);
+  return new(buf)TableMetadata(table_id, table_name, root_page_id, copy_schema, prim_idx, layout, dictionary_page_id);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema, uint32_t prim_idx)
-        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema), prim_idx_(prim_idx) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                             uint32_t prim_idx, TableLayout layout, page_id_t dictionary_page_id)
+        : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema), prim_idx_(prim_idx),
+          layout_(layout), dictionary_page_id_(dictionary_page_id) {}
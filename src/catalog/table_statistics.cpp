@@ -0,0 +1,237 @@
+#include "catalog/table_statistics.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include "record/field_kernels.h"
+#include "utils/hyper_log_log.h"
+
+namespace {
+
+/**
+ * Copy of a value owning its data, char values are cut to max_length bytes.
+ */
+Field CopyValue(const Field &value, uint32_t max_length) {
+  switch (value.GetType()) {
+    case TypeId::kTypeInt:
+      return Field(TypeId::kTypeInt, value.GetIntVal());
+    case TypeId::kTypeFloat:
+      return Field(TypeId::kTypeFloat, value.GetFloatVal());
+    default:
+      return Field(TypeId::kTypeChar, const_cast<char *>(value.GetData()), std::min(value.GetLength(), max_length),
+                   true);
+  }
+}
+
+bool LessThan(const Field &left, const Field &right) { return left.CompareLessThan(right) == CmpBool::kTrue; }
+
+/**
+ * @return position of value between lo and hi in [0, 1], assuming values are uniform in between
+ */
+double Interpolate(const Field &lo, const Field &hi, const Field &value) {
+  double l, h, v;
+  if (value.GetType() == TypeId::kTypeInt) {
+    l = lo.GetIntVal(), h = hi.GetIntVal(), v = value.GetIntVal();
+  } else if (value.GetType() == TypeId::kTypeFloat) {
+    l = lo.GetFloatVal(), h = hi.GetFloatVal(), v = value.GetFloatVal();
+  } else {
+    return 0.5;
+  }
+  if (h <= l) {
+    return 0.5;
+  }
+  return std::min(1.0, std::max(0.0, (v - l) / (h - l)));
+}
+
+}  // namespace
+
+TableStatistics *TableStatistics::Collect(TableHeap *table_heap, const Schema *schema, MemHeap *heap,
+                                          const TableSample *sample) {
+  struct ColumnCollector {
+    FieldCompareFunc compare_;
+    FieldHashFunc hash_;
+    HyperLogLog distinct_;
+    std::unique_ptr<Field> min_, max_;
+    uint32_t non_null_count_{0};
+    std::vector<Field> sample_;
+  };
+  auto statistics = ALLOC_P(heap, TableStatistics)();
+  uint32_t column_count = schema->GetColumnCount();
+  statistics->columns_.resize(column_count);
+  std::vector<ColumnCollector> collectors(column_count);
+  for (uint32_t i = 0; i < column_count; i++) {
+    collectors[i].compare_ = GetCompareKernel(schema->GetColumn(i)->GetType());
+    collectors[i].hash_ = GetHashKernel(schema->GetColumn(i)->GetType());
+  }
+  // fixed seed, analyzing the same data twice gives the same histograms
+  std::mt19937 random;
+  auto it = sample == nullptr ? table_heap->Begin(nullptr) : table_heap->Begin(nullptr, *sample);
+  for (auto end = table_heap->End(); it != end; ++it) {
+    statistics->row_count_++;
+    for (uint32_t i = 0; i < column_count; i++) {
+      const Field &value = *it->GetField(i);
+      ColumnCollector &collector = collectors[i];
+      if (value.IsNull()) {
+        statistics->columns_[i].null_count_++;
+        continue;
+      }
+      collector.distinct_.Add(collector.hash_(value));
+      if (collector.min_ == nullptr || collector.compare_(value, *collector.min_) < 0) {
+        collector.min_.reset(new Field(CopyValue(value, VARCHAR_MAX_LEN)));
+      }
+      if (collector.max_ == nullptr || collector.compare_(*collector.max_, value) < 0) {
+        collector.max_.reset(new Field(CopyValue(value, VARCHAR_MAX_LEN)));
+      }
+      // reservoir sampling, every value seen so far is in the sample with the same probability
+      collector.non_null_count_++;
+      if (collector.sample_.size() < SAMPLE_SIZE) {
+        collector.sample_.push_back(CopyValue(value, MAX_BOUND_LENGTH));
+      } else {
+        uint32_t slot = random() % collector.non_null_count_;
+        if (slot < SAMPLE_SIZE) {
+          collector.sample_[slot] = CopyValue(value, MAX_BOUND_LENGTH);
+        }
+      }
+    }
+  }
+  double scale = sample == nullptr || sample->percent_ <= 0 ? 1 : 100 / sample->percent_;
+  statistics->row_count_ = static_cast<uint32_t>(std::llround(statistics->row_count_ * scale));
+  for (uint32_t i = 0; i < column_count; i++) {
+    ColumnCollector &collector = collectors[i];
+    ColumnStatistics &column = statistics->columns_[i];
+    column.null_count_ = static_cast<uint32_t>(std::llround(column.null_count_ * scale));
+    if (collector.non_null_count_ == 0) {
+      continue;
+    }
+    uint64_t distinct_count = std::min<uint64_t>(collector.distinct_.Estimate(), collector.non_null_count_);
+    if (distinct_count >= collector.non_null_count_ * 0.9) {
+      distinct_count = std::llround(distinct_count * scale);
+    }
+    column.distinct_count_ = static_cast<uint32_t>(std::max<uint64_t>(1, distinct_count));
+    std::vector<Field> &sorted = collector.sample_;
+    auto compare = collector.compare_;
+    std::sort(sorted.begin(), sorted.end(), [compare](const Field &a, const Field &b) { return compare(a, b) < 0; });
+    uint32_t buckets = std::min<uint32_t>(HISTOGRAM_BUCKETS, static_cast<uint32_t>(sorted.size()));
+    column.bounds_.reserve(buckets + 1);
+    column.bounds_.push_back(CopyValue(*collector.min_, MAX_BOUND_LENGTH));
+    for (uint32_t b = 1; b < buckets; b++) {
+      column.bounds_.push_back(CopyValue(sorted[b * sorted.size() / buckets], MAX_BOUND_LENGTH));
+    }
+    column.bounds_.push_back(CopyValue(*collector.max_, MAX_BOUND_LENGTH));
+  }
+  return statistics;
+}
+
+uint32_t TableStatistics::SerializeTo(char *buf) const {
+  char *begin = buf;
+  MACH_WRITE_UINT32(buf, TABLE_STATISTICS_MAGIC_NUM);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf, row_count_);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf, GetColumnCount());
+  buf += sizeof(uint32_t);
+  for (auto &column : columns_) {
+    MACH_WRITE_UINT32(buf, column.null_count_);
+    buf += sizeof(uint32_t);
+    MACH_WRITE_UINT32(buf, column.distinct_count_);
+    buf += sizeof(uint32_t);
+    MACH_WRITE_UINT32(buf, static_cast<uint32_t>(column.bounds_.size()));
+    buf += sizeof(uint32_t);
+    if (!column.bounds_.empty()) {
+      MACH_WRITE_UINT32(buf, static_cast<uint32_t>(column.bounds_[0].GetType()));
+      buf += sizeof(uint32_t);
+    }
+    for (auto &bound : column.bounds_) {
+      buf += bound.SerializeTo(buf);
+    }
+  }
+  return static_cast<uint32_t>(buf - begin);
+}
+
+uint32_t TableStatistics::GetSerializedSize() const {
+  uint32_t size = 3 * sizeof(uint32_t);
+  for (auto &column : columns_) {
+    size += 3 * sizeof(uint32_t);
+    if (!column.bounds_.empty()) {
+      size += sizeof(uint32_t);
+    }
+    for (auto &bound : column.bounds_) {
+      size += bound.GetSerializedSize();
+    }
+  }
+  return size;
+}
+
+uint32_t TableStatistics::DeserializeFrom(char *buf, TableStatistics *&statistics, MemHeap *heap) {
+  char *begin = buf;
+  ASSERT(MACH_READ_UINT32(buf) == TABLE_STATISTICS_MAGIC_NUM, "Wrong for MAGIC_NUM.");
+  buf += sizeof(uint32_t);
+  statistics = ALLOC_P(heap, TableStatistics)();
+  statistics->row_count_ = MACH_READ_UINT32(buf);
+  buf += sizeof(uint32_t);
+  uint32_t column_count = MACH_READ_UINT32(buf);
+  buf += sizeof(uint32_t);
+  statistics->columns_.resize(column_count);
+  for (auto &column : statistics->columns_) {
+    column.null_count_ = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    column.distinct_count_ = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    uint32_t bound_count = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    if (bound_count == 0) {
+      continue;
+    }
+    auto type = static_cast<TypeId>(MACH_READ_UINT32(buf));
+    buf += sizeof(uint32_t);
+    column.bounds_.reserve(bound_count);
+    for (uint32_t i = 0; i < bound_count; i++) {
+      if (type == TypeId::kTypeInt) {
+        column.bounds_.emplace_back(TypeId::kTypeInt, MACH_READ_INT32(buf));
+        buf += sizeof(int32_t);
+      } else if (type == TypeId::kTypeFloat) {
+        column.bounds_.emplace_back(TypeId::kTypeFloat, MACH_READ_FROM(float, buf));
+        buf += sizeof(float);
+      } else {
+        uint32_t len = MACH_READ_UINT32(buf);
+        buf += sizeof(uint32_t);
+        column.bounds_.emplace_back(TypeId::kTypeChar, buf, len, true);
+        buf += len;
+      }
+    }
+  }
+  return static_cast<uint32_t>(buf - begin);
+}
+
+double TableStatistics::GetNullFraction(uint32_t column_index) const {
+  if (row_count_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(columns_[column_index].null_count_) / row_count_;
+}
+
+double TableStatistics::EstimateEqualsSelectivity(uint32_t column_index) const {
+  const ColumnStatistics &column = columns_[column_index];
+  if (column.distinct_count_ == 0) {
+    return 0;
+  }
+  return (1 - GetNullFraction(column_index)) / column.distinct_count_;
+}
+
+double TableStatistics::EstimateLessThanSelectivity(uint32_t column_index, const Field &value) const {
+  const std::vector<Field> &bounds = columns_[column_index].bounds_;
+  if (bounds.empty() || value.IsNull() || !LessThan(bounds.front(), value)) {
+    return 0;
+  }
+  double non_null_fraction = 1 - GetNullFraction(column_index);
+  if (LessThan(bounds.back(), value)) {
+    return non_null_fraction;
+  }
+  // the first bound not less than the value closes the bucket holding it
+  uint32_t upper = 1;
+  while (LessThan(bounds[upper], value)) {
+    upper++;
+  }
+  double buckets = Interpolate(bounds[upper - 1], bounds[upper], value) + (upper - 1);
+  return non_null_fraction * buckets / (bounds.size() - 1);
+}
@@ -9,6 +9,13 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
   if (ast == nullptr) {
     return DB_FAILED;
   }
+  //一条语句执行期间的临时对象都分配在statement_heap_中，执行完后一次性释放
+  dberr_t ret = ExecuteStatement(ast, context);
+  statement_heap_.Reset();
+  return ret;
+}
+
+dberr_t ExecuteEngine::ExecuteStatement(pSyntaxNode ast, ExecuteContext *context) {
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context);
@@ -38,6 +45,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteDelete(ast, context);
     case kNodeUpdate:
       return ExecuteUpdate(ast, context);
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context);
     case kNodeExecFile:
       return ExecuteExecfile(ast, context);
     case kNodeQuit:
@@ -97,15 +106,40 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   return DB_SUCCESS;
 }
 
+//记录行中unique列的值用于检查重复：int列记在primmap中，char列记在uniquemap中，null不记录
+void addUniqueValues(TableInfo *table, const Row &row)
+{
+  Schema *schema = table->GetSchema();
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++)
+  {
+    Field *field = row.GetField(i);
+    if (!schema->GetColumn(i)->IsUnique() || field->IsNull()) continue;
+    if (field->GetType() == kTypeInt) table->primmap.emplace(field->GetIntVal(), table->prim_idx++);
+    else if (field->GetType() == kTypeChar) table->uniquemap.emplace(string(field->GetData(), field->GetLength()), table->unique_idx++);
+  }
+}
+
+//删除行中unique列的值的记录
+void eraseUniqueValues(TableInfo *table, const Row &row)
+{
+  Schema *schema = table->GetSchema();
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++)
+  {
+    Field *field = row.GetField(i);
+    if (!schema->GetColumn(i)->IsUnique() || field->IsNull()) continue;
+    if (field->GetType() == kTypeInt) table->primmap.erase(field->GetIntVal());
+    else if (field->GetType() == kTypeChar) table->uniquemap.erase(string(field->GetData(), field->GetLength()));
+  }
+}
+
 void RecoverMultiCheck(DBStorageEngine *dbs)
 {
   TableInfo * ti;
   dbs->catalog_mgr_->GetTable("account", ti);
   TableHeap *th = ti->GetTableHeap();
-  for (auto iter = th->Begin(nullptr); iter != th->End(); ++iter)
+  for (auto iter = th->Begin(nullptr), end = th->End(); iter != end; ++iter)
   {
-    ti->primmap.emplace((*iter).GetField(0)->GetIntVal(), ti->primmap.size());
-    ti->uniquemap.emplace(string((*iter).GetField(1)->GetCharVal(), (*iter).GetField(1)->GetLength()), ti->uniquemap.size());
+    addUniqueValues(ti, *iter);
   }
 }
 
@@ -288,10 +322,41 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
     {
       new_column = new Column(col_name, col_typeid, col_len, index, nullable, unique);
     }
+    //获取列的编码方式，目前只支持对char列做字典编码
+    pSyntaxNode encoding_node = col_node->child_->next_->next_;
+    if (encoding_node != nullptr && encoding_node->type_ == kNodeColumnEncoding)
+    {
+      std::string encoding_name = encoding_node->child_->val_;
+      if (encoding_name != "dictionary")
+      {
+        cout << "不支持的列编码: " << encoding_name << endl;
+        return DB_FAILED;
+      }
+      if (col_typeid != kTypeChar || col_len > TableDictionary::MAX_VALUE_LENGTH)
+      {
+        cout << "只能对长度不超过" << TableDictionary::MAX_VALUE_LENGTH << "的char列做字典编码: " << col_name << endl;
+        return DB_FAILED;
+      }
+      new_column->SetDictEncoded(true);
+    }
     columns.push_back(new_column);
   }
   if (col_node->type_ != kNodeColumnList) return DB_FAILED;//检察语义
 
+  //获取表的页面布局，默认为按行存储
+  TableLayout layout = TableLayout::kRowLayout;
+  pSyntaxNode layout_node = ast->child_->next_->next_;
+  if (layout_node != nullptr && layout_node->type_ == kNodeTableLayout)
+  {
+    std::string layout_name = layout_node->child_->val_;
+    if (layout_name == "pax") layout = TableLayout::kPaxLayout;
+    else if (layout_name != "row")
+    {
+      cout << "不支持的表布局: " << layout_name << endl;
+      return DB_FAILED;
+    }
+  }
+
   //用column的vector数组创建schema
   Schema *new_Schema = new Schema(columns);
 
@@ -299,7 +364,7 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
   TableInfo *new_tableinfo;
 
   //调用CatalogManager的CreateTable函数为数据库创建新的表
-  dberr_t createtable_ret = now_dbs->catalog_mgr_->CreateTable(new_table_name, new_Schema, nullptr, new_tableinfo, prim_idx);
+  dberr_t createtable_ret = now_dbs->catalog_mgr_->CreateTable(new_table_name, new_Schema, nullptr, new_tableinfo, prim_idx, layout);
   
   //  在创建表的时候就创建了
   // 为表的主键自动创建索引：
@@ -340,10 +405,18 @@ void printIndexInfo(IndexInfo * index, const std::string table_name)
   std::cout << "Table_name: " << table_name << std::endl;
   std::cout << "Attributes: ";
   IndexSchema * indexschema = index->GetIndexKeySchema();
-  for (uint32_t i = 0; i < indexschema->GetColumnCount(); i++)
+  for (uint32_t i = 0; i < index->GetKeyColumnCount(); i++)
   {
     std::cout << indexschema->GetColumn(i)->GetName() << " ";
   }std::cout << std::endl;
+  if (index->GetKeyColumnCount() < indexschema->GetColumnCount())//覆盖索引的包含列
+  {
+    std::cout << "Include: ";
+    for (uint32_t i = index->GetKeyColumnCount(); i < indexschema->GetColumnCount(); i++)
+    {
+      std::cout << indexschema->GetColumn(i)->GetName() << " ";
+    }std::cout << std::endl;
+  }
   std::cout << "..........................................\n";
 }
 
@@ -405,8 +478,9 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   }
   Schema *schema = table->GetSchema();
 
-  //获取索引的attribute,以vector的结果
+  //获取索引的attribute,以vector的结果，含unique列的索引为唯一索引，否则键可以重复
   std::vector<std::string> index_keys;
+  bool unique = false;
   if (ast_son3->type_ != kNodeColumnList || strcmp(ast_son3->val_, "index keys")) return DB_FAILED;//检查语义
   for (pSyntaxNode key_node = ast_son3->child_; key_node != nullptr; key_node = key_node->next_)
   {
@@ -418,17 +492,44 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
       cout << "没有找到当前索引对应的列\n";
       return DB_FAILED;
     }
-    if (!schema->GetColumn(col_idx)->IsUnique())
+    unique = unique || schema->GetColumn(col_idx)->IsUnique();
+  }
+  // cout << "ExecuteCreateIndex flag1\n"; 
+
+  //获取using指定的索引类型，默认为btree
+  IndexType index_type = IndexType::kBPlusTree;
+  pSyntaxNode ast_son4 = ast_son3->next_;
+  if (ast_son4 != nullptr && ast_son4->type_ == kNodeIndexType)
+  {
+    if (ast_son4->child_ == nullptr) return DB_FAILED;//检查语义
+    if (!IndexMetadata::GetIndexTypeByName(ast_son4->child_->val_, index_type))
     {
-      cout << "创建的索引必须unique\n";
+      cout << "不支持的索引类型\n";
       return DB_FAILED;
     }
+    ast_son4 = ast_son4->next_;
+  }
+
+  //获取include指定的包含列，存放在索引的叶结点中，查询只涉及索引中的列时不必访问堆表
+  std::vector<std::string> include_columns;
+  if (ast_son4 != nullptr)
+  {
+    if (ast_son4->type_ != kNodeColumnList || strcmp(ast_son4->val_, "include") != 0)
+    {
+      cout << "不支持的子句: " << ast_son4->val_ << endl;
+      return DB_FAILED;
+    }
+    for (pSyntaxNode column_node = ast_son4->child_; column_node != nullptr; column_node = column_node->next_)
+    {
+      if (column_node->type_ != kNodeIdentifier) return DB_FAILED;//检查语义
+      include_columns.push_back(column_node->val_);
+    }
   }
-  // cout << "ExecuteCreateIndex flag1\n"; 
 
   //调用catalog的CreateIndex函数创建索引：
   IndexInfo *index_info;//创建一个IndexInfo用于引用返回
-  dberr_t createindex_ret = now_dbs->catalog_mgr_->CreateIndex(table_name, new_index_name, index_keys, nullptr, index_info);
+  dberr_t createindex_ret = now_dbs->catalog_mgr_->CreateIndex(table_name, new_index_name, index_keys, nullptr,
+                                                               index_info, index_type, unique, include_columns);
   return createindex_ret;
 }
 
@@ -465,72 +566,76 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
 }
 
 
-void printRow(const Row row, const std::vector<std::string> col_names, const bool allCol, const Schema *schema)
+//要输出的列在查询开始时按名称解析为列号，每行输出时不再比较列名
+std::vector<uint32_t> getOutputColumns(const Schema *schema, const std::vector<std::string> &col_names, const bool allCol)
 {
-  select_record++;
+  std::vector<uint32_t> out_columns;
   for (uint32_t i = 0; i < schema->GetColumnCount(); i++)
   {
-    string col_name = schema->GetColumn(i)->GetName();
+    const string &col_name = schema->GetColumn(i)->GetName();
     if ( allCol || find(col_names.begin(), col_names.end(), col_name) != col_names.end() )//当前列属于要输出的列
+      out_columns.push_back(i);
+  }
+  return out_columns;
+}
+
+void printRow(const Row &row, const std::vector<uint32_t> &out_columns)
+{
+  select_record++;
+  for (uint32_t i : out_columns)
+  {
+    if (row.GetField(i)->IsNull())
+      cout << setw(20) << setiosflags(ios::left) << "null";  
+    else
     {
-      if (row.GetField(i)->IsNull())
-        cout << setw(20) << setiosflags(ios::left) << "null";  
-      else
+      switch (row.GetField(i)->GetType())
       {
-        switch (row.GetField(i)->GetType())
-        {
-        case kTypeInt:
-          cout << setw(20) << setiosflags(ios::left) << row.GetField(i)->GetIntVal();
-          break;
-        case kTypeFloat:
-          cout << setw(20) << setiosflags(ios::left) << row.GetField(i)->GetFloatVal();
-          break;
-        case kTypeChar:
-          cout << setw(20) << setiosflags(ios::left) << string(row.GetField(i)->GetCharVal(), row.GetField(i)->GetLength());
-          break;
-        default:
-          break;
-        }
-      } 
-    }
+      case kTypeInt:
+        cout << setw(20) << setiosflags(ios::left) << row.GetField(i)->GetIntVal();
+        break;
+      case kTypeFloat:
+        cout << setw(20) << setiosflags(ios::left) << row.GetField(i)->GetFloatVal();
+        break;
+      case kTypeChar:
+        cout << setw(20) << setiosflags(ios::left) << string(row.GetField(i)->GetCharVal(), row.GetField(i)->GetLength());
+        break;
+      default:
+        break;
+      }
+    } 
   }cout << endl;
 }
 
-void printRowWithRid(const RowId &rid, TableHeap *table_heap, const std::vector<std::string> &col_names, const bool allCol, const Schema *schema)
+//列在索引中时返回它在索引键中的位置，否则返回false
+bool getIndexColumn(IndexInfo *index, uint32_t column, uint32_t &position)
 {
-  //获取row并输出:
-  Row row(rid);
-  bool gettuple_ret = table_heap->GetTuple(&row, nullptr);
-  if (!gettuple_ret)  std::cout << std::endl;
-  else
+  for (position = 0; position < index->GetIndexKeySchema()->GetColumnCount(); position++)
   {
-    printRow(row, col_names, allCol, schema);
+    if (index->GetColIndex(position) == column) return true;
   }
+  return false;
 }
 
-void printRowWithpair(const Mapping_Type &keypair, TableHeap *table_heap, const std::vector<std::string> &col_names, const bool allCol, const Schema *schema)
+//键为索引中所有列(键和包含列)的字段，rowid为行的rowid，非唯一索引按rowid删除对应的项
+Row getIndexKeyRow(IndexInfo *index, const Row &row)
 {
-  //获取rowid:
-  RowId rid = keypair.second;
-  
-  printRowWithRid(rid, table_heap, col_names, allCol, schema);
-  // //获取row并输出:
-  // Row row(rid);
-  // bool gettuple_ret = table_heap->GetTuple(&row, nullptr);
-  // if (!gettuple_ret)  std::cout << std::endl;
-  // else
-  // {
-  //   printRow(row, col_names, allCol, schema);
-  // }
+  vector<Field> index_fields;
+  for (uint32_t i = 0; i < index->GetIndexKeySchema()->GetColumnCount(); i++)
+  {
+    index_fields.push_back(*row.GetField(index->GetColIndex(i)));
+  }
+  Row key_row(index_fields);
+  key_row.SetRowId(row.GetRowId());
+  return key_row;
 }
 
-SelectCondition *getConditionByCompare(pSyntaxNode compare_node, Schema *schema)
+SelectCondition *getConditionByCompare(pSyntaxNode compare_node, Schema *schema, ArenaMemHeap *heap)
 {
   // cout << "ExecuteSelect_getSelectCondition_getConditionByCompare start\n";
   if (compare_node->type_ != kNodeCompareOperator) return nullptr;
   // cout << "ExecuteSelect_getSelectCondition_getConditionByCompare flag1\n";
   
-  SelectCondition *new_condition = new SelectCondition;
+  SelectCondition *new_condition = heap->New<SelectCondition>();
   //获取判断类型：
   string compare_type = compare_node->val_;
   // cout << "ExecuteSelect_getSelectCondition_getConditionByCompare compare_type: " << compare_type << endl;
@@ -550,7 +655,9 @@ SelectCondition *getConditionByCompare(pSyntaxNode compare_node, Schema *schema)
     cout << "No Such Column!!!\n";
     return nullptr;
   }
+  new_condition->col_idx_ = col_idx;
   new_condition->type_id_ = schema->GetColumn(col_idx)->GetType();
+  new_condition->match_ = GetMatchKernel(new_condition->type_id_, static_cast<CompareOp>(new_condition->type_));
   //获取判断值：
   pSyntaxNode value_node = compare_node->child_->next_;
   if (value_node->type_ == kNodeNumber)
@@ -577,210 +684,333 @@ SelectCondition *getConditionByCompare(pSyntaxNode compare_node, Schema *schema)
   return new_condition;
 }
 
-dberr_t getSelectCondition(vector<SelectCondition *> &select_conditions, pSyntaxNode condition_node, Schema *schema)
+dberr_t getSelectCondition(vector<SelectCondition *> &select_conditions, pSyntaxNode condition_node, Schema *schema, ArenaMemHeap *heap)
 {
   // cout << "ExecuteSelect_getSelectCondition start\n";
   if (condition_node->child_->type_ == kNodeCompareOperator)//where后只有一个条件
   {
-    select_conditions.push_back(getConditionByCompare(condition_node->child_, schema));
+    select_conditions.push_back(getConditionByCompare(condition_node->child_, schema, heap));
     // cout << "ExecuteSelect_getSelectCondition DB_SUCCESS\n";
     return DB_SUCCESS;
   }
   else if (condition_node->child_->type_ == kNodeConnector)//where后为and
   {
     // cout << "发现where后面是and\n";
-    select_conditions.push_back(getConditionByCompare(condition_node->child_->child_, schema));
-    select_conditions.push_back(getConditionByCompare(condition_node->child_->child_->next_, schema));
+    select_conditions.push_back(getConditionByCompare(condition_node->child_->child_, schema, heap));
+    select_conditions.push_back(getConditionByCompare(condition_node->child_->child_->next_, schema, heap));
     return DB_SUCCESS;
   }
   else return DB_FAILED;
 }
 
-bool checkCondition(vector<SelectCondition *> &select_conditions, const Row row, Schema *schema)
+//将进行比较的值变为field形式用于调用函数进行比较，field在栈上且不复制字符串，每行比较时不再分配内存：
+Field getConditionValue(const SelectCondition *condition)
+{
+  if (condition->type_id_ == kTypeInt) return Field(kTypeInt, condition->value_.int_);
+  if (condition->type_id_ == kTypeFloat) return Field(kTypeFloat, condition->value_.float_);
+  return Field(kTypeChar, condition->value_.chars_, strlen(condition->value_.chars_), false);
+}
+
+//条件中的列号在生成条件时已解析，每行检查时不再按列名查找
+bool checkCondition(vector<SelectCondition *> &select_conditions, const Row &row)
 {
   for (uint32_t i = 0; i < select_conditions.size(); i++)
   {
-    string col_name = select_conditions[i]->attri_name;
-    uint32_t ind;
-    dberr_t getcolindex_ret = schema->GetColumnIndex(col_name, ind);
-    if (getcolindex_ret == DB_COLUMN_NAME_NOT_EXIST) continue;//在schema未找到这个条件中的column，直接跳过这个条件
-    Field *field = row.GetField(ind);
-    Field *comfield;
-    //将进行比较的值变为field形式用于调用函数进行比较：
+    Field *field = row.GetField(select_conditions[i]->col_idx_);
     // cout << "checkCondition select_conditions[i]->type_id_==float: " << (select_conditions[i]->type_id_ == kTypeFloat) << endl;
     // cout << "checkCondition select_conditions[i]->attri_name " << (select_conditions[i]->attri_name) << endl;
-    if (select_conditions[i]->type_id_ == kTypeInt)
-    {
-      comfield = new Field(kTypeInt, select_conditions[i]->value_.int_);
-    }
-    else if (select_conditions[i]->type_id_ == kTypeFloat)
+    Field comvalue = getConditionValue(select_conditions[i]);
+    Field *comfield = &comvalue;
+    //用选择条件时已确定的比较函数比较，不再逐行经虚函数分派：
+    if (!select_conditions[i]->match_(*field, *comfield)) return false;
+  }
+  return true;
+}
+
+//扫描需要的列:输出的列和条件中的列,其余存放在溢出页中的长字符串不必读取
+std::vector<uint32_t> getScanColumns(const Schema *schema, const std::vector<uint32_t> &out_columns, const vector<SelectCondition *> &conditions)
+{
+  std::vector<uint32_t> columns;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++)
+  {
+    bool needed = find(out_columns.begin(), out_columns.end(), i) != out_columns.end();
+    for (auto condition : conditions)
     {
-      comfield = new Field(kTypeFloat, select_conditions[i]->value_.float_);
+      //已编码的条件只比较编码，该列不需要解码
+      if (condition != nullptr && condition->col_idx_ == i && !condition->encoded_) needed = true;
     }
-    else
+    if (needed) columns.push_back(i);
+  }
+  return columns;
+}
+
+//将字典编码列上的等于/不等于条件的字符串替换为编码，扫描时比较整数而不必解码该列
+void encodeConditions(TableHeap *table_heap, const Schema *schema, const std::vector<uint32_t> &out_columns, vector<SelectCondition *> &conditions)
+{
+  for (auto condition : conditions)
+  {
+    if (condition == nullptr || condition->type_ > 1) continue;//编码不保序，只能用于=和<>
+    uint32_t col_idx = condition->col_idx_;
+    if (!schema->GetColumn(col_idx)->IsDictEncoded()) continue;
+    if (find(out_columns.begin(), out_columns.end(), col_idx) != out_columns.end()) continue;//该列要输出，输出所有列时每一列都要解码
+    uint32_t code;
+    const char *value = condition->value_.chars_;
+    //字典中没有这个值时没有行能相等，用不存在的编码-1比较
+    if (table_heap->GetDictionaryCode(col_idx, value, strlen(value), &code)) condition->value_.int_ = static_cast<int>(code);
+    else condition->value_.int_ = -1;
+    condition->type_id_ = kTypeInt;
+    condition->match_ = GetMatchKernel(kTypeInt, static_cast<CompareOp>(condition->type_));
+    condition->encoded_ = true;
+  }
+}
+
+bool checkIndexSameWithCondition(IndexInfo *index, const SelectCondition *condition)
+{
+  if (index->GetKeyColumnCount() != 1) return false;//首先须为单属性索引
+  return condition->attri_name == index->GetIndexKeySchema()->GetColumn(0)->GetName();
+
+}
+
+//索引扫描范围的一端，condition_为nullptr时该端无界，null_为true时该端为null键
+struct IndexBound
+{
+  const SelectCondition *condition_ = nullptr;
+  bool inclusive_ = false;
+  bool null_ = false;
+};
+
+//返回两个下界(lower为true)或两个上界中更紧的一个，值相同时不含端点的更紧
+IndexBound tighterBound(const IndexBound &a, const IndexBound &b, bool lower)
+{
+  if (a.condition_ == nullptr) return b;
+  if (b.condition_ == nullptr) return a;
+  Field a_value = getConditionValue(a.condition_), b_value = getConditionValue(b.condition_);
+  if (a_value.CompareEquals(b_value) == CmpBool::kTrue) return a.inclusive_ ? b : a;
+  bool a_greater = a_value.CompareGreaterThan(b_value) == CmpBool::kTrue;
+  return a_greater == lower ? a : b;
+}
+
+//将一端的条件值转为索引键。与MatchField一致，null只满足<>，不满足其余比较，所以无界的下界在可为空的列上跳过null
+const Row *getBoundKey(const IndexBound &bound, IndexInfo *indexinfo, bool lower, Row &key)
+{
+  std::vector<Field> fields;
+  if (bound.condition_ != nullptr) fields.push_back(getConditionValue(bound.condition_));
+  else if (bound.null_ || (lower && indexinfo->GetIndexKeySchema()->GetColumn(0)->IsNullable())) fields.emplace_back(indexinfo->GetIndexKeySchema()->GetColumn(0)->GetType());
+  else return nullptr;
+  key = Row(fields);
+  return &key;
+}
+
+//利用哈希索引查询：按索引列上的一个=条件查找键，其余条件逐行检查
+dberr_t selectWithHashIndex(vector<SelectCondition *> &conditions, IndexInfo *indexinfo, const std::vector<uint32_t> &out_columns)
+{
+  const SelectCondition *equal = nullptr;
+  vector<SelectCondition *> residual;
+  for (auto condition : conditions)
+  {
+    if (equal == nullptr && condition->type_ == 0 && checkIndexSameWithCondition(indexinfo, condition)) equal = condition;
+    else residual.push_back(condition);
+  }
+  if (equal == nullptr) return DB_FAILED;
+  std::vector<Field> fields{getConditionValue(equal)};
+  Row key(fields);
+  std::vector<RowId> result;
+  indexinfo->GetIndex()->ScanKey(key, result, nullptr);
+  TableHeap *table_heap = indexinfo->GetTableInfo()->GetTableHeap();
+  for (auto &row_id : result)
+  {
+    Row row(row_id);
+    if (table_heap->GetTuple(&row, nullptr) && checkCondition(residual, row)) printRow(row, out_columns);
+  }
+  return DB_SUCCESS;
+}
+
+//利用单列索引查询：索引列上的=、<、>、<=、>=条件合并为一个扫描范围，两端各取最紧的界，只沿叶结点扫描范围内的项；
+//索引列上的一个<>将范围分为两段；其余条件逐行检查。索引包含条件和输出的所有列时只读叶结点，否则按rowid从堆表读取行
+dberr_t selectWithIndex(vector<SelectCondition *> &conditions, IndexInfo *indexinfo, const std::vector<uint32_t> &out_columns)
+{
+  if (!indexinfo->IsOrdered()) return selectWithHashIndex(conditions, indexinfo, out_columns);
+  IndexBound lower, upper;
+  const SelectCondition *excluded = nullptr;//范围中要跳过的值
+  vector<SelectCondition *> residual;//扫描范围之外还要检查的条件
+  for (auto condition : conditions)
+  {
+    if (!checkIndexSameWithCondition(indexinfo, condition))
     {
-      comfield = new Field(kTypeChar, select_conditions[i]->value_.chars_, strlen(select_conditions[i]->value_.chars_), true);
+      residual.push_back(condition);
+      continue;
     }
-    //根据条件类型调用不同函数进行比较：
-    // cout << "checkCondition select_conditions[i]->type_: " << select_conditions[i]->type_ << endl;
-    // cout << "checkCondition : " << select_conditions[0]->value_.float_ << endl;
-    // cout << "checkCondition comare two datas: " << field->GetData() << " " << comfield->GetData() << endl;
-    switch (select_conditions[i]->type_)
+    switch (condition->type_)
     {
     case 0://=
-      if (field->CompareEquals(*comfield) != CmpBool::kTrue) return false;
+      lower = tighterBound(lower, {condition, true}, true);
+      upper = tighterBound(upper, {condition, true}, false);
       break;
-    case 1://!=
-      if (field->CompareEquals(*comfield) == CmpBool::kTrue) return false;
+    case 1://<>
+      if (excluded == nullptr) excluded = condition;
+      else residual.push_back(condition);
       break;
     case 2://<
-      if (field->CompareLessThan(*comfield) != CmpBool::kTrue) return false;
-      break;
-    case 3://>
-      if (field->CompareGreaterThan(*comfield) != CmpBool::kTrue) return false;
-      break;
     case 4://<=
-      if (field->CompareLessThanEquals(*comfield) != CmpBool::kTrue) return false;
+      upper = tighterBound(upper, {condition, condition->type_ == 4}, false);
       break;
+    case 3://>
     case 5://>=
-      if (field->CompareGreaterThanEquals(*comfield) != CmpBool::kTrue) return false;
+      lower = tighterBound(lower, {condition, condition->type_ == 5}, true);
       break;
     default:
-      return false;
+      residual.push_back(condition);
       break;
     }
-    
-    delete comfield;
   }
-  return true;
-}
-
-bool checkIndexSameWithCondition(IndexInfo *index, const SelectCondition *condition)
-{
-  if (index->GetIndexKeySchema()->GetColumnCount() != 1) return false;//首先须为单属性索引
-  return condition->attri_name == index->GetIndexKeySchema()->GetColumn(0)->GetName();
 
-}
-
-dberr_t selectWithIndex(SelectCondition *condition, IndexInfo *indexinfo, const std::vector<std::string> col_names, const bool allCol)
-{
-  //利用condition的attribute构造一个"row",将row序列化为keytype用于索引:
-  //首先构造用于构造row的field_vector,因为只考虑单属性索引，索引这里的vector里面只有一个：
-  vector<Field> fields;
-  switch (condition->type_id_)
+  //条件和输出的列都在索引中时，条件改为检查解码出的键中对应的列
+  std::vector<uint32_t> key_columns(out_columns.size());
+  bool covering = true;
+  for (uint32_t i = 0; i < out_columns.size(); i++) covering = covering && getIndexColumn(indexinfo, out_columns[i], key_columns[i]);
+  std::vector<SelectCondition> key_conditions;
+  for (auto condition : residual)
   {
-  case kTypeInt:
-    fields.push_back(Field(kTypeInt, condition->value_.int_));
-    cout << "selectWithIndex " << condition->value_.int_ << endl;
-    break;
-  case kTypeFloat:
-    fields.push_back(Field(kTypeFloat, condition->value_.float_));
-    break;
-  case kTypeChar:
-    fields.push_back(Field(kTypeChar, condition->value_.chars_, strlen(condition->value_.chars_), true));
-    break;
-  default:
-    return DB_FAILED;
-    break;
+    key_conditions.push_back(*condition);
+    covering = covering && getIndexColumn(indexinfo, condition->col_idx_, key_conditions.back().col_idx_);
   }
+  vector<SelectCondition *> key_residual;
+  for (auto &condition : key_conditions) key_residual.push_back(&condition);
 
-  //获取schema
-  Schema *schema = indexinfo->GetIndexKeySchema();
-
-  //构建row和GenericKey,默认用64的大小,从而获取相应的迭代器:
-  Row key_row(fields);
-  
-  GenericKey<64> genekey;
-  genekey.SerializeFromKey(key_row, schema);
-  
-  auto key_iter = reinterpret_cast<BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> *>(indexinfo->GetIndex())->GetBeginIterator(genekey);
-  auto begin_iter = reinterpret_cast<BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> *>(indexinfo->GetIndex())->GetBeginIterator();
-  auto end_iter = reinterpret_cast<BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>> *>(indexinfo->GetIndex())->GetEndIterator();
-
-  //获取table_heap:
-  TableHeap *table_heap = indexinfo->GetTableInfo()->GetTableHeap();  
-
-  //根据条件不同执行结果
-  //void printRow(const Row row, const std::vector<std::string> col_names, const bool allCol, const Schema *schema)
-  //void printRowWithpair(const Mapping_Type keypair, TableHeap *table_heap, const std::vector<std::string> col_names, const bool allCol, const Schema *schema)
-  Mapping_Type keypair;
-  Schema * printschema = indexinfo->GetTableInfo()->GetSchema();
-  switch (condition->type_)
-  {
-  case 0://=
-    //获取rowid:
-    keypair = *key_iter;//Mapping_Type std::pair<KeyType, ValueType>
-    if (keypair.first == genekey)
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-    break;
-  case 1://!=
-    for (auto iter = begin_iter; ; ++iter)
+  TableHeap *table_heap = indexinfo->GetTableInfo()->GetTableHeap();
+  auto output = [&](RowId row_id, const Row *key) {
+    if (covering)
     {
-      //获取rowid:
-      keypair = *iter;//Mapping_Type std::pair<KeyType, ValueType>
-      if (iter == key_iter && keypair.first == genekey) continue;//跳过等于的row
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-      if (iter == end_iter) break;
+      if (checkCondition(key_residual, *key)) printRow(*key, key_columns);
+      return true;
     }
-    break;
-  case 2://<
-    for (auto iter = begin_iter; iter != key_iter; ++iter)
+    Row row(row_id);
+    if (table_heap->GetTuple(&row, nullptr) && checkCondition(residual, row)) printRow(row, out_columns);
+    return true;
+  };
+
+  //有<>时分为它之前和之后两段扫描，每段的界取<>的值和原来的界中更紧的一个；
+  //null与任何值都不相等，索引列上没有其他界时还要先扫描null键，与逐行检查和批量过滤的结果一致
+  std::vector<std::pair<IndexBound, IndexBound>> ranges;
+  if (excluded == nullptr) ranges.emplace_back(lower, upper);
+  else
+  {
+    if (lower.condition_ == nullptr && upper.condition_ == nullptr && indexinfo->GetIndexKeySchema()->GetColumn(0)->IsNullable())
     {
-      //获取rowid:
-      keypair = *iter;//Mapping_Type std::pair<KeyType, ValueType>
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-      if (iter == end_iter) break;
+      IndexBound null_bound{nullptr, true, true};
+      ranges.emplace_back(null_bound, null_bound);
     }
-    break;
-  case 3://>
-    for (auto iter = key_iter; ; ++iter)
+    ranges.emplace_back(lower, tighterBound(upper, {excluded, false}, false));
+    ranges.emplace_back(tighterBound(lower, {excluded, false}, true), upper);
+  }
+  Index *index = indexinfo->GetIndex();
+  for (auto &range : ranges)
+  {
+    Row lower_key, upper_key;
+    const Row *lower_row = getBoundKey(range.first, indexinfo, true, lower_key);
+    const Row *upper_row = getBoundKey(range.second, indexinfo, false, upper_key);
+    dberr_t ret = index->ScanRange(lower_row, upper_row, lower_row == nullptr || range.first.inclusive_,
+                                   upper_row == nullptr || range.second.inclusive_, output, nullptr, covering);
+    if (ret != DB_SUCCESS) return ret;
+  }
+  return DB_SUCCESS;
+}
+
+//索引列上的条件值都能编码为索引键时返回true。比列长的字符串可能超过按列宽选择的键宽，这时不能用索引查找：
+//这样的值不等于任何行，但对<、>仍有满足的行，所以改为遍历而不是当作没有结果
+bool conditionsFitIndex(IndexInfo *index, const vector<SelectCondition *> &conditions)
+{
+  for (auto condition : conditions)
+  {
+    if (checkIndexSameWithCondition(index, condition) && !index->FitsKey(getConditionValue(condition))) return false;
+  }
+  return true;
+}
+
+//选择查询使用的索引：键列上有=条件的哈希索引最优，其次是键列上有=、<、>、<=、>=条件的有序索引，只有一个条件时<>也用有序索引；没有时返回nullptr
+IndexInfo *chooseIndex(const std::vector<IndexInfo *> &indexes, const vector<SelectCondition *> &conditions)
+{
+  if (find(conditions.begin(), conditions.end(), nullptr) != conditions.end()) return nullptr;
+  IndexInfo *range_index = nullptr, *not_equal_index = nullptr;
+  for (auto index : indexes)
+  {
+    if (!conditionsFitIndex(index, conditions)) continue;
+    for (auto condition : conditions)
     {
-      //获取rowid:
-      keypair = *iter;//Mapping_Type std::pair<KeyType, ValueType>
-      if (keypair.first == genekey)
+      if (!checkIndexSameWithCondition(index, condition)) continue;
+      if (!index->IsOrdered())//哈希索引只能查找等值，只读目录页和桶页
       {
-        if (iter == end_iter) break;
+        if (condition->type_ == 0) return index;
         continue;
       }
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-      if (iter == end_iter) break;
-    }
-    break;
-  case 4://<=
-    for (auto iter = begin_iter; ; ++iter)
-    {
-      //获取rowid:
-      keypair = *iter;//Mapping_Type std::pair<KeyType, ValueType>
-      if (iter == key_iter)
-      {
-        if (keypair.first == genekey)
-        {
-          ++key_iter;
-        }
-        else
-        {
-          break;
-        }
-      }
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-      if (iter == end_iter) break;
-    }
-    break;
-  case 5://>=
-    for (auto iter = key_iter; ; ++iter)
-    {
-      //获取rowid:
-      keypair = *iter;//Mapping_Type std::pair<KeyType, ValueType>
-      printRowWithpair(keypair, table_heap, col_names, allCol, printschema);
-      if (iter == end_iter) break;
+      if (condition->type_ != 1 && range_index == nullptr) range_index = index;
+      if (condition->type_ == 1 && not_equal_index == nullptr && conditions.size() == 1) not_equal_index = index;
     }
-    break;
-  default:
+  }
+  return range_index != nullptr ? range_index : not_equal_index;
+}
+
+//解析tablesample子句：tablesample system|bernoulli(百分比) [repeatable(种子)]
+dberr_t getTableSample(pSyntaxNode sample_node, TableSample &sample)
+{
+  if (strcmp(sample_node->val_, "tablesample") != 0)
+  {
+    cout << "不支持的子句: " << sample_node->val_ << endl;
+    return DB_FAILED;
+  }
+  pSyntaxNode method_node = sample_node->child_;
+  std::string method = method_node->val_;
+  if (method == "system" || method == "block") sample.method_ = TableSample::Method::kBlock;//按页采样
+  else if (method == "bernoulli") sample.method_ = TableSample::Method::kBernoulli;//按行采样
+  else
+  {
+    cout << "不支持的采样方法: " << method << endl;
+    return DB_FAILED;
+  }
+  sample.percent_ = atof(method_node->next_->val_);
+  if (sample.percent_ < 0 || sample.percent_ > 100)
+  {
+    cout << "采样百分比须在0到100之间\n";
+    return DB_FAILED;
+  }
+  pSyntaxNode seed_node = method_node->next_->next_;
+  if (seed_node == nullptr)//未指定种子，每次采样不同
+  {
+    sample.seed_ = std::random_device()();
+  }
+  else if (strcmp(seed_node->val_, "repeatable") == 0)
+  {
+    sample.seed_ = static_cast<uint32_t>(atoll(seed_node->child_->val_));
+  }
+  else
+  {
+    cout << "不支持的子句: " << seed_node->val_ << endl;
     return DB_FAILED;
-    break;
   }
   return DB_SUCCESS;
 }
+
+//有采样时只扫描样本
+TableIterator beginScan(TableHeap *table_heap, const std::vector<uint32_t> &scan_columns, const TableSample *sample)
+{
+  if (sample == nullptr) return table_heap->Begin(nullptr, scan_columns);
+  return table_heap->Begin(nullptr, scan_columns, *sample);
+}
+
+//列式存储的表按页批量过滤：条件转为列谓词，逐页对整列做向量化比较得到选择位图，只读取满足所有条件的行
+//返回false时表不是列式存储或条件无法在存储的值上比较，调用者改为逐行遍历
+bool selectWithBatchScan(TableHeap *table_heap, const vector<SelectCondition *> &conditions, const std::vector<uint32_t> &out_columns, const std::vector<uint32_t> &scan_columns)
+{
+  if (table_heap->GetLayout() != TableLayout::kPaxLayout) return false;
+  std::vector<ColumnPredicate> predicates;
+  for (auto condition : conditions)
+  {
+    if (condition == nullptr) return false;
+    predicates.emplace_back(condition->col_idx_, static_cast<CompareOp>(condition->type_), getConditionValue(condition));
+  }
+  return table_heap->ScanBatch(nullptr, predicates, &scan_columns, [&](const Row &row) { printRow(row, out_columns); });
+}
+
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteSelect" << std::endl;
@@ -816,15 +1046,27 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   else if (ast->child_->type_ == kNodeAllColumns) allCol = true;
   else return DB_FAILED;//检查语义
 
-  //判断条件:
+  //获取采样方式:
   pSyntaxNode condition_node = table_node->next_;
+  TableSample table_sample;
+  const TableSample *sample = nullptr;
+  if (condition_node != nullptr && condition_node->type_ == kNodeTableSample)
+  {
+    if (getTableSample(condition_node, table_sample) != DB_SUCCESS) return DB_FAILED;
+    sample = &table_sample;
+    condition_node = condition_node->next_;
+  }
+
+  //判断条件:
   Schema *schema = table->GetSchema();//获取模式
   TableHeap *table_heap = table->GetTableHeap();//获取堆表
+  std::vector<uint32_t> out_columns = getOutputColumns(schema, col_names, allCol);
   if (condition_node == nullptr)//无条件，输出所有列
   {
-    for (auto row_iter = table_heap->Begin(nullptr); row_iter != table_heap->End(); ++row_iter)
+    std::vector<uint32_t> scan_columns = getScanColumns(schema, out_columns, {});
+    for (auto row_iter = beginScan(table_heap, scan_columns, sample), end = table_heap->End(); row_iter != end; ++row_iter)
     {
-      printRow(*row_iter, col_names, allCol, schema);
+      printRow(*row_iter, out_columns);
     }cout << "................................................................................\n";
   }
   else if (condition_node->type_ == kNodeConditions)//存在where
@@ -832,21 +1074,12 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
     // cout << "ExecuteSelect condition_node->type_ == kNodeConditions\n";
     vector<SelectCondition *> select_conditions;
     // cout << "!!!!!!!!!!!!!!!!!!!!!" << endl;
-    getSelectCondition(select_conditions, condition_node, schema);
+    getSelectCondition(select_conditions, condition_node, schema, &statement_heap_);
     // cout << "......................" << endl;
     // cout << "ExecuteSelect size select_conditions[0]->type is float: " << select_conditions.size() << " " << (select_conditions[0]->type_id_ == kTypeFloat) << endl;
-    if (select_conditions.size() == 2)//多条件查询，直接遍历
+    //检查是否有索引和where中条件相吻合，采样查询不走索引：
+    if (sample == nullptr)
     {
-      for (auto row_iter = table_heap->Begin(nullptr); row_iter != table_heap->End(); ++row_iter)
-      {
-        // cout << "multiselect\n";
-        if (checkCondition(select_conditions, *row_iter, schema))
-          printRow(*row_iter, col_names, allCol, schema);
-      }cout << "................................................................................\n";
-    }
-    else if (select_conditions.size() == 1)//单条件查询，尝试利用index
-    {
-      //获取表的索引：
       std::vector<IndexInfo *> indexes;//vector for indexes in this table;
       dberr_t getindexes_ret = now_dbs->catalog_mgr_->GetTableIndexes(table_name, indexes);
       if (getindexes_ret != DB_SUCCESS)
@@ -854,36 +1087,51 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
         cout << "ExecuteSelect getindexes_ret != DB_SUCCESS\n";
         return DB_FAILED;
       }
-      //遍历索引，检查是否有索引和where中条件相吻合：
-      for (uint32_t i = 0; i < indexes.size(); i++)
+      IndexInfo *index = chooseIndex(indexes, select_conditions);
+      if (index != nullptr)
       {
-        if (checkIndexSameWithCondition(indexes[i], select_conditions[0]))//索引和where中条件相吻合
-        {
-          cout << "可利用索引: " << indexes[i]->GetIndexName() << "进行优化查询\n";
-          dberr_t select_ret = selectWithIndex(select_conditions[0], indexes[i], col_names, allCol);
-          cout << "一共查到 " << select_record << "条记录!\n";
-          return select_ret;
-        }
+        cout << "可利用索引: " << index->GetIndexName() << "进行优化查询\n";
+        dberr_t select_ret = selectWithIndex(select_conditions, index, out_columns);
+        cout << "一共查到 " << select_record << "条记录!\n";
+        return select_ret;
       }
-      //没有索引,直接遍历
-      int i = 1;
-      for (auto row_iter = table_heap->Begin(nullptr); row_iter != table_heap->End(); ++row_iter, i++)
+    }
+    if (select_conditions.size() == 2)//多条件查询，直接遍历
+    {
+      encodeConditions(table_heap, schema, out_columns, select_conditions);
+      std::vector<uint32_t> scan_columns = getScanColumns(schema, out_columns, select_conditions);
+      if (sample != nullptr || !selectWithBatchScan(table_heap, select_conditions, out_columns, scan_columns))//不能批量过滤时逐行遍历
       {
-        if (checkCondition(select_conditions, *row_iter, schema))
+        for (auto row_iter = beginScan(table_heap, scan_columns, sample), end = table_heap->End(); row_iter != end; ++row_iter)
         {
-          // cout << "get a record\n";
-          printRow(*row_iter, col_names, allCol, schema);
+          // cout << "multiselect\n";
+          if (checkCondition(select_conditions, *row_iter))
+            printRow(*row_iter, out_columns);
         }
-        // cout << i << endl;
       }cout << "................................................................................\n";
     }
-    for (uint32_t i = 0; i < select_conditions.size(); i++)
+    else if (select_conditions.size() == 1)//单条件查询，没有索引,直接遍历
     {
-      delete select_conditions[i];
+      encodeConditions(table_heap, schema, out_columns, select_conditions);
+      std::vector<uint32_t> scan_columns = getScanColumns(schema, out_columns, select_conditions);
+      if (sample != nullptr || !selectWithBatchScan(table_heap, select_conditions, out_columns, scan_columns))//不能批量过滤时逐行遍历
+      {
+        int i = 1;
+        for (auto row_iter = beginScan(table_heap, scan_columns, sample), end = table_heap->End(); row_iter != end; ++row_iter, i++)
+        {
+          if (checkCondition(select_conditions, *row_iter))
+          {
+            // cout << "get a record\n";
+            printRow(*row_iter, out_columns);
+          }
+          // cout << i << endl;
+        }
+      }cout << "................................................................................\n";
     }
   }
   else return DB_FAILED;//检查语义
   cout << "一共查到 " << select_record << "条记录!\n";
+  if (sample != nullptr) cout << "(" << sample->percent_ << "%采样，结果为近似值)\n";
   return DB_SUCCESS;
 }
 
@@ -912,20 +1160,41 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
   if (getTable_ret == DB_TABLE_NOT_EXIST) return DB_TABLE_NOT_EXIST;
   TableHeap *table_heap = ins_table->GetTableHeap();//获取堆表
   Schema *schema = ins_table->GetSchema();
+  //字符串不能超过列的长度，在检查约束之前检查，失败时不修改主键和unique的记录
   uint32_t idx = 0;
+  for (pSyntaxNode val_node = table_node->next_->child_; val_node != nullptr && idx < schema->GetColumnCount(); val_node = val_node->next_, idx++)
+  {
+    if (val_node->type_ == kNodeString && schema->GetColumn(idx)->GetType() == kTypeChar && strlen(val_node->val_) > schema->GetColumn(idx)->GetLength())
+    {
+      cout << "字符串长度超过列" << schema->GetColumn(idx)->GetName() << "的长度\n";
+      return DB_FAILED;
+    }
+  }
+  idx = 0;
   for (pSyntaxNode val_node = table_node->next_->child_; val_node != nullptr; val_node = val_node->next_)
   {
+    if (val_node->type_ == kNodeNull)//null值只能插入可为空的列；unique列不能为null，唯一索引中没有null键
+    {
+      if (!schema->GetColumn(idx)->IsNullable() || schema->GetColumn(idx)->IsUnique())
+      {
+        cout << "该列不能为空\n";
+        return DB_FAILED;
+      }
+      fields.emplace_back(schema->GetColumn(idx)->GetType());
+      idx++;
+      continue;
+    }
     Field *newfield;
     switch (schema->GetColumn(idx)->GetType())
     {
     case kTypeInt:
-      if (ins_table->primmap.find(atoi(val_node->val_)) != ins_table->primmap.end())
+      //只有unique的列需要检查重复，其余列的值可以重复
+      if (schema->GetColumn(idx)->IsUnique() && ins_table->primmap.find(atoi(val_node->val_)) != ins_table->primmap.end())
       {
         cout << "PRIMARY KEY约束冲突\n";
         return DB_FAILED;
       }
       newfield = new Field(kTypeInt, atoi(val_node->val_));
-      ins_table->primmap.emplace(atoi(val_node->val_), ins_table->prim_idx++);
       fields.push_back(*newfield);
       break;
     case kTypeFloat:
@@ -933,13 +1202,12 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
       fields.push_back(*newfield);
       break;
     case kTypeChar:
-      if (ins_table->uniquemap.find(string(val_node->val_)) != ins_table->uniquemap.end())
+      if (schema->GetColumn(idx)->IsUnique() && ins_table->uniquemap.find(string(val_node->val_)) != ins_table->uniquemap.end())
       {
         cout << "UNIQUE约束冲突\n";
         return DB_FAILED;
       }
       newfield = new Field(kTypeChar, val_node->val_, strlen(val_node->val_), true);
-      ins_table->uniquemap.emplace(string(val_node->val_), ins_table->unique_idx++);
       fields.push_back(*newfield);
       break;
     default:
@@ -964,15 +1232,22 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
   for (uint32_t i = 0; i < indexes.size(); i++)
   {
     auto index = indexes[i]->GetIndex();
-    vector<Field> index_fields;
-    index_fields.push_back(fields[indexes[i]->GetColIndex(0)]);
-    Row key_row(index_fields);
-    if (index->InsertEntry(key_row, ins_row->GetRowId(), nullptr) != DB_SUCCESS) return DB_FAILED;
-    else
+    Row key_row = getIndexKeyRow(indexes[i], *ins_row);
+    if (index->InsertEntry(key_row, ins_row->GetRowId(), nullptr) != DB_SUCCESS)
     {
-      // cout << "记录插入索引： " << index->index_id_ << endl;
+      //撤销插入：删除已插入的索引项和堆表中的行，表和各索引保持一致
+      cout << "插入索引" << indexes[i]->GetIndexName() << "失败\n";
+      for (uint32_t j = 0; j < i; j++)
+      {
+        indexes[j]->GetIndex()->RemoveEntry(getIndexKeyRow(indexes[j], *ins_row), nullptr);
+      }
+      table_heap->ApplyDelete(ins_row->GetRowId(), nullptr);
+      delete ins_row;
+      return DB_FAILED;
     }
   }
+  //插入成功后才记录unique列的值
+  addUniqueValues(ins_table, *ins_row);
   delete ins_row;
   return DB_SUCCESS;
 }
@@ -1033,7 +1308,7 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
   if (condition_node == nullptr) allDelete = true;
   else if (condition_node->type_ == kNodeConditions)
   {
-    getSelectCondition(del_conditions, condition_node, schema);
+    getSelectCondition(del_conditions, condition_node, schema, &statement_heap_);
     
   }
   else return DB_FAILED;
@@ -1055,21 +1330,18 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
   vector<IndexInfo *> indexes;
   dberr_t getindexes_ret = now_dbs->catalog_mgr_->GetTableIndexes(table_name, indexes);
   if (getindexes_ret != DB_SUCCESS) return DB_FAILED;
-  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter)//遍历堆表
+  for (auto iter = table_heap->Begin(nullptr), end = table_heap->End(); iter != end; ++iter)//遍历堆表
   {
     // if (allDelete || checkDeleteRow(*iter, condition_name, del_val, schema))//若全部删除或row满足删除条件，则删除
-    if (allDelete || checkCondition(del_conditions, *iter, schema))//若全部删除或row满足删除条件，则删除
+    if (allDelete || checkCondition(del_conditions, *iter))//若全部删除或row满足删除条件，则删除
     {
-      del_table->primmap.erase((*iter).GetField(0)->GetIntVal());
-      del_table->uniquemap.erase(string((*iter).GetField(1)->GetCharVal(), (*iter).GetField(1)->GetLength()));
+      eraseUniqueValues(del_table, *iter);
       //调用堆表删除
       table_heap->ApplyDelete((*iter).GetRowId(), nullptr);
       //遍历索引删除
       for (uint32_t i = 0; i < indexes.size(); i++)
       {
-        vector<Field> index_fields;
-        index_fields.push_back(*((*iter).GetField(indexes[i]->GetColIndex(0))));
-        Row key_row(index_fields);
+        Row key_row = getIndexKeyRow(indexes[i], *iter);
         indexes[i]->GetIndex()->RemoveEntry(key_row, nullptr);
       }
     }
@@ -1078,7 +1350,7 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
 }
 
 
-size_t GetUpdateItem(vector<UpdateItem> &items, pSyntaxNode udnode)
+size_t GetUpdateItem(vector<UpdateItem> &items, pSyntaxNode udnode, const Schema *schema)
 {
   size_t itemnum = 0;
   for (pSyntaxNode node = udnode->child_; node != nullptr; node = node->next_)
@@ -1093,6 +1365,8 @@ size_t GetUpdateItem(vector<UpdateItem> &items, pSyntaxNode udnode)
 
     UpdateItem newitem;
     newitem.name = node->child_->val_;
+    //更新的列在此解析为列号，不存在的列用列数表示，不会被更新
+    if (schema->GetColumnIndex(newitem.name, newitem.col_idx_) != DB_SUCCESS) newitem.col_idx_ = schema->GetColumnCount();
     char *udval = node->child_->next_->val_;
     switch (node->child_->next_->type_)
     {
@@ -1125,11 +1399,10 @@ Row *GetNewRow(const Row &oldrow, vector<UpdateItem> &updateitems, Schema * sche
   vector<Field> newFields;
   for (uint32_t i = 0; i < oldrow.GetFieldCount(); i++)
   {
-    string name = schema->GetColumn(i)->GetName();
     bool update_flag = false;
     for (uint32_t j = 0; j < updateitems.size(); j++)
     {
-      if (updateitems[j].name == name)// 当前field为要更新的field
+      if (updateitems[j].col_idx_ == i)// 当前field为要更新的field
       {
         update_flag = true;
         switch (schema->GetColumn(i)->GetType())
@@ -1163,6 +1436,19 @@ Row *GetNewRow(const Row &oldrow, vector<UpdateItem> &updateitems, Schema * sche
   return newrow;
 }
 
+//更新前后索引键和包含列是否改变,未改变的索引无需维护(堆表更新后RowId不变)
+bool indexKeyChanged(IndexInfo *index, const Row &old_row, const Row &new_row)
+{
+  for (uint32_t i = 0; i < index->GetIndexKeySchema()->GetColumnCount(); i++)
+  {
+    Field *old_field = old_row.GetField(index->GetColIndex(i));
+    Field *new_field = new_row.GetField(index->GetColIndex(i));
+    if (old_field->IsNull() != new_field->IsNull()) return true;
+    if (!old_field->IsNull() && old_field->CompareEquals(*new_field) != CmpBool::kTrue) return true;
+  }
+  return false;
+}
+
 dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteUpdate" << std::endl;
@@ -1185,11 +1471,19 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   Schema *schema = ud_table->GetSchema();
 
   vector<UpdateItem> updateitems;
-  if (GetUpdateItem(updateitems, table_node->next_) != updateitems.size())
+  if (GetUpdateItem(updateitems, table_node->next_, schema) != updateitems.size())
   {
     cout << "更新记录语法树出错！\n";
     return DB_FAILED;
   }
+  for (auto &item : updateitems)//与插入一样，字符串不能超过列的长度
+  {
+    if (item.type_ == kTypeChar && item.col_idx_ < schema->GetColumnCount() && strlen(item.value_.chars_) > schema->GetColumn(item.col_idx_)->GetLength())
+    {
+      cout << "字符串长度超过列" << item.name << "的长度\n";
+      return DB_FAILED;
+    }
+  }
 
   //获取更新条件：
   bool allUpdate = false;
@@ -1198,7 +1492,7 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   if (condition_node == nullptr) allUpdate = true;
   else if (condition_node->type_ == kNodeConditions)
   {
-    getSelectCondition(ud_conditions, condition_node, schema);
+    getSelectCondition(ud_conditions, condition_node, schema, &statement_heap_);
     
   }
   else return DB_FAILED;
@@ -1221,28 +1515,26 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   vector<IndexInfo *> indexes;
   dberr_t getindexes_ret = now_dbs->catalog_mgr_->GetTableIndexes(table_name, indexes);//获取索引
   if (getindexes_ret != DB_SUCCESS) return DB_FAILED;
-  for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter)//遍历堆表
+  for (auto iter = table_heap->Begin(nullptr), end = table_heap->End(); iter != end; ++iter)//遍历堆表
   {
-    if (allUpdate || checkCondition(ud_conditions, *iter, schema))//若全部更新或row满足更新条件，则更新（此处判断条件的函数和上面公用）
+    if (allUpdate || checkCondition(ud_conditions, *iter))//若全部更新或row满足更新条件，则更新（此处判断条件的函数和上面公用）
     {
-      ud_table->primmap.erase((*iter).GetField(0)->GetIntVal());
-      ud_table->uniquemap.erase(string((*iter).GetField(1)->GetCharVal(), (*iter).GetField(1)->GetLength()));
       // cout << "满足更新条件\n";
       auto newrow = GetNewRow(*iter, updateitems, schema);
-      ud_table->primmap.emplace(newrow->GetField(0)->GetIntVal(), ud_table->primmap.size());
-      ud_table->uniquemap.emplace(string(newrow->GetField(1)->GetCharVal(), (*iter).GetField(1)->GetLength()), ud_table->primmap.size());
       //调用堆表更新
       if (!table_heap->UpdateTuple(*newrow, (*iter).GetRowId(), nullptr))
       {
         cout << "更新堆表失败！\n";
+        delete newrow;
         return DB_FAILED;
       }
-      //B+树更新,遍历索引,先删除再插入
+      eraseUniqueValues(ud_table, *iter);
+      addUniqueValues(ud_table, *newrow);
+      //B+树更新,只处理键改变的索引,先删除再插入
       for (uint32_t i = 0; i < indexes.size(); i++)
       {
-        vector<Field> index_fields;
-        index_fields.push_back(*(((*iter).GetField(indexes[i]->GetColIndex(0)))));
-        Row key_row(index_fields);
+        if (!indexKeyChanged(indexes[i], *iter, *newrow)) continue;
+        Row key_row = getIndexKeyRow(indexes[i], *iter);
         if (indexes[i]->GetIndex()->RemoveEntry(key_row, nullptr) != DB_SUCCESS)
         {
           cout << "更新删除索引记录失败\n";
@@ -1250,10 +1542,7 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
           return DB_FAILED;
         } 
 
-        index_fields.clear();
-        index_fields.push_back(*(newrow->GetField(indexes[i]->GetColIndex(0))));
-        Row new_key_row(index_fields);
-        new_key_row.SetRowId(newrow->GetRowId());
+        Row new_key_row = getIndexKeyRow(indexes[i], *newrow);
         if (indexes[i]->GetIndex()->InsertEntry(new_key_row, newrow->GetRowId(), nullptr) != DB_SUCCESS)
         {
           cout << "更新插入索引记录失败\n";
@@ -1269,6 +1558,70 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
 }
 
 
+//统计信息中的值转为字符串用于输出
+string statisticsValue(const Field &value)
+{
+  switch (value.GetType())
+  {
+  case kTypeInt:
+    return to_string(value.GetIntVal());
+  case kTypeFloat:
+    return to_string(value.GetFloatVal());
+  default:
+    return string(value.GetData(), value.GetLength());
+  }
+}
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  if (strcmp(ast->val_, "analyze") != 0)//检查语义，只支持analyze table
+  {
+    cout << "不支持的命令: " << ast->val_ << endl;
+    return DB_FAILED;
+  }
+  //根据当前所在数据库名称获取当前数据库
+  if (!current_db_.length())//当前无数据库
+  {
+    std::cout << "No current dbs!" << std::endl;
+    return DB_FAILED;
+  }
+  DBStorageEngine *now_dbs = dbs_.at(current_db_);
+
+  //收集表的统计信息并保存在catalog中
+  std::string table_name = ast->child_->val_;
+  TableSample table_sample;
+  const TableSample *sample = nullptr;
+  if (ast->child_->next_ != nullptr)//只扫描样本
+  {
+    if (getTableSample(ast->child_->next_, table_sample) != DB_SUCCESS) return DB_FAILED;
+    sample = &table_sample;
+  }
+  TableStatistics *statistics;
+  dberr_t analyze_ret = now_dbs->catalog_mgr_->AnalyzeTable(table_name, statistics, sample);
+  if (analyze_ret != DB_SUCCESS) return analyze_ret;
+  TableInfo *table;
+  now_dbs->catalog_mgr_->GetTable(table_name, table);
+  Schema *schema = table->GetSchema();
+
+  //输出每一列的统计信息
+  cout << "行数: " << statistics->GetRowCount() << endl;
+  cout << setw(20) << setiosflags(ios::left) << "列名" << setw(20) << "空值比例" << setw(20) << "不同值个数"
+       << setw(20) << "最小值" << setw(20) << "最大值" << "直方图桶数" << endl;
+  for (uint32_t i = 0; i < statistics->GetColumnCount(); i++)
+  {
+    const ColumnStatistics &column = statistics->GetColumn(i);
+    bool has_value = !column.bounds_.empty();
+    cout << setw(20) << schema->GetColumn(i)->GetName() << setw(20) << statistics->GetNullFraction(i)
+         << setw(20) << column.distinct_count_
+         << setw(20) << (has_value ? statisticsValue(column.bounds_.front()) : "null")
+         << setw(20) << (has_value ? statisticsValue(column.bounds_.back()) : "null")
+         << (has_value ? column.bounds_.size() - 1 : 0) << endl;
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteExecfile" << std::endl;
@@ -4,6 +4,7 @@
 #include <list>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "buffer/lru_replacer.h"
 #include "page/page.h"
@@ -28,6 +29,12 @@ public:
 
   bool DeletePage(page_id_t page_id);
 
+  /**
+   * Delete the page now if it is not pinned, otherwise when its last pin is released, so a caller never waits for
+   * the users of a page it no longer links to
+   */
+  void DeletePageWhenUnpinned(page_id_t page_id);
+
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
@@ -51,7 +58,8 @@ private:
   std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
-  recursive_mutex latch_;                                   // to protect shared data structure
+  std::unordered_set<page_id_t> deferred_deletes_;          // pinned pages deleted by their last unpin
+  recursive_mutex latch_;                                   // to protect shared data structure, pages are latched by their users
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
@@ -71,7 +71,12 @@ public:
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info, uint32_t prim_idx);
+  /**
+   * Create a table and the index on its primary key
+   * @param layout page layout of the table heap, DB_FAILED if a row of the schema can not fit in a page of the layout
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      uint32_t prim_idx, TableLayout layout = TableLayout::kRowLayout);
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
@@ -79,7 +84,8 @@ public:
 
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn,
-                      IndexInfo *&index_info);
+                      IndexInfo *&index_info, IndexType index_type = IndexType::kBPlusTree,
+                      bool unique = true, const std::vector<std::string> &include_columns = {});
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -89,6 +95,13 @@ public:
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Collect the statistics of a table and keep them in the catalog, replacing those of the last analyze
+   * @param sample only scan a sample of the table, nullptr to scan all of it
+   */
+  dberr_t AnalyzeTable(const std::string &table_name, TableStatistics *&statistics,
+                       const TableSample *sample = nullptr);
+
 private:
   dberr_t FlushCatalogMetaPage() const;
 
@@ -98,6 +111,16 @@ private:
 
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
+  /**
+   * Statistics are stored in a chain of overflow pages, they do not fit in the table metadata page
+   * @return first page of the chain
+   */
+  page_id_t WriteStatistics(const TableStatistics *statistics);
+
+  TableStatistics *ReadStatistics(page_id_t page_id, MemHeap *heap);
+
+  void FreeStatistics(page_id_t page_id);
+
 private:
   [[maybe_unused]] BufferPoolManager *buffer_pool_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
@@ -6,8 +6,30 @@
 #include "catalog/table.h"
 #include "index/generic_key.h"
 #include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
 #include "record/schema.h"
-using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template<size_t KeySize>
+using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<KeySize>, RowId, GenericComparator<KeySize>>;
+
+template<size_t KeySize>
+using HASH_INDEX = ExtendibleHashIndex<KeySize>;
+
+/**
+ * Key widths the B+ tree and hash indexes are instantiated for
+ */
+static constexpr uint32_t INDEX_KEY_SIZES[] = {4, 8, 16, 32, 64};
+
+static constexpr uint32_t MAX_INDEX_KEY_SIZE = INDEX_KEY_SIZES[sizeof(INDEX_KEY_SIZES) / sizeof(INDEX_KEY_SIZES[0]) - 1];
+
+/**
+ * Types of index, chosen by CREATE INDEX ... USING
+ */
+enum class IndexType : uint32_t {
+  kBPlusTree,             /** btree: B+ tree with latch crabbing lookups */
+  kOptimisticBPlusTree,   /** olc: B+ tree with optimistic lookups validated by page versions */
+  kHash,                  /** hash: extendible hash table, equality lookups only */
+};
 
 class IndexMetadata {
   friend class IndexInfo;
@@ -15,7 +37,8 @@ class IndexMetadata {
 public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name,
                                const table_id_t table_id, const std::vector<uint32_t> &key_map,
-                               MemHeap *heap);
+                               MemHeap *heap, IndexType index_type = IndexType::kBPlusTree, bool unique = true,
+                               const std::vector<uint32_t> &include_map = {});
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -31,19 +54,40 @@ public:
 
   inline const std::vector<uint32_t> &GetKeyMapping() const { return key_map_; }
 
+  inline const std::vector<uint32_t> &GetIncludeMapping() const { return include_map_; }
+
   inline index_id_t GetIndexId() const { return index_id_; }
 
-  uint32_t GetColIndex(uint32_t i) { return key_map_[i]; }
+  /**
+   * @return column in the table of the i-th column kept in the index, the included columns follow the key columns
+   */
+  uint32_t GetColIndex(uint32_t i) {
+    return i < key_map_.size() ? key_map_[i] : include_map_[i - key_map_.size()];
+  }
+
+  inline IndexType GetIndexType() const { return index_type_; }
+
+  /** @return false if the index allows duplicate keys */
+  inline bool IsUnique() const { return unique_; }
+
+  /**
+   * @return false if type_name is not the name of an index type in USING, in any case
+   */
+  static bool GetIndexTypeByName(const std::string &type_name, IndexType &index_type);
 
 private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map) {
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map,
+                         IndexType index_type, bool unique, const std::vector<uint32_t> &include_map) {
                            index_id_ = index_id;
                            index_name_ = index_name;
                            table_id_ = table_id;
                            key_map_ = key_map;
+                           index_type_ = index_type;
+                           unique_ = unique;
+                           include_map_ = include_map;
                          }
 
 private:
@@ -52,6 +96,9 @@ private:
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_;  /** The mapping of index key to tuple key */
+  IndexType index_type_;
+  bool unique_;
+  std::vector<uint32_t> include_map_;  /** Columns of the tuple stored in the index after the key, see INCLUDE */
 };
  
 /**
@@ -78,40 +125,105 @@ public:
 
   inline std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
+  /**
+   * @return schema of the columns kept in the index, the key columns and then the included columns
+   */
   inline IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  /**
+   * @return number of key columns, the first columns of the key schema
+   */
+  inline uint32_t GetKeyColumnCount() const { return meta_data_->GetIndexColumnCount(); }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline TableInfo *GetTableInfo() const { return table_info_; }
 
+  inline IndexType GetIndexType() const { return meta_data_->GetIndexType(); }
+
+  /**
+   * @return false if the index only finds the entries equal to a key, it has no ScanRange
+   */
+  inline bool IsOrdered() const { return GetIndexType() != IndexType::kHash; }
+
+  /**
+   * @return width of the GenericKey of the index, the index is a BP_TREE_INDEX<GetKeySize()> or a
+   * HASH_INDEX<GetKeySize()>
+   */
+  inline uint32_t GetKeySize() const { return key_size_; }
+
+  /**
+   * @return the smallest key width any key of the schema fits in, the largest one if there is none, the index
+   * rejects keys longer than it. Keys of a non-unique index have the row id appended.
+   */
+  static uint32_t ChooseKeySize(const Schema *key_schema, bool unique = true);
+
+  /**
+   * @return upper bound of the encoded size of column in a key, without the escapes of 0 bytes in chars
+   */
+  static uint32_t GetMaxKeySize(const Column *column);
+
+  /**
+   * @return true if a key with value in its first key column fits the key width, a lookup or a scan bound of a
+   * value that does not fit cannot use the index
+   */
+  bool FitsKey(const Field &value) const;
+
   uint32_t GetColIndex(uint32_t i) { return meta_data_->GetColIndex(i); }
 
 private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr},
                          key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
 
+  template<size_t KeySize>
+  Index *AllocIndex(BufferPoolManager *buffer_pool_manager) {
+    if (meta_data_->index_type_ == IndexType::kHash) {
+      return ALLOC_P(heap_, HASH_INDEX<KeySize>)(meta_data_->index_id_, key_schema_, buffer_pool_manager,
+                                                 meta_data_->unique_, meta_data_->include_map_.size());
+    }
+    BPlusTreeMode mode = meta_data_->index_type_ == IndexType::kOptimisticBPlusTree ? BPlusTreeMode::kOptimistic
+                                                                                    : BPlusTreeMode::kLatchCrabbing;
+    return ALLOC_P(heap_, BP_TREE_INDEX<KeySize>)(meta_data_->index_id_, key_schema_, buffer_pool_manager, mode,
+                                                  meta_data_->unique_, meta_data_->include_map_.size());
+  }
+
   Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
-    // //ASSERT(false, "Not Implemented yet.");
-    // void * buf = heap_->Allocate(sizeof(BPlusTreeIndex<GenericKey<4>, RowId, GenericComparator<4>>));
-    // index = new(buf)BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>(meta_data_->index_id_,key_schema_, buffer_pool_manager);
-    BP_TREE_INDEX * index = ALLOC_P(heap_, BP_TREE_INDEX)(meta_data_->index_id_,key_schema_, buffer_pool_manager);
-    TableHeap * table_heap;
-    table_heap = table_info_->GetTableHeap();
-    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
-        // std::cout << "Index *CreateIndex for flag1\n";
-        
-        const Row &row = *iter;
-        std::vector<Field> new_fields;
-        uint32_t idx;
-        for(auto iter2 = meta_data_->key_map_.begin();iter2!=meta_data_->key_map_.end();iter2++){
-          idx = *iter2;
-          new_fields.emplace_back(*(row.GetField(idx)));
-        }
-        Row new_row(new_fields);
-        // std::cout << "Index *CreateIndex for flag2\n";
-        index->InsertEntry(new_row, row.GetRowId(), nullptr);
-        // std::cout << "Index *CreateIndex for flag3\n";
+    //按键的宽度选择实例化的B+树或哈希表，键越窄每页能放的键越多；哈希索引的键后不附加rowid
+    key_size_ = ChooseKeySize(key_schema_, meta_data_->unique_ || meta_data_->index_type_ == IndexType::kHash);
+    Index *index;
+    switch (key_size_) {
+      case 4:
+        index = AllocIndex<4>(buffer_pool_manager);
+        break;
+      case 8:
+        index = AllocIndex<8>(buffer_pool_manager);
+        break;
+      case 16:
+        index = AllocIndex<16>(buffer_pool_manager);
+        break;
+      case 32:
+        index = AllocIndex<32>(buffer_pool_manager);
+        break;
+      default:
+        index = AllocIndex<64>(buffer_pool_manager);
+        break;
     }
+    //表中已有的行通过外部排序自底向上批量建树，不再逐行插入
+    TableHeap *table_heap = table_info_->GetTableHeap();
+    auto iter = table_heap->Begin(nullptr);
+    index->BulkInsert([&](std::vector<Field> &key_fields, RowId &row_id) {
+      if (iter == table_heap->End()) {
+        return false;
+      }
+      const Row &row = *iter;
+      key_fields.clear();
+      for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+        key_fields.emplace_back(*(row.GetField(meta_data_->GetColIndex(i))));
+      }
+      row_id = row.GetRowId();
+      ++iter;
+      return true;
+    }, INDEX_FILL_FACTOR, nullptr);
     return index;
   }
 
@@ -121,6 +233,7 @@ private:
   TableInfo *table_info_;
   IndexSchema *key_schema_;
   MemHeap *heap_;
+  uint32_t key_size_{0};
 };
 
 
@@ -4,6 +4,7 @@
 #include <memory>
 #include <unordered_map>
 #include "glog/logging.h"
+#include "catalog/table_statistics.h"
 #include "record/schema.h"
 #include "storage/table_heap.h"
 
@@ -18,7 +19,9 @@ public:
   static uint32_t DeserializeFrom(char *buf, TableMetadata *&table_meta, MemHeap *heap);
 
   static TableMetadata *Create(table_id_t table_id, std::string table_name,
-                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap, uint32_t prim_idx);
+                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap, uint32_t prim_idx,
+                               TableLayout layout = TableLayout::kRowLayout,
+                               page_id_t dictionary_page_id = INVALID_PAGE_ID);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -30,10 +33,23 @@ public:
 
   inline uint32_t GetPrimIdx() const { return prim_idx_; }
 
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * @return first page of the dictionary of the encoded columns, INVALID_PAGE_ID if there is none
+   */
+  inline page_id_t GetDictionaryPageId() const { return dictionary_page_id_; }
+
+  /**
+   * @return first page of the statistics collected by the last ANALYZE, INVALID_PAGE_ID if never analyzed
+   */
+  inline page_id_t GetStatisticsPageId() const { return statistics_page_id_; }
+
 private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema, uint32_t prim_idx);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                uint32_t prim_idx, TableLayout layout, page_id_t dictionary_page_id);
 
 private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
@@ -42,6 +58,9 @@ private:
   page_id_t root_page_id_;
   Schema *schema_;
   uint32_t prim_idx_;
+  TableLayout layout_;
+  page_id_t dictionary_page_id_;
+  page_id_t statistics_page_id_{INVALID_PAGE_ID};
 };
 
 /**
@@ -81,6 +100,23 @@ public:
 
   inline uint32_t GetPrimIdx() const { return table_meta_->GetPrimIdx(); }
 
+  inline TableLayout GetLayout() const { return table_meta_->GetLayout(); }
+
+  /**
+   * @return statistics collected by the last ANALYZE, nullptr if the table was never analyzed
+   */
+  inline TableStatistics *GetStatistics() const { return statistics_; }
+
+  inline page_id_t GetStatisticsPageId() const { return table_meta_->GetStatisticsPageId(); }
+
+  /**
+   * @param statistics_page_id where the statistics are kept when the catalog is flushed
+   */
+  void SetStatistics(TableStatistics *statistics, page_id_t statistics_page_id) {
+    statistics_ = statistics;
+    table_meta_->statistics_page_id_ = statistics_page_id;
+  }
+
   std::unordered_map<uint32_t, uint32_t> primmap;
   uint32_t prim_idx = 0;
   std::unordered_map<std::string, uint32_t> uniquemap;
@@ -92,6 +128,7 @@ private:
 private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStatistics *statistics_{nullptr};
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
 };
 
@@ -0,0 +1,75 @@
+#ifndef MINISQL_TABLE_STATISTICS_H
+#define MINISQL_TABLE_STATISTICS_H
+
+#include <vector>
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * Distribution of the values of one column.
+ */
+struct ColumnStatistics {
+  uint32_t null_count_{0};
+  /** estimated by HyperLogLog over every non-null value */
+  uint32_t distinct_count_{0};
+  /**
+   * Bounds of an equi-depth histogram over the non-null values, every bucket holds the same share of them.
+   * The first and last bound are the min and max of the column, there is no bound if every value is null.
+   * Char bounds are cut to MAX_BOUND_LENGTH bytes.
+   */
+  std::vector<Field> bounds_;
+};
+
+/**
+ * Statistics of a table collected by ANALYZE, used to estimate the selectivity of predicates.
+ */
+class TableStatistics {
+public:
+  /**
+   * Scan the table once. Row count, null count, min/max and distinct count see every row,
+   * histograms are built from a reservoir sample of SAMPLE_SIZE values per column.
+   * @param sample only scan a sample of the table. Row and null counts are scaled up to the whole table,
+   *        min/max are those of the sample, and distinct counts are only scaled up for columns that look
+   *        unique in the sample, since the number of values missed by a sample is unknown.
+   */
+  static TableStatistics *Collect(TableHeap *table_heap, const Schema *schema, MemHeap *heap,
+                                  const TableSample *sample = nullptr);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  static uint32_t DeserializeFrom(char *buf, TableStatistics *&statistics, MemHeap *heap);
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline const ColumnStatistics &GetColumn(uint32_t column_index) const { return columns_[column_index]; }
+
+  double GetNullFraction(uint32_t column_index) const;
+
+  /**
+   * @return estimated fraction of the rows whose value equals a given value of the column
+   */
+  double EstimateEqualsSelectivity(uint32_t column_index) const;
+
+  /**
+   * @return estimated fraction of the rows whose value is less than the given value
+   */
+  double EstimateLessThanSelectivity(uint32_t column_index, const Field &value) const;
+
+  static constexpr uint32_t HISTOGRAM_BUCKETS = 16;
+  static constexpr uint32_t SAMPLE_SIZE = 4096;
+  static constexpr uint32_t MAX_BOUND_LENGTH = 64;
+
+private:
+  TableStatistics() = default;
+
+  static constexpr uint32_t TABLE_STATISTICS_MAGIC_NUM = 520731;
+  uint32_t row_count_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+#endif //MINISQL_TABLE_STATISTICS_H
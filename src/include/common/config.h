@@ -17,7 +17,10 @@ static constexpr int PAGE_SIZE = 4096;               // size of a data page in b
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 4096;// default size of buffer pool
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
-static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
+static constexpr uint32_t VARCHAR_MAX_LEN = 4 * PAGE_SIZE;    // max length of varchar, long values live in overflow pages
+static constexpr uint32_t OVERFLOW_THRESHOLD = 256;           // longer char values of a table are kept in overflow pages
+static constexpr double INDEX_FILL_FACTOR = 0.9;              // fill of the pages of an index built from a table
+static constexpr uint32_t INDEX_SORT_MEMORY = 64 << 20;       // bytes of keys sorted in memory to build an index
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
@@ -8,11 +8,14 @@
 #include <fstream>
 #include <set>
 #include <algorithm>
+#include <random>
 #include "common/dberr.h"
 #include "common/instance.h"
 #include "transaction/transaction.h"
 #include "glog/logging.h"
 #include "parser/syntax_tree_printer.h"
+#include "record/field_kernels.h"
+#include "utils/mem_heap.h"
 #include "utils/tree_file_mgr.h"
 
 extern "C" {
@@ -23,8 +26,6 @@ int yyparse(void);
 
 using namespace std;
 
-#define Mapping_Type std::pair<GenericKey<64>, RowId>
-
 
 int select_record;
 
@@ -58,6 +59,8 @@ public:
   dberr_t Execute(pSyntaxNode ast, ExecuteContext *context);
 
 private:
+  dberr_t ExecuteStatement(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context);
@@ -86,6 +89,8 @@ private:
 
   dberr_t ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
@@ -93,11 +98,13 @@ private:
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database */
+  ArenaMemHeap statement_heap_;  /** temporary objects of the running statement, reset after each statement */
 };
 
 struct SelectCondition
 {
   string attri_name;
+  uint32_t col_idx_;//条件中的列在表模式中的列号，生成条件时解析
   uint32_t type_;//0等于；1不等于；2小于；3大于；4小于等于；5大于等于
   TypeId type_id_;
   union Val {
@@ -105,11 +112,14 @@ struct SelectCondition
     int int_;
     char *chars_;
   } value_;
+  bool encoded_ = false;//为true时条件的值已替换为字典编码，直接与列的编码比较
+  FieldMatchFunc match_ = nullptr;//按列类型和比较类型选出的比较函数
 };
 
 struct UpdateItem
 {
   string name;
+  uint32_t col_idx_;//更新的列在表模式中的列号
   TypeId type_;
   union Val {
     float float_;
@@ -1,18 +1,33 @@
 #ifndef MINISQL_B_PLUS_TREE_H
 #define MINISQL_B_PLUS_TREE_H
 
+#include <atomic>
+#include <deque>
 #include <queue>
 #include <string>
 #include <vector>
 
-#include "page/b_plus_tree_internal_page.h"
-#include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
+#include "page/b_plus_tree_page_format.h"
+#include "common/rwlatch.h"
 #include "transaction/transaction.h"
+#include "index/external_sorter.h"
 #include "index/index_iterator.h"
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * The change a write descent latches pages for, which decides when a node is safe
+ */
+enum class LatchMode { kInsert, kRemove };
+
+/**
+ * How readers synchronize with writers, writers always use latch crabbing
+ * kLatchCrabbing: readers couple read latches down the tree
+ * kOptimistic: readers take no latch on the way down, they validate the version of every page read instead
+ */
+enum class BPlusTreeMode { kLatchCrabbing, kOptimistic };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
@@ -22,15 +37,29 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) Safe for concurrent use with latch crabbing: lookups couple read latches
+ * down the tree, inserts and removes couple write latches and release those of
+ * the ancestors at a node that will not split or merge. root_page_id_ is
+ * guarded by its own latch. Iterators hold a read latch on their leaf.
+ * (6) In kOptimistic mode lookups take no latch: a page is copied and the copy
+ * is used only if the version of the page is unchanged, and the version of the
+ * parent is checked again once the child is read, so that a split or merge that
+ * moved the key restarts the lookup from the root.
+ * (7) Wide generic keys are kept in slotted pages, see BPlusTreePageFormat. Their
+ * nodes split, merge and redistribute by bytes instead of by number of pairs, the
+ * max sizes given are not used, and a merge or redistribution that does not fit
+ * leaves the node under its min size.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
-  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
-  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Format = BPlusTreePageFormat<KeyType, ValueType, KeyComparator>;
+  using InternalPage = typename Format::InternalPage;
+  using LeafPage = typename Format::LeafPage;
 
 public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     BPlusTreeMode mode = BPlusTreeMode::kLatchCrabbing);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -41,6 +70,9 @@ public:
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Build an empty tree from the sorted pairs of sorter, nodes are filled to fill_factor of their max size
+  bool BulkLoad(ExternalSorter<KeyType, ValueType, KeyComparator> &sorter, double fill_factor);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
@@ -48,11 +80,16 @@ public:
 
   INDEXITERATOR_TYPE Begin(const KeyType &key);
 
+  // iterator at the first pair whose key is greater than key
+  INDEXITERATOR_TYPE UpperBound(const KeyType &key);
+
   INDEXITERATOR_TYPE End();
 
-  // expose for test purpose
+  // expose for test purpose, the leaf page returned is pinned and read latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false, bool rightmost = false);
 
+  BPlusTreeMode GetMode() const { return mode_; }
+
   // used to check whether all pages are unpinned
   bool Check();
 
@@ -86,16 +123,81 @@ private:
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
 
   template<typename N>
-  bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
-                int index, Transaction *transaction = nullptr);
+  bool Coalesce(N **neighbor_node, N **node, InternalPage **parent, int index, Transaction *transaction = nullptr);
 
   template<typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
 
-  bool AdjustRoot(BPlusTreePage *node);
+  bool AdjustRoot(BPlusTreePage *node, Transaction *transaction);
+
+  bool FindLeafPageOptimistic(const KeyType &key, bool leftMost, bool rightmost, Page *&leaf, uint64_t &version,
+                              char *leaf_copy);
+
+  bool ReadOptimistic(Page *page, uint64_t &version, char *copy) const;
+
+  Page *FindLeafPageForWrite(const KeyType &key, LatchMode mode, Transaction *transaction);
+
+  bool IsSafe(BPlusTreePage *node, LatchMode mode) const;
+
+  // size checks of the page format, by number of pairs for arrays and by bytes for slotted pages
+  bool IsOverflow(BPlusTreePage *node) const;
+
+  bool IsUnderflow(BPlusTreePage *node) const;
+
+  template<typename N>
+  bool CanMerge(N *left, N *right, const KeyType &middle_key) const;
+
+  void ReleaseLatches(Transaction *transaction, bool is_dirty);
+
+  void DeletePages(Transaction *transaction);
 
   void UpdateRootPageId(int insert_record = 0);
 
+  // a level of the tree being bulk loaded, its entries are spread evenly over its nodes
+  struct BulkLevel {
+    int entries_;
+    int nodes_;
+    int node_{-1};
+    int filled_{0};
+    BPlusTreePage *page_{nullptr};
+
+    int Quota() const { return entries_ / nodes_ + (node_ < entries_ % nodes_); }
+  };
+
+  static int BulkNodeCount(int entries, int max_size, double fill_factor);
+
+  BPlusTreePage *BulkNextNode(std::vector<BulkLevel> &levels, size_t level, const KeyType &key);
+
+  page_id_t BulkAppendChild(std::vector<BulkLevel> &levels, size_t level, const KeyType &key, page_id_t child);
+
+  // the open node of a level of a slotted tree being bulk loaded, its entries are kept until it is full
+  template<typename V>
+  struct SlottedBulkNode {
+    std::vector<std::pair<KeyType, V>> entries_;
+    bool bounded_{false};
+    KeyType low_;
+    // bytes of the entries with the prefix shared by the low fence and the last key
+    uint32_t prefix_length_{0};
+    uint32_t bytes_{0};
+    int closed_{0};
+  };
+
+  struct SlottedBulkLoad {
+    SlottedBulkNode<ValueType> leaves_;
+    // internal levels from the bottom up
+    std::deque<SlottedBulkNode<page_id_t>> levels_;
+    Page *last_leaf_{nullptr};
+    page_id_t root_{INVALID_PAGE_ID};
+  };
+
+  template<typename N, typename V>
+  void BulkSlottedAdd(SlottedBulkLoad &load, size_t level, SlottedBulkNode<V> &node, const KeyType &key,
+                      const V &value, double fill_factor);
+
+  template<typename N, typename V>
+  void BulkSlottedClose(SlottedBulkLoad &load, size_t level, SlottedBulkNode<V> &node, bool last,
+                        double fill_factor);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -103,11 +205,14 @@ private:
 
   // member variable
   index_id_t index_id_;
-  page_id_t root_page_id_;
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // guards root_page_id_ for writers, and for readers in kLatchCrabbing mode
+  ReaderWriterLatch root_latch_;
+  BPlusTreeMode mode_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -9,14 +9,52 @@
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
 public:
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+  /**
+   * A non-unique index appends the row id to every key, see GenericKey::AppendRowId, so the keys in the tree are
+   * unique and the entries of a key are next to each other.
+   *
+   * The last include_count columns of key_schema are included columns: their values are encoded after the key
+   * columns, so a scan reads them from the leaves without fetching the rows, but they are not part of the key.
+   */
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                 BPlusTreeMode mode = BPlusTreeMode::kLatchCrabbing, bool unique = true, uint32_t include_count = 0);
 
+  /**
+   * key has the fields of all columns of the key schema, a unique index with included columns fails if it has the
+   * key already. A key that does not fit in KeyType fails.
+   */
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  /**
+   * A non-unique index removes the entry of key.GetRowId()
+   */
   dberr_t RemoveEntry(const Row &key, Transaction *txn) override;
 
+  /**
+   * key has the fields of the key columns only. A non-unique index returns the row ids of all entries of the key,
+   * in row id order. A key that does not fit in KeyType is not found.
+   */
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
 
+  /**
+   * An empty tree is built bottom up from the keys sorted by an external sort of at most sort_memory bytes
+   */
+  dberr_t BulkInsert(const std::function<bool(std::vector<Field> &key_fields, RowId &row_id)> &next,
+                     double fill_factor, Transaction *txn) override;
+
+  /**
+   * The scan seeks to lower, a bound compares with the bytes of its own encoding, so it is met by all entries whose
+   * key starts with it whatever their included values and row ids are. Fails if a bound does not fit in KeyType.
+   */
+  dberr_t ScanRange(const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive,
+                    const ScanCallback &callback, Transaction *txn, bool decode_keys = false) override;
+
+  void SetSortMemory(size_t sort_memory) { sort_memory_ = sort_memory; }
+
+  bool IsUnique() const { return unique_; }
+
+  uint32_t GetIncludeCount() const { return include_count_; }
+
   dberr_t Destroy() override;
 
   INDEXITERATOR_TYPE GetBeginIterator();
@@ -26,10 +64,23 @@ public:
   INDEXITERATOR_TYPE GetEndIterator();
 
 protected:
+  // encode key as the key in the tree, with row_id appended for a non-unique index, return the size of the key
+  // columns, without the included columns, or KEY_TOO_LONG
+  uint32_t EncodeKey(const Row &key, const RowId &row_id, KeyType &index_key) const;
+
+  // call f on the entries whose first key_size bytes are those of index_key in order, until it returns false
+  template<typename F>
+  void ScanPrefix(KeyType index_key, uint32_t key_size, F &&f);
+
+  bool unique_;
+  // number of included columns at the end of the key schema
+  uint32_t include_count_;
   // comparator for key
   KeyComparator comparator_;
   // container
   BPLUSTREE_TYPE container_;
+  // memory of the sort building the tree
+  size_t sort_memory_{INDEX_SORT_MEMORY};
 };
 
 #endif //MINISQL_B_PLUS_TREE_INDEX_H
@@ -0,0 +1,90 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_INDEX_H
+#define MINISQL_EXTENDIBLE_HASH_INDEX_H
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/generic_key.h"
+#include "index/index.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+
+/**
+ * Extendible hash index for equality lookups. A lookup reads the directory page and the bucket page of the key,
+ * two page accesses however large the table is, see HashTableDirectoryPage and HashTableBucketPage.
+ *
+ * A full bucket splits in two on one more bit of the hash, the directory doubles when the bucket already used all
+ * of its bits. An empty bucket merges with its split image and the directory halves when no bucket needs all of its
+ * bits. The page id of the directory is kept in the index roots page.
+ *
+ * A writer latches the directory page exclusively for the whole change and readers share it, so the bucket pages
+ * take no latch of their own.
+ */
+template<size_t KeySize>
+class ExtendibleHashIndex : public Index {
+  using KeyType = GenericKey<KeySize>;
+  using ValueType = RowId;
+  using BucketPage = HashTableBucketPage<KeyType, ValueType>;
+
+public:
+  /**
+   * The directory is read from the index roots page, an index that has none gets a directory with one empty
+   * bucket. Keys are stored as in BPlusTreeIndex, the last include_count columns of key_schema are included
+   * columns, but a non-unique index does not append the row id: the duplicates of a key share a bucket.
+   */
+  ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                      bool unique = true, uint32_t include_count = 0);
+
+  /**
+   * key has the fields of all columns of the key schema, a unique index fails if it has the key already. A key that
+   * does not fit in KeyType fails.
+   */
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  /**
+   * A non-unique index removes the entry of key.GetRowId()
+   */
+  dberr_t RemoveEntry(const Row &key, Transaction *txn) override;
+
+  /**
+   * key has the fields of the key columns only, the row ids of its entries are in no order. A key that does not fit
+   * in KeyType is not found.
+   */
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) override;
+
+  dberr_t Destroy() override;
+
+  bool IsUnique() const { return unique_; }
+
+  uint32_t GetGlobalDepth();
+
+private:
+  // encode key, return the size of the key columns, without the included columns, or KEY_TOO_LONG
+  uint32_t EncodeKey(const Row &key, KeyType &index_key) const;
+
+  // hash of the first key_size bytes of index_key, its key columns
+  static uint32_t Hash(const KeyType &index_key, uint32_t key_size);
+
+  // hash of the key columns of an entry of a bucket
+  uint32_t EntryHash(const KeyType &index_key) const;
+
+  // split the bucket of bucket_idx on one more bit of the hash, false if the directory cannot grow
+  bool SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx);
+
+  // merge the empty bucket of bucket_idx into its split image and shrink the directory
+  void MergeBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx);
+
+  // collect the pairs of the bucket and its overflow pages, the overflow pages are deleted
+  void TakeEntries(page_id_t bucket_page_id, std::vector<std::pair<KeyType, ValueType>> &entries);
+
+  // fill an empty bucket with entries, with overflow pages for the ones that do not fit
+  void FillBucket(page_id_t bucket_page_id, const std::vector<std::pair<KeyType, ValueType>> &entries);
+
+  BucketPage *FetchBucket(page_id_t bucket_page_id);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t directory_page_id_{INVALID_PAGE_ID};
+  bool unique_;
+  // number of included columns at the end of the key schema
+  uint32_t include_count_;
+};
+
+#endif //MINISQL_EXTENDIBLE_HASH_INDEX_H
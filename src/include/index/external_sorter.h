@@ -0,0 +1,169 @@
+#ifndef MINISQL_EXTERNAL_SORTER_H
+#define MINISQL_EXTERNAL_SORTER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * Sorts key & value pairs by key for bulk loading an index, with an external merge sort when they don't fit in
+ * memory_limit bytes. Pairs are collected into a buffer, a full buffer is sorted and written to a temporary file as
+ * a run, and Finish merges the runs into one sorted file. Pairs must be trivially copyable, they are written to the
+ * files as they are.
+ *
+ * Only the first pair added of every key is kept, as inserting them one by one into a unique index would do.
+ */
+template<typename KeyType, typename ValueType, typename KeyComparator>
+class ExternalSorter {
+  using Pair = std::pair<KeyType, ValueType>;
+
+public:
+  ExternalSorter(const KeyComparator &comparator, size_t memory_limit)
+          : comparator_(comparator), buffer_capacity_(std::max<size_t>(memory_limit / sizeof(Pair), 2)) {}
+
+  ~ExternalSorter() {
+    for (auto run : runs_) {
+      fclose(run);
+    }
+    if (output_ != nullptr) {
+      fclose(output_);
+    }
+  }
+
+  void Add(const KeyType &key, const ValueType &value) {
+    ASSERT(!finished_, "Add after finish.");
+    buffer_.emplace_back(key, value);
+    if (buffer_.size() >= buffer_capacity_) {
+      Spill();
+    }
+  }
+
+  /**
+   * Sort all pairs added, then they are read in order by Next
+   */
+  void Finish() {
+    finished_ = true;
+    if (runs_.empty()) {
+      SortBuffer();
+      size_ = buffer_.size();
+      return;
+    }
+    Spill();
+    Merge();
+  }
+
+  /**
+   * @return number of pairs after dropping duplicated keys, valid after Finish
+   */
+  size_t Size() const { return size_; }
+
+  /**
+   * @return number of runs written to temporary files
+   */
+  size_t GetRunCount() const { return run_count_; }
+
+  bool Next(KeyType &key, ValueType &value) {
+    ASSERT(finished_, "Next before finish.");
+    Pair pair;
+    if (output_ != nullptr) {
+      if (fread(&pair, sizeof(Pair), 1, output_) != 1) {
+        return false;
+      }
+    } else {
+      if (next_ == buffer_.size()) {
+        return false;
+      }
+      pair = buffer_[next_++];
+    }
+    key = pair.first;
+    value = pair.second;
+    return true;
+  }
+
+private:
+  /**
+   * Stable sort keeps the pairs of a key in the order they were added, then the first one of each key is kept
+   */
+  void SortBuffer() {
+    std::stable_sort(buffer_.begin(), buffer_.end(),
+                     [this](const Pair &l, const Pair &r) { return comparator_(l.first, r.first) < 0; });
+    auto end = std::unique(buffer_.begin(), buffer_.end(),
+                           [this](const Pair &l, const Pair &r) { return comparator_(l.first, r.first) == 0; });
+    buffer_.erase(end, buffer_.end());
+  }
+
+  void Spill() {
+    FILE *run = tmpfile();
+    if (run == nullptr) {
+      // no temporary file, keep sorting in memory
+      buffer_capacity_ *= 2;
+      return;
+    }
+    SortBuffer();
+    ASSERT(fwrite(buffer_.data(), sizeof(Pair), buffer_.size(), run) == buffer_.size(), "Write sort run failed.");
+    rewind(run);
+    runs_.push_back(run);
+    run_count_++;
+    buffer_.clear();
+  }
+
+  /**
+   * Merge all runs into output_, a key in several runs is taken from the earliest run
+   */
+  void Merge() {
+    struct Head {
+      Pair pair_;
+      size_t run_;
+    };
+    auto greater = [this](const Head &l, const Head &r) {
+      int cmp = comparator_(l.pair_.first, r.pair_.first);
+      return cmp != 0 ? cmp > 0 : l.run_ > r.run_;
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+    for (size_t i = 0; i < runs_.size(); i++) {
+      Head head{Pair(), i};
+      if (fread(&head.pair_, sizeof(Pair), 1, runs_[i]) == 1) {
+        heads.push(head);
+      }
+    }
+    output_ = tmpfile();
+    ASSERT(output_ != nullptr, "Create sort output failed.");
+    bool has_last = false;
+    KeyType last;
+    size_ = 0;
+    while (!heads.empty()) {
+      Head head = heads.top();
+      heads.pop();
+      if (!has_last || comparator_(last, head.pair_.first) != 0) {
+        ASSERT(fwrite(&head.pair_, sizeof(Pair), 1, output_) == 1, "Write sort output failed.");
+        last = head.pair_.first;
+        has_last = true;
+        size_++;
+      }
+      if (fread(&head.pair_, sizeof(Pair), 1, runs_[head.run_]) == 1) {
+        heads.push(head);
+      }
+    }
+    for (auto run : runs_) {
+      fclose(run);
+    }
+    runs_.clear();
+    rewind(output_);
+  }
+
+  KeyComparator comparator_;
+  size_t buffer_capacity_;
+  std::vector<Pair> buffer_;
+  size_t next_{0};
+  std::vector<FILE *> runs_;
+  size_t run_count_{0};
+  FILE *output_{nullptr};
+  size_t size_{0};
+  bool finished_{false};
+};
+
+#endif  // MINISQL_EXTERNAL_SORTER_H
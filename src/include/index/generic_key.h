@@ -1,27 +1,181 @@
 #ifndef MINISQL_GENERIC_KEY_H
 #define MINISQL_GENERIC_KEY_H
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "record/row.h"
 #include "record/field.h"
 
+/**
+ * @return upper bound of the encoded size of the keys of the schema, see GenericKey
+ */
+inline uint32_t GetMaxEncodedKeySize(const Schema *schema) {
+  uint32_t size = 0;
+  for (auto column : schema->GetColumns()) {
+    size += column->IsNullable();
+    size += column->GetType() == TypeId::kTypeChar ? 2 * column->GetLength() + 2 : sizeof(uint32_t);
+  }
+  return size;
+}
+
+/**
+ * Size of the row id appended to the keys of a non-unique index, see GenericKey::AppendRowId
+ */
+static constexpr uint32_t KEY_ROW_ID_SIZE = 2 * sizeof(uint32_t);
+
+/**
+ * Returned by GenericKey::SerializeFromKey for a key that does not fit in the key width
+ */
+static constexpr uint32_t KEY_TOO_LONG = UINT32_MAX;
+
+/**
+ * Index key in a memcomparable encoding: memcmp of two encoded keys orders them as comparing the key columns one
+ * by one, so the tree compares keys without deserializing them. Every column is encoded as
+ *
+ *   null:  0x00
+ *   int:   0x01, 4 bytes big endian with the sign bit flipped
+ *   float: 0x01, 4 bytes big endian of the bits, negative values with all bits flipped, others with the sign bit
+ *   char:  0x01, the bytes with 0x00 escaped as 0x00 0xff, ended by 0x00 0x00
+ *
+ * A null sorts before any value and equals another null. Columns that are not nullable have no marker, a single
+ * int primary key takes 4 bytes. The char terminator sorts before any byte of a longer string, so a prefix sorts
+ * first, and keeps the encoding self delimiting for the columns after it. The rest of the key is filled with 0.
+ *
+ * No encoded key is a prefix of another one, so two keys are equal or ordered by the bytes of the shorter encoding.
+ * This is what lets a non-unique index append the row id after the encoding.
+ */
 template<size_t KeySize>
 class GenericKey {
 public:
-  inline void SerializeFromKey(const Row &key, Schema *schema) {
+  /**
+   * A key with fewer fields than the schema encodes its first columns, which sorts before every key starting with
+   * them, so it is where the scan of the keys starting with them begins.
+   *
+   * @return size of the encoded key, KEY_TOO_LONG if it does not fit in KeySize bytes, the data is not a key then
+   */
+  inline uint32_t SerializeFromKey(const Row &key, Schema *schema) {
+    ASSERT(key.GetFieldCount() <= schema->GetColumnCount(), "field nums not match.");
     // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
-    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= KeySize, "Index key size exceed max key size.");
     memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    uint32_t ofs = 0;
+    for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+      const Field *field = key.GetField(i);
+      if (!schema->GetColumn(i)->IsNullable()) {
+        ASSERT(!field->IsNull(), "Null value in a column that is not nullable.");
+      } else if (field->IsNull()) {
+        Put(ofs, NULL_MARKER);
+        continue;
+      } else {
+        Put(ofs, VALUE_MARKER);
+      }
+      switch (schema->GetColumn(i)->GetType()) {
+        case TypeId::kTypeInt:
+          PutUint32(ofs, static_cast<uint32_t>(field->GetIntVal()) ^ SIGN_BIT);
+          break;
+        case TypeId::kTypeFloat:
+          PutUint32(ofs, EncodeFloat(field->GetFloatVal()));
+          break;
+        default:
+          for (uint32_t j = 0; j < field->GetLength(); j++) {
+            Put(ofs, field->GetData()[j]);
+            if (field->GetData()[j] == 0) {
+              Put(ofs, ESCAPE);
+            }
+          }
+          Put(ofs, 0);
+          Put(ofs, 0);
+          break;
+      }
+    }
+    return ofs <= KeySize ? ofs : KEY_TOO_LONG;
+  }
+
+  /**
+   * Append row_id to the key encoded in the first key_size bytes, as page id and slot number in big endian, so
+   * the entries of a key in a non-unique index are unique and ordered by row id.
+   *
+   * @return false if the row id does not fit after the key
+   */
+  inline bool AppendRowId(uint32_t key_size, const RowId &row_id) {
+    if (key_size + KEY_ROW_ID_SIZE > KeySize) {
+      return false;
+    }
+    PutUint32(key_size, static_cast<uint32_t>(row_id.GetPageId()));
+    PutUint32(key_size, row_id.GetSlotNum());
+    return true;
+  }
+
+  /**
+   * @return size of the encoding of the first column_count columns of the key
+   */
+  inline uint32_t GetEncodedSize(Schema *schema, uint32_t column_count) const {
+    uint32_t ofs = 0;
+    for (uint32_t i = 0; i < column_count; i++) {
+      if (schema->GetColumn(i)->IsNullable() && data[ofs++] == NULL_MARKER) {
+        continue;
+      }
+      if (schema->GetColumn(i)->GetType() != TypeId::kTypeChar) {
+        ofs += sizeof(uint32_t);
+        continue;
+      }
+      for (; data[ofs] != 0 || data[ofs + 1] != 0; ofs++) {
+        ofs += data[ofs] == 0;
+      }
+      ofs += 2;
+    }
+    return ofs;
   }
 
   inline void DeserializeToKey(Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(data), schema);
-    ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
-    return;
+    std::vector<Field> fields;
+    fields.reserve(schema->GetColumnCount());
+    uint32_t ofs = 0;
+    std::string chars;
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      TypeId type = schema->GetColumn(i)->GetType();
+      if (schema->GetColumn(i)->IsNullable() && data[ofs++] == NULL_MARKER) {
+        fields.emplace_back(type);
+        continue;
+      }
+      switch (type) {
+        case TypeId::kTypeInt:
+          fields.emplace_back(type, static_cast<int32_t>(GetUint32(ofs) ^ SIGN_BIT));
+          break;
+        case TypeId::kTypeFloat:
+          fields.emplace_back(type, DecodeFloat(GetUint32(ofs)));
+          break;
+        default:
+          chars.clear();
+          for (; data[ofs] != 0 || data[ofs + 1] != 0; ofs++) {
+            chars.push_back(data[ofs]);
+            // skip the escape after 0x00
+            ofs += data[ofs] == 0;
+          }
+          ofs += 2;
+          fields.emplace_back(type, chars.data(), static_cast<uint32_t>(chars.size()), true);
+          break;
+      }
+      ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
+    }
+    RowId rid = key.GetRowId();
+    key = Row(fields);
+    key.SetRowId(rid);
+  }
+
+  /**
+   * @return the first 8 bytes of the key as a big endian integer, prefixes order as the keys they come from
+   */
+  inline uint64_t GetPrefix() const {
+    uint64_t prefix = 0;
+    memcpy(&prefix, data, std::min(KeySize, sizeof(prefix)));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    prefix = __builtin_bswap64(prefix);
+#endif
+    return prefix;
   }
 
   // compare
@@ -44,45 +198,80 @@ public:
 
   // actual location of data, extends past the end.
   char data[KeySize];
+
+private:
+  static constexpr char NULL_MARKER = 0x00;
+  static constexpr char VALUE_MARKER = 0x01;
+  static constexpr char ESCAPE = static_cast<char>(0xff);
+  static constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+  // the bytes past KeySize are dropped, ofs still counts them so the size of the whole encoding is known
+  inline void Put(uint32_t &ofs, char c) {
+    if (ofs < KeySize) {
+      data[ofs] = c;
+    }
+    ofs++;
+  }
+
+  inline void PutUint32(uint32_t &ofs, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      Put(ofs, static_cast<char>(value >> shift));
+    }
+  }
+
+  inline uint32_t GetUint32(uint32_t &ofs) const {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < sizeof(uint32_t); i++) {
+      value = value << 8 | static_cast<uint8_t>(data[ofs++]);
+    }
+    return value;
+  }
+
+  static inline uint32_t EncodeFloat(float value) {
+    // -0.0 equals 0.0, so they must encode the same
+    if (value == 0) {
+      value = 0;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+  }
+
+  static inline float DecodeFloat(uint32_t bits) {
+    bits = (bits & SIGN_BIT) ? bits & ~SIGN_BIT : ~bits;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys are memcomparable, see GenericKey, so a comparison is a memcmp over the bytes the key schema can use,
+ * including the row id appended to the keys of a non-unique index.
  */
 template<size_t KeySize>
 class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    return memcmp(lhs.data, rhs.data, size_);
   }
 
-  GenericComparator(const GenericComparator &other) {
-    this->key_schema_ = other.key_schema_;
-  }
+  /**
+   * @return true if the keys fit in their prefixes, comparing prefixes is then comparing keys
+   */
+  inline bool PrefixIsExact() const { return size_ <= sizeof(uint64_t); }
+
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
-  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  GenericComparator(Schema *key_schema, bool unique = true)
+          : size_(std::min<uint32_t>(KeySize, GetMaxEncodedKeySize(key_schema) + (unique ? 0 : KEY_ROW_ID_SIZE))) {}
 
 private:
-  Schema *key_schema_;
+  uint32_t size_;
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
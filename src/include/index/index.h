@@ -1,6 +1,7 @@
 #ifndef MINISQL_INDEX_H
 #define MINISQL_INDEX_H
 
+#include <functional>
 #include <memory>
 
 #include "common/dberr.h"
@@ -9,6 +10,12 @@
 
 class Index {
 public:
+  /**
+   * Called on the entries of a scan with the row id and, if the keys are decoded, the fields of the columns kept in
+   * the index. The scan stops when it returns false.
+   */
+  using ScanCallback = std::function<bool(RowId row_id, const Row *key)>;
+
   explicit Index(index_id_t index_id, IndexSchema *key_schema)
           : index_id_(index_id), key_schema_(key_schema) {}
 
@@ -20,6 +27,36 @@ public:
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn) = 0;
 
+  /**
+   * Insert the keys given by next until it returns false, a key seen before is skipped as InsertEntry would reject
+   * it. Indexes that can be built faster than by inserting the keys one by one override this.
+   *
+   * @param next fills the fields of the next key and its row id
+   * @param fill_factor how full the pages of an index built from scratch are
+   */
+  virtual dberr_t BulkInsert(const std::function<bool(std::vector<Field> &key_fields, RowId &row_id)> &next,
+                             double fill_factor, Transaction *txn) {
+    std::vector<Field> key_fields;
+    RowId row_id;
+    while (next(key_fields, row_id)) {
+      Row key(key_fields);
+      InsertEntry(key, row_id, txn);
+    }
+    return DB_SUCCESS;
+  }
+
+  /**
+   * Call callback on the entries whose keys are between lower and upper in key order. The bounds have the fields of
+   * the key columns, or of their first columns, and a null bound leaves that end open.
+   *
+   * @param decode_keys pass the fields of the entries to callback, otherwise it gets nullptr
+   * @return DB_FAILED if the index does not keep its keys in order
+   */
+  virtual dberr_t ScanRange(const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive,
+                            const ScanCallback &callback, Transaction *txn, bool decode_keys = false) {
+    return DB_FAILED;
+  }
+
   virtual dberr_t Destroy() = 0;
 
 protected:
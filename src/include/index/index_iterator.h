@@ -1,17 +1,44 @@
 #ifndef MINISQL_INDEX_ITERATOR_H
 #define MINISQL_INDEX_ITERATOR_H
 
-#include "page/b_plus_tree_leaf_page.h"
+#include "page/b_plus_tree_page_format.h"
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * Iterator over the leaves of a B+ tree. It holds a pin and a read latch on its current leaf, so the pairs it
+ * points at stay in place, and a copy takes its own. Moving to the next leaf latches it before the current one is
+ * released. A writer merging leaves may hold the next leaf and wait for the current one, so when the next leaf is
+ * busy the iterator releases its leaf and searches the tree again for the pairs after the last key it passed.
+ * The end iterator is past the last pair and holds no latch. A slotted leaf is empty if it could be neither merged
+ * nor given pairs by a sibling, an iterator on it searches again from the low fence of the leaf instead.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using Format = BPlusTreePageFormat<KeyType, ValueType, KeyComparator>;
+  using LeafPage = typename Format::LeafPage;
+
 public:
   // you may define your own constructor based on your member variables
   explicit IndexIterator();
 
-  explicit IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_page, BufferPoolManager *buffer_pool_manager, int index);
+  /**
+   * @param page leaf page pinned and read latched, which the iterator releases, nullptr for the end
+   * @param index position in the leaf, the iterator moves on to the next leaf when it is past the last pair
+   */
+  explicit IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, Page *page,
+                         BufferPoolManager *buffer_pool_manager, int index);
+
+  IndexIterator(const IndexIterator &other);
+
+  IndexIterator(IndexIterator &&other) noexcept;
+
+  IndexIterator &operator=(const IndexIterator &other);
+
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
 
   ~IndexIterator();
 
@@ -28,10 +55,20 @@ public:
   bool operator!=(const IndexIterator &itr) const;
 
 private:
+  /** Unlatch and unpin the current leaf */
+  void Release();
+
+  /** Move on to the next leaf while the index is past the end of the current one */
+  void SkipToValid();
+
   // add your own private member variables here
-  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_;
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_;
+  Page *page_;
+  LeafPage *leaf_;
   BufferPoolManager *buffer_pool_manager_;
   int index_;
+  // the pair pointed at, rebuilt from a slotted leaf
+  MappingType item_;
 };
 
 
@@ -0,0 +1,130 @@
+#ifndef MINISQL_KEY_SEARCH_H
+#define MINISQL_KEY_SEARCH_H
+
+#include <cstdint>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "index/generic_key.h"
+
+/**
+ * Searches over the sorted key & value pairs of a B+ tree page.
+ *
+ * KeyLowerBound returns the first index i in [begin, end) so that array[i].first >= key, KeyUpperBound the first
+ * so that array[i].first > key, end if there is none. Both are binary searches calling the comparator.
+ *
+ * Generic keys are searched on their 8 byte prefixes first, see GenericKey::GetPrefix. A binary search on the
+ * prefixes narrows the range down to a window of PREFIX_WINDOW pairs, whose prefixes are then compared with the
+ * key 4 at a time with AVX2. When the encoded keys fit in the prefix, e.g. single int or float keys, this is the
+ * whole search, otherwise the comparator only runs on the pairs sharing the prefix of the key.
+ */
+template<typename MappingType, typename KeyType, typename KeyComparator>
+inline int KeyLowerBound(const MappingType *array, int begin, int end, const KeyType &key,
+                         const KeyComparator &comparator) {
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    if (comparator(array[mid].first, key) < 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+template<typename MappingType, typename KeyType, typename KeyComparator>
+inline int KeyUpperBound(const MappingType *array, int begin, int end, const KeyType &key,
+                         const KeyComparator &comparator) {
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    if (comparator(array[mid].first, key) <= 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+static constexpr int PREFIX_WINDOW = 16;
+
+/**
+ * @return number of pairs in [array, array + count) whose prefix is < target, or <= target if upper
+ */
+template<bool upper, size_t KeySize, typename ValueType>
+inline int CountPrefixes(const std::pair<GenericKey<KeySize>, ValueType> *array, int count, uint64_t target) {
+  int n = 0, i = 0;
+#if defined(__AVX2__)
+  using Pair = std::pair<GenericKey<KeySize>, ValueType>;
+  static_assert(sizeof(Pair) >= sizeof(uint64_t), "a gathered prefix must not read past its pair");
+  const __m256i index = _mm256_set_epi64x(3 * sizeof(Pair), 2 * sizeof(Pair), sizeof(Pair), 0);
+  // a key shorter than the prefix is followed by its value, clear those bytes
+  const __m256i key_bytes = _mm256_set1_epi64x(
+          static_cast<long long>(KeySize >= sizeof(uint64_t) ? ~0ULL : (1ULL << (8 * KeySize)) - 1));
+  const __m256i big_endian = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                             8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  // flip the sign bits so that the signed compare of AVX2 orders the prefixes as unsigned
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i targets = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(target)), sign);
+  for (; i + 4 <= count; i += 4) {
+    __m256i prefixes = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(array[i].first.data), index, 1);
+    prefixes = _mm256_shuffle_epi8(_mm256_and_si256(prefixes, key_bytes), big_endian);
+    prefixes = _mm256_xor_si256(prefixes, sign);
+    __m256i matches = upper ? _mm256_cmpgt_epi64(prefixes, targets) : _mm256_cmpgt_epi64(targets, prefixes);
+    int bits = _mm256_movemask_pd(_mm256_castsi256_pd(matches));
+    // upper counts the prefixes that are not greater
+    n += upper ? 4 - __builtin_popcount(bits) : __builtin_popcount(bits);
+  }
+#endif
+  for (; i < count; i++) {
+    uint64_t prefix = array[i].first.GetPrefix();
+    n += upper ? prefix <= target : prefix < target;
+  }
+  return n;
+}
+
+template<bool upper, size_t KeySize, typename ValueType>
+inline int PrefixBound(const std::pair<GenericKey<KeySize>, ValueType> *array, int begin, int end, uint64_t target) {
+  while (end - begin > PREFIX_WINDOW) {
+    int mid = begin + (end - begin) / 2;
+    uint64_t prefix = array[mid].first.GetPrefix();
+    if (upper ? prefix <= target : prefix < target) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin + CountPrefixes<upper>(array + begin, end - begin, target);
+}
+
+template<size_t KeySize, typename ValueType>
+inline int KeyLowerBound(const std::pair<GenericKey<KeySize>, ValueType> *array, int begin, int end,
+                         const GenericKey<KeySize> &key, const GenericComparator<KeySize> &comparator) {
+  uint64_t target = key.GetPrefix();
+  int lower = PrefixBound<false>(array, begin, end, target);
+  if (comparator.PrefixIsExact()) {
+    return lower;
+  }
+  // the keys in [lower, upper) share the prefix, the later ones are greater than key
+  int upper = PrefixBound<true>(array, lower, end, target);
+  return KeyLowerBound<std::pair<GenericKey<KeySize>, ValueType>, GenericKey<KeySize>, GenericComparator<KeySize>>(
+          array, lower, upper, key, comparator);
+}
+
+template<size_t KeySize, typename ValueType>
+inline int KeyUpperBound(const std::pair<GenericKey<KeySize>, ValueType> *array, int begin, int end,
+                         const GenericKey<KeySize> &key, const GenericComparator<KeySize> &comparator) {
+  uint64_t target = key.GetPrefix();
+  int upper = PrefixBound<true>(array, begin, end, target);
+  if (comparator.PrefixIsExact()) {
+    return upper;
+  }
+  int lower = PrefixBound<false>(array, begin, upper, target);
+  return KeyUpperBound<std::pair<GenericKey<KeySize>, ValueType>, GenericKey<KeySize>, GenericComparator<KeySize>>(
+          array, lower, upper, key, comparator);
+}
+
+#endif  // MINISQL_KEY_SEARCH_H
@@ -40,6 +40,9 @@ public:
 
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
 
+  // append a child larger than all keys of the page, used by bulk loading, the caller sets the parent of the child
+  void Append(const KeyType &key, const ValueType &value);
+
   void Remove(int index);
 
   ValueType RemoveAndReturnOnlyChild();
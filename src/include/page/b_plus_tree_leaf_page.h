@@ -44,6 +44,9 @@ public:
 
   KeyType KeyAt(int index) const;
 
+  // key separating the page from its left sibling, its first key
+  KeyType LowKey() const;
+
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
 
   const MappingType &GetItem(int index);
@@ -55,6 +58,9 @@ public:
 
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
 
+  // append a pair larger than all keys of the page, used by bulk loading
+  void Append(const KeyType &key, const ValueType &value);
+
   // Split and Merge utility methods
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
 
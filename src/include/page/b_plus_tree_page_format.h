@@ -0,0 +1,41 @@
+#ifndef MINISQL_B_PLUS_TREE_PAGE_FORMAT_H
+#define MINISQL_B_PLUS_TREE_PAGE_FORMAT_H
+
+#include <type_traits>
+
+#include "index/generic_key.h"
+#include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_leaf_page.h"
+#include "page/b_plus_tree_slotted_internal_page.h"
+#include "page/b_plus_tree_slotted_leaf_page.h"
+
+/**
+ * Generic keys at least this wide are kept in slotted pages
+ */
+static constexpr size_t SLOTTED_KEY_SIZE = 32;
+
+/**
+ * Page types of a B+ tree. Keys are kept in arrays of pairs of a fixed size,
+ * except wide generic keys: they are mostly strings much shorter than the key,
+ * so they are kept in slotted pages, without their trailing 0 bytes and their
+ * common prefix, see BPlusTreeSlottedPage.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+struct BPlusTreePageFormat {
+  static constexpr bool SLOTTED = false;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+};
+
+template<size_t KeySize>
+struct BPlusTreePageFormat<GenericKey<KeySize>, RowId, GenericComparator<KeySize>> {
+  static constexpr bool SLOTTED = KeySize >= SLOTTED_KEY_SIZE;
+  using LeafPage = std::conditional_t<SLOTTED,
+          BPlusTreeSlottedLeafPage<GenericKey<KeySize>, RowId, GenericComparator<KeySize>>,
+          BPlusTreeLeafPage<GenericKey<KeySize>, RowId, GenericComparator<KeySize>>>;
+  using InternalPage = std::conditional_t<SLOTTED,
+          BPlusTreeSlottedInternalPage<GenericKey<KeySize>, page_id_t, GenericComparator<KeySize>>,
+          BPlusTreeInternalPage<GenericKey<KeySize>, page_id_t, GenericComparator<KeySize>>>;
+};
+
+#endif  // MINISQL_B_PLUS_TREE_PAGE_FORMAT_H
@@ -0,0 +1,54 @@
+#ifndef MINISQL_B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_H
+#define MINISQL_B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_H
+
+/**
+ * b_plus_tree_slotted_internal_page.h
+ *
+ * Internal page of variable length keys and child page ids, see
+ * BPlusTreeSlottedPage for the page format. As in BPlusTreeInternalPage the
+ * first key is not used, it is not kept and KeyAt(0) returns the low fence of the
+ * page, which is the key separating the page from its left sibling.
+ */
+#include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_slotted_page.h"
+
+#define B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE BPlusTreeSlottedInternalPage<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeSlottedInternalPage : public B_PLUS_TREE_SLOTTED_PAGE_TYPE {
+public:
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+
+  int ValueIndex(const ValueType &value) const;
+
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+
+  // append a child larger than all keys of the page, which must be within its fences
+  void Append(const KeyType &key, const ValueType &value);
+
+  void Remove(int index);
+
+  ValueType RemoveAndReturnOnlyChild();
+
+  // Split and Merge utility methods
+  void MoveHalfTo(BPlusTreeSlottedInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+
+  // true if the children of this page and its right sibling fit in one page
+  bool CanMerge(const BPlusTreeSlottedInternalPage *right, const KeyType &middle_key) const;
+
+  void MoveAllTo(BPlusTreeSlottedInternalPage *recipient, const KeyType &middle_key,
+                 BufferPoolManager *buffer_pool_manager);
+
+  bool Redistribute(BPlusTreeSlottedInternalPage *right, const KeyType &middle_key,
+                    BPlusTreeSlottedInternalPage *parent, int index, BufferPoolManager *buffer_pool_manager);
+
+private:
+  // set this page as the parent of the children in [begin, end)
+  void Adopt(int begin, int end, BufferPoolManager *buffer_pool_manager);
+};
+
+#endif  // MINISQL_B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_H
@@ -0,0 +1,57 @@
+#ifndef MINISQL_B_PLUS_TREE_SLOTTED_LEAF_PAGE_H
+#define MINISQL_B_PLUS_TREE_SLOTTED_LEAF_PAGE_H
+
+/**
+ * b_plus_tree_slotted_leaf_page.h
+ *
+ * Leaf page of variable length keys and their record ids, see
+ * BPlusTreeSlottedPage for the page format. It has the methods of
+ * BPlusTreeLeafPage that the tree uses, split and merge rebuild the pages with
+ * their new fences, and a split separates the pages with the shortest key
+ * between them, so that the internal pages keep short keys.
+ */
+#include "page/b_plus_tree_leaf_page.h"
+#include "page/b_plus_tree_slotted_page.h"
+
+#define B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE BPlusTreeSlottedLeafPage<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeSlottedLeafPage : public B_PLUS_TREE_SLOTTED_PAGE_TYPE {
+  using ParentPage = BPlusTreeSlottedPage<KeyType, page_id_t, KeyComparator>;
+
+public:
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+
+  page_id_t GetNextPageId() const;
+
+  void SetNextPageId(page_id_t next_page_id);
+
+  // key separating the page from its left sibling, its low fence
+  KeyType LowKey() const;
+
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  // the pair is rebuilt from the page, so it is returned by value
+  MappingType GetItem(int index) const;
+
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  bool Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const;
+
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+
+  // append a pair larger than all keys of the page, which must be within its fences
+  void Append(const KeyType &key, const ValueType &value);
+
+  // Split and Merge utility methods
+  void MoveHalfTo(BPlusTreeSlottedLeafPage *recipient);
+
+  // true if the pairs of this page and its right sibling fit in one page
+  bool CanMerge(const BPlusTreeSlottedLeafPage *right) const;
+
+  void MoveAllTo(BPlusTreeSlottedLeafPage *recipient);
+
+  bool Redistribute(BPlusTreeSlottedLeafPage *right, ParentPage *parent, int index);
+};
+
+#endif  // MINISQL_B_PLUS_TREE_SLOTTED_LEAF_PAGE_H
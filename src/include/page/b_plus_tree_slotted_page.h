@@ -0,0 +1,195 @@
+#ifndef MINISQL_B_PLUS_TREE_SLOTTED_PAGE_H
+#define MINISQL_B_PLUS_TREE_SLOTTED_PAGE_H
+
+/**
+ * b_plus_tree_slotted_page.h
+ *
+ * Slotted B+ tree page for variable length keys, both slotted leaf and internal
+ * page are inherited from this page. Keys are GenericKey, which are memcomparable
+ * and filled with 0 after their encoding, so a key is stored without its trailing
+ * 0 bytes and keys are compared with memcmp over all their bytes.
+ *
+ * Every node has fence keys, low <= K < high for all keys K that belong to the
+ * node, unbounded for the first and the last node of a level. All these keys
+ * share the common prefix of the fences, which is kept once in the low fence,
+ * and an entry only stores the rest of its key. The prefix depends on the fences
+ * only, so inserts and removes never change it, splits, merges and
+ * redistributions rebuild the pages with their new fences.
+ *
+ * Entries are found through slots kept in key order after the header, their
+ * suffixes and values are in a heap growing down from the end of the page. A slot
+ * holds the first 4 bytes of the suffix in big endian, a search compares them
+ * first and reads the heap only when they are equal. A removed entry leaves a hole
+ * in the heap, the heap is compacted when an insert does not fit in the free
+ * space between the slots and the heap.
+ *
+ * Page format (keys are stored in order):
+ *  ---------------------------------------------------------------------------
+ * | HEADER | LowFence | HighFence | SLOT(1) | ... | SLOT(n) | FREE | ... | SUFFIX(1) + VALUE(1) |
+ *  ---------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes in total, followed by the fences of KeySize each):
+ *  ---------------------------------------------------------------------------
+ * | BPlusTreePage (24) | NextPageId (4) | HeapBegin (2) | DeadBytes (2) |
+ *  ---------------------------------------------------------------------------
+ * | PrefixLength (2) | FenceFlags (2) |
+ *  ---------------------------------------------------------------------------
+ *
+ *  Slot format (size in byte, 8 bytes in total):
+ *  ---------------------------------------
+ * | Offset (2) | Length (2) | Head (4) |
+ *  ---------------------------------------
+ *
+ * Sizes are in bytes: a node overflows once an entry of the longest key may not
+ * fit anymore, and underflows when it uses less than a quarter of its capacity.
+ * The max size in the header is not used.
+ */
+#include <utility>
+#include <vector>
+
+#include "page/b_plus_tree_page.h"
+
+#define B_PLUS_TREE_SLOTTED_PAGE_TYPE BPlusTreeSlottedPage<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeSlottedPage : public BPlusTreePage {
+public:
+  static constexpr uint32_t KEY_SIZE = sizeof(KeyType);
+  static constexpr uint32_t SLOT_SIZE = 8;
+  static constexpr uint32_t HEADER_SIZE = sizeof(BPlusTreePage) + 12 + 2 * KEY_SIZE;
+  static constexpr uint32_t CAPACITY = PAGE_SIZE - HEADER_SIZE;
+  // bytes taken by an entry of the longest key
+  static constexpr uint32_t MAX_ENTRY_SIZE = SLOT_SIZE + KEY_SIZE + sizeof(ValueType);
+
+  /**
+   * A fence key, not bounded below the first and above the last node of a level
+   */
+  struct Fence {
+    bool bounded_;
+    KeyType key_;
+
+    const KeyType *Get() const { return bounded_ ? &key_ : nullptr; }
+  };
+
+  KeyType KeyAt(int index) const;
+
+  ValueType ValueAt(int index) const;
+
+  void SetValueAt(int index, const ValueType &value);
+
+  Fence GetLowFence() const;
+
+  Fence GetHighFence() const;
+
+  uint32_t GetPrefixLength() const { return prefix_length_; }
+
+  // bytes of the slots and heap taken by the entries
+  uint32_t GetUsedBytes() const;
+
+  uint32_t GetFreeBytes() const { return CAPACITY - GetUsedBytes(); }
+
+  bool IsOverflow() const { return GetFreeBytes() < MAX_ENTRY_SIZE; }
+
+  bool IsUnderflow() const { return GetUsedBytes() < CAPACITY / 4; }
+
+  // true if inserting any entry does not overflow the page
+  bool IsInsertSafe() const { return GetFreeBytes() >= 2 * MAX_ENTRY_SIZE; }
+
+  // true if removing any entry does not underflow the page
+  bool IsRemoveSafe() const { return GetUsedBytes() >= CAPACITY / 4 + MAX_ENTRY_SIZE; }
+
+  // bytes the entries would take with a shorter prefix
+  uint32_t GetBytesWithPrefix(uint32_t prefix_length) const;
+
+  // first index i >= begin so that KeyAt(i) >= key
+  int LowerBound(const KeyType &key, int begin) const { return Search<false>(key, begin); }
+
+  // first index i >= begin so that KeyAt(i) > key
+  int UpperBound(const KeyType &key, int begin) const { return Search<true>(key, begin); }
+
+  // insert an entry at index, the key must be within the fences
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+
+  void RemoveAt(int index);
+
+  // true if key can replace the key at index without overflowing the page
+  bool CanSetKeyAt(int index, const KeyType &key) const;
+
+  void SetKeyAt(int index, const KeyType &key);
+
+  // append all entries of the page to entries
+  void GetEntries(std::vector<MappingType> &entries) const;
+
+  // replace the entries and fences of the page, nullptr for an unbounded fence
+  void Rebuild(const MappingType *entries, int count, const KeyType *low, const KeyType *high);
+
+  // length of the common prefix of the fences, the prefix of the keys of a node
+  static uint32_t PrefixLength(const KeyType *low, const KeyType *high);
+
+  // bytes a key takes after the prefix
+  static uint32_t KeyBytes(const KeyType &key, uint32_t prefix_length);
+
+  // bytes entries take in a page with the prefix, the first key is not kept by an internal page
+  static uint32_t EntriesBytes(const MappingType *entries, int count, uint32_t prefix_length, bool leaf);
+
+  // true if entries of bytes fit in a page that does not overflow
+  static bool Fits(uint32_t bytes) { return bytes + MAX_ENTRY_SIZE <= CAPACITY; }
+
+  // index splitting entries into two nodes of about the same bytes, in [1, count - 1]
+  static int SplitPoint(const MappingType *entries, int count, uint32_t prefix_length, bool leaf);
+
+  // shortest key separating left < right, the prefix of right up to the first byte they differ in
+  static KeyType Separator(const KeyType &left, const KeyType &right);
+
+  // bytes of the fill_factor of a page for bulk loading, at least a few entries and at most a page
+  static uint32_t FillBytes(double fill_factor);
+
+protected:
+  void Init(IndexPageType page_type, page_id_t page_id, page_id_t parent_id, int max_size);
+
+  // used by leaf pages only
+  page_id_t next_page_id_;
+
+private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    uint32_t head_;
+  };
+
+  static constexpr uint16_t LOW_BOUNDED = 1;
+  static constexpr uint16_t HIGH_BOUNDED = 2;
+
+  template<bool upper>
+  int Search(const KeyType &key, int begin) const;
+
+  // compare the key with the suffix of the entry at index
+  int CompareAt(const char *suffix, uint32_t length, uint32_t head, int index) const;
+
+  // true if the key of the entry at index is kept, the first key of an internal page is not
+  bool HasKey(int index) const { return IsLeafPage() || index > 0; }
+
+  void SetFences(const KeyType *low, const KeyType *high);
+
+  void Compact();
+
+  const char *Data() const { return reinterpret_cast<const char *>(this); }
+
+  char *Data() { return reinterpret_cast<char *>(this); }
+
+  // bytes of data without its trailing 0 bytes
+  static uint32_t TrimmedLength(const char *data, uint32_t size);
+
+  // first 4 bytes of suffix in big endian, filled with 0
+  static uint32_t Head(const char *suffix, uint32_t length);
+
+  uint16_t heap_begin_;
+  uint16_t dead_bytes_;
+  uint16_t prefix_length_;
+  uint16_t fence_flags_;
+  char low_fence_[KEY_SIZE];
+  char high_fence_[KEY_SIZE];
+  Slot slots_[0];
+};
+
+#endif  // MINISQL_B_PLUS_TREE_SLOTTED_PAGE_H
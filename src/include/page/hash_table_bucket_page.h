@@ -0,0 +1,51 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+/**
+ * hash_table_bucket_page.h
+ *
+ * Bucket of an extendible hash index, the pairs of key and record id whose
+ * hashes share the low local depth bits of the bucket, in no order. A bucket
+ * whose keys cannot be told apart by more hash bits, such as the duplicates of
+ * a key in a non-unique index, continues in a chain of overflow pages.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------
+ * | CurrentSize (4) | NextPageId (4) | KEY(1) + RID(1) | ... | KEY(n) + RID(n)
+ *  ----------------------------------------------------------------------
+ */
+#include "page/b_plus_tree_page.h"
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType>
+#define BUCKET_PAGE_HEADER_SIZE 8
+#define BUCKET_ARRAY_SIZE ((PAGE_SIZE - BUCKET_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+template<typename KeyType, typename ValueType>
+class HashTableBucketPage {
+public:
+  // an empty bucket with no overflow page
+  void Init();
+
+  int GetSize() const { return size_; }
+
+  bool IsFull() const { return size_ == static_cast<int>(BUCKET_ARRAY_SIZE); }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  const MappingType &GetItem(int index) const { return array_[index]; }
+
+  // add a pair to a bucket that is not full
+  void Append(const KeyType &key, const ValueType &value);
+
+  // remove the pair at index, the last pair takes its place
+  void RemoveAt(int index);
+
+private:
+  int size_;
+  page_id_t next_page_id_;
+  MappingType array_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
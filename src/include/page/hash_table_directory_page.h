@@ -0,0 +1,72 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+/**
+ * hash_table_directory_page.h
+ *
+ * Directory of an extendible hash index. The low global depth bits of the hash
+ * of a key index the directory, every slot holds the page id of a bucket and
+ * its local depth: the number of low bits the keys of the bucket share. A
+ * bucket of local depth d is shared by the 2^(global depth - d) slots that
+ * agree on their low d bits.
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------------------------------------
+ * | PageId (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) |
+ *  ---------------------------------------------------------------------------
+ */
+#include <cstdint>
+
+#include "common/config.h"
+
+static constexpr uint32_t DIRECTORY_MAX_DEPTH = 9;
+static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 1u << DIRECTORY_MAX_DEPTH;
+
+class HashTableDirectoryPage {
+public:
+  // a directory of global depth 0, its only slot points to bucket_page_id
+  void Init(page_id_t page_id, page_id_t bucket_page_id);
+
+  page_id_t GetPageId() const { return page_id_; }
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  // mask of the low global depth bits of a hash
+  uint32_t GetGlobalDepthMask() const { return (1u << global_depth_) - 1; }
+
+  // number of slots in use
+  uint32_t Size() const { return 1u << global_depth_; }
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) { bucket_page_ids_[bucket_idx] = bucket_page_id; }
+
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+    local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+  }
+
+  // the slot of the bucket that bucket_idx was split from or would merge with
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+  bool CanGrow() const { return global_depth_ < DIRECTORY_MAX_DEPTH; }
+
+  // double the directory, the new slots point to the buckets of the old slots with the same low bits
+  void IncrGlobalDepth();
+
+  // true if no bucket uses all global depth bits, so the directory can be halved
+  bool CanShrink() const;
+
+  void DecrGlobalDepth();
+
+private:
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "The directory does not fit in a page.");
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
@@ -0,0 +1,43 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+/**
+ * Overflow page format, a long char value is split over a chain of overflow pages:
+ *  -------------------------------------------------
+ *  | NextPageId (4) | DataSize (4) | Data ...      |
+ *  -------------------------------------------------
+ *  NextPageId is INVALID_PAGE_ID for the last page of a chain.
+ **/
+
+#include <cstring>
+#include "common/config.h"
+#include "page/page.h"
+
+class OverflowPage : public Page {
+public:
+  void Init() {
+    SetNextPageId(INVALID_PAGE_ID);
+    SetDataSize(0);
+  }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetDataSize() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_DATA_SIZE); }
+
+  void SetDataSize(uint32_t data_size) { memcpy(GetData() + OFFSET_DATA_SIZE, &data_size, sizeof(uint32_t)); }
+
+  char *GetPayload() { return GetData() + SIZE_OVERFLOW_PAGE_HEADER; }
+
+  static constexpr uint32_t SIZE_OVERFLOW_PAGE_HEADER = 8;
+  static constexpr uint32_t MAX_DATA_SIZE = PAGE_SIZE - SIZE_OVERFLOW_PAGE_HEADER;
+
+private:
+  static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 0;
+  static constexpr size_t OFFSET_DATA_SIZE = 4;
+};
+
+#endif  // MINISQL_OVERFLOW_PAGE_H
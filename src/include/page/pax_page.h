@@ -0,0 +1,191 @@
+#ifndef MINISQL_PAX_PAGE_H
+#define MINISQL_PAX_PAGE_H
+/**
+ * PAX (Partition Attributes Across) page format, the values of one column are kept together in a minipage:
+ *  -------------------------------------------------------------------------------------
+ *  | HEADER | Minipage of column 0 | Minipage of column 1 | ... | Minipage of column n |
+ *  -------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes):
+ *  -----------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| TupleCount (4) | Capacity (4) |
+ *  -----------------------------------------------------------------------------------------------
+ *  | UsedSlotBitmap (capacity bits) | LiveSlotBitmap (capacity bits) |
+ *  -----------------------------------------------------------------------------------------------
+ *
+ *  Minipage format:
+ *  -----------------------------------------------------------------
+ *  | NullBitmap (capacity bits) | Value_1 | Value_2 | ... | Value_capacity |
+ *  -----------------------------------------------------------------
+ *  int and float values take 4 bytes, a char(n) value takes a 4 bytes length followed by n bytes, so the
+ *  value of slot i is always at a fixed position and a filter over one column is a loop over one array.
+ *
+ *  A slot is used if it holds a tuple (maybe marked deleted) and live if the tuple is not marked deleted.
+ *  TupleCount is the high-water mark of used slot numbers. The capacity and every minipage offset only
+ *  depend on the schema, they are computed once into a PaxLayout and passed to the operations reading or
+ *  writing values. The capacity is also kept in the header so that the slot bitmaps can be found without it.
+ **/
+
+#include <cstring>
+#include <vector>
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+
+/**
+ * Positions of the minipages in a PAX page of a given schema.
+ */
+class PaxLayout {
+public:
+  explicit PaxLayout(const Schema *schema);
+
+  /**
+   * @return max number of tuples in one page, 0 if a single tuple of the schema does not fit in a page
+   */
+  inline uint32_t GetCapacity() const { return capacity_; }
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  inline TypeId GetColumnType(uint32_t column_index) const { return columns_[column_index].type_; }
+
+  /**
+   * @return bytes between the values of two adjacent slots in the column minipage
+   */
+  inline uint32_t GetValueWidth(uint32_t column_index) const { return columns_[column_index].width_; }
+
+  inline uint32_t GetNullBitmapOffset(uint32_t column_index) const { return columns_[column_index].null_offset_; }
+
+  inline uint32_t GetValueOffset(uint32_t column_index) const { return columns_[column_index].value_offset_; }
+
+  /**
+   * @return true if every field of the row fits into its fixed size value
+   */
+  bool CheckRow(const Row &row) const;
+
+  static constexpr uint32_t SIZE_PAX_PAGE_HEADER = 24;
+  static constexpr uint32_t OFFSET_USED_BITMAP = SIZE_PAX_PAGE_HEADER;
+
+  static inline uint32_t GetBitmapSize(uint32_t capacity) {
+    return (capacity + 63) / 64 * sizeof(uint64_t);
+  }
+
+private:
+  /**
+   * @return size of a page holding capacity tuples, minipages are placed from the offset returned
+   */
+  uint32_t ComputeLayout(uint32_t capacity);
+
+  struct ColumnLayout {
+    TypeId type_;
+    uint32_t max_len_;       // for char type this is the max length of the string data, otherwise 0
+    uint32_t width_;
+    uint32_t null_offset_;
+    uint32_t value_offset_;
+  };
+  std::vector<ColumnLayout> columns_;
+  uint32_t capacity_{0};
+};
+
+class PaxPage : public Page {
+public:
+  void Init(page_id_t page_id, page_id_t prev_id, const PaxLayout &layout, LogManager *log_mgr, Transaction *txn);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  bool InsertTuple(Row &row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager,
+                   LogManager *log_manager);
+
+  bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Values have fixed size, so an update is always done in place.
+   * @return 0-fail;1-success, same as TablePage::UpdateTuple
+   */
+  int UpdateTuple(const Row &new_row, Row *old_row, const PaxLayout &layout,
+                  Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  void RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  bool GetTuple(Row *row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager);
+
+  bool GetFirstTupleRid(RowId *first_rid);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+
+  /**
+   * Column access for scans, slot i of the minipage is valid iff bit i of the live bitmap is set.
+   */
+  inline const uint64_t *GetLiveBitmap() { return GetMutableLiveBitmap(); }
+
+  inline const uint64_t *GetNullBitmap(const PaxLayout &layout, uint32_t column_index) {
+    return GetBitmap(layout.GetNullBitmapOffset(column_index));
+  }
+
+  inline const char *GetValues(const PaxLayout &layout, uint32_t column_index) {
+    return GetData() + layout.GetValueOffset(column_index);
+  }
+
+private:
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  uint32_t GetCapacity() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  void SetCapacity(uint32_t capacity) { memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t)); }
+
+  inline uint64_t *GetBitmap(uint32_t offset) { return reinterpret_cast<uint64_t *>(GetData() + offset); }
+
+  inline uint64_t *GetUsedBitmap() { return GetBitmap(PaxLayout::OFFSET_USED_BITMAP); }
+
+  inline uint64_t *GetMutableLiveBitmap() {
+    return GetBitmap(PaxLayout::OFFSET_USED_BITMAP + PaxLayout::GetBitmapSize(GetCapacity()));
+  }
+
+  static inline bool TestBit(const uint64_t *bitmap, uint32_t i) { return (bitmap[i / 64] >> (i % 64)) & 1; }
+
+  static inline void SetBit(uint64_t *bitmap, uint32_t i, bool value) {
+    if (value) {
+      bitmap[i / 64] |= 1ULL << (i % 64);
+    } else {
+      bitmap[i / 64] &= ~(1ULL << (i % 64));
+    }
+  }
+
+  /**
+   * @return the first slot in [start_slot, end_slot) whose bit equals value, or end_slot if there is none
+   */
+  static uint32_t FindBit(const uint64_t *bitmap, uint32_t start_slot, uint32_t end_slot, bool value);
+
+  /**
+   * Write all fields of the row into the minipages of the slot
+   */
+  void WriteTuple(const Row &row, const PaxLayout &layout, uint32_t slot_num);
+
+private:
+  static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 16;
+  static constexpr size_t OFFSET_CAPACITY = 20;
+};
+
+#endif  // MINISQL_PAX_PAGE_H
@@ -12,9 +12,30 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------
+ *  | TupleCount (4) | LiveSlotBitmap (32) | FreeSlotBitmap (32) | FragmentedBytes (4) |
+ *  ---------------------------------------------------------------------------------------
+ *  ------------------------------------------------------
+ *  | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ------------------------------------------------------
+ *
+ *  Slot state bitmaps (one bit per slot, MAX_SLOT_NUM slots at most):
+ *  - LiveSlotBitmap: the slot holds a tuple which is not marked deleted, used by the iterator to skip holes.
+ *  - FreeSlotBitmap: the slot is empty (size 0) and can be reused by the next insert.
+ *  Both are scanned a 64-bit word at a time, so finding a free slot or the next live slot does not
+ *  touch the slot array at all.
+ *
+ *  Deleting or shrinking a tuple does not move the other tuples. The bytes it gives up stay where they are
+ *  and are only counted in FragmentedBytes; the tuple region is compacted once, when an insert or update
+ *  needs more contiguous space than the gap between the slot array and the free space pointer.
+
+ *
+ *  Tuple size flags:
+ *  - DELETE_MASK: the tuple is marked deleted.
+ *  - FORWARD_MASK: the tuple grew out of its page and was moved, the slot owns no bytes. Its offset holds
+ *    the page id and its size the slot number of the moved tuple, so the RowId of the tuple never changes.
+ *  - MOVED_MASK: the tuple was moved here and is only reached through its forwarding slot, its live bit
+ *    is never set so that scans do not see it twice.
  **/
 
 #include <cstring>
@@ -58,6 +79,28 @@ public:
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read the tuple of a slot whether or not it is marked deleted
+   * @return false if the slot is empty
+   */
+  bool ReadTuple(Row *row, Schema *schema);
+
+  /**
+   * @param include_deleted also follow a forwarding slot marked deleted
+   * @return true if the slot forwards to a moved tuple, whose RowId is written to target
+   */
+  bool GetForwardRid(const RowId &rid, RowId *target, bool include_deleted = false);
+
+  /**
+   * Turn the slot into a forwarding slot, the bytes of its tuple are given up.
+   */
+  void SetForwardRid(const RowId &rid, const RowId &target);
+
+  /**
+   * Mark a tuple as reached through a forwarding slot only
+   */
+  void MarkMoved(const RowId &rid);
+
   bool GetFirstTupleRid(RowId *first_rid);
 
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
@@ -73,10 +116,36 @@ private:
 
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
+  uint32_t GetFragmentedBytes() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FRAGMENTED_BYTES); }
+
+  void SetFragmentedBytes(uint32_t fragmented_bytes) {
+    memcpy(GetData() + OFFSET_FRAGMENTED_BYTES, &fragmented_bytes, sizeof(uint32_t));
+  }
+
+  /**
+   * Contiguous free space between the slot array and the free space pointer.
+   */
   uint32_t GetFreeSpaceRemaining() {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
   }
 
+  /**
+   * Make sure there are at least `size` contiguous free bytes, compacting the page if the fragmented
+   * space makes up for the difference.
+   * @return false if the page can not hold `size` bytes even after compaction
+   */
+  bool ReserveSpace(uint32_t size);
+
+  /**
+   * Move all tuples to the end of the page so that fragmented space becomes contiguous free space.
+   */
+  void Compact();
+
+  /**
+   * Give up the bytes of the tuple in the slot, the slot itself is left untouched.
+   */
+  void ReleaseTupleSpace(uint32_t slot_num);
+
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
   }
@@ -93,25 +162,62 @@ private:
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
+  uint64_t *GetSlotBitmap(size_t bitmap_offset) { return reinterpret_cast<uint64_t *>(GetData() + bitmap_offset); }
+
+  void SetSlotBit(size_t bitmap_offset, uint32_t slot_num, bool value) {
+    uint64_t *words = GetSlotBitmap(bitmap_offset);
+    uint64_t mask = 1ULL << (slot_num % SLOT_BITMAP_WORD_BITS);
+    if (value) {
+      words[slot_num / SLOT_BITMAP_WORD_BITS] |= mask;
+    } else {
+      words[slot_num / SLOT_BITMAP_WORD_BITS] &= ~mask;
+    }
+  }
+
+  /**
+   * Find the first set bit in the bitmap whose slot number is not less than start_slot.
+   * @return the slot number, or MAX_SLOT_NUM if there is none
+   */
+  uint32_t FindSlotBit(size_t bitmap_offset, uint32_t start_slot);
+
   static bool IsDeleted(uint32_t tuple_size) { return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0; }
 
   static uint32_t SetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size | DELETE_MASK); }
 
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
 
+  static bool IsForwarded(uint32_t tuple_size) { return static_cast<bool>(tuple_size & FORWARD_MASK); }
+
+  /**
+   * @return bytes owned by the slot in the tuple region
+   */
+  static uint32_t GetTupleBytes(uint32_t tuple_size) {
+    return IsForwarded(tuple_size) ? 0 : static_cast<uint32_t>(tuple_size & ~(DELETE_MASK | MOVED_MASK));
+  }
+
 private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
+  static constexpr uint64_t FORWARD_MASK = (1U << (8 * sizeof(uint32_t) - 2));
+  static constexpr uint64_t MOVED_MASK = (1U << (8 * sizeof(uint32_t) - 3));
+  static constexpr uint32_t FORWARD_SLOT_MASK = MOVED_MASK - 1;
+  static constexpr uint32_t SLOT_BITMAP_WORD_BITS = 64;
+  static constexpr uint32_t SLOT_BITMAP_WORDS = 4;
+  static constexpr size_t SIZE_SLOT_BITMAP = SLOT_BITMAP_WORDS * sizeof(uint64_t);
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 28 + 2 * SIZE_SLOT_BITMAP;
   static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_LIVE_BITMAP = 24;
+  static constexpr size_t OFFSET_FREE_BITMAP = OFFSET_LIVE_BITMAP + SIZE_SLOT_BITMAP;
+  static constexpr size_t OFFSET_FRAGMENTED_BYTES = OFFSET_FREE_BITMAP + SIZE_SLOT_BITMAP;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = SIZE_TABLE_PAGE_HEADER;
+  static constexpr size_t OFFSET_TUPLE_SIZE = SIZE_TABLE_PAGE_HEADER + 4;
 
 public:
+  static constexpr uint32_t MAX_SLOT_NUM = SLOT_BITMAP_WORDS * SLOT_BITMAP_WORD_BITS;
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
 };
 
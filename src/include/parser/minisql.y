@@ -27,7 +27,7 @@
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_analyze table_sample index_include
 
 %%
 
@@ -58,6 +58,7 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_analyze { $$ = $1; }
   ;
 
 sql_create_database:
@@ -101,6 +102,16 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode layout_node = CreateSyntaxNode(kNodeTableLayout, "table layout");
+    SyntaxNodeAddChildren(layout_node, $8);
+    SyntaxNodeAddChildren($$, layout_node);
+  }
   ;
 
 column_list:
@@ -138,6 +149,14 @@ column_definition:
     SyntaxNodeAddChildren($$, $1);
     SyntaxNodeAddChildren($$, $2);
   }
+  | IDENTIFIER column_type IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeColumnDefinition, NULL);
+    SyntaxNodeAddChildren($$, $1);
+    SyntaxNodeAddChildren($$, $2);
+    pSyntaxNode encoding_node = CreateSyntaxNode(kNodeColumnEncoding, "column encoding");
+    SyntaxNodeAddChildren(encoding_node, $3);
+    SyntaxNodeAddChildren($$, encoding_node);
+  }
   ;
 
 column_type:
@@ -180,6 +199,34 @@ sql_create_index:
       SyntaxNodeAddChildren(index_type_node, $10);
       SyntaxNodeAddChildren($$, index_type_node);
   }
+  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' index_include {
+    $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $5);
+    pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
+    SyntaxNodeAddChildren(index_keys_node, $7);
+    SyntaxNodeAddChildren($$, index_keys_node);
+    SyntaxNodeAddChildren($$, $9);
+  }
+  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' USING IDENTIFIER index_include {
+      $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
+      SyntaxNodeAddChildren($$, $3);
+      SyntaxNodeAddChildren($$, $5);
+      pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
+      SyntaxNodeAddChildren(index_keys_node, $7);
+      SyntaxNodeAddChildren($$, index_keys_node);
+      pSyntaxNode index_type_node = CreateSyntaxNode(kNodeIndexType, "index type");
+      SyntaxNodeAddChildren(index_type_node, $10);
+      SyntaxNodeAddChildren($$, index_type_node);
+      SyntaxNodeAddChildren($$, $11);
+  }
+  ;
+
+index_include:
+  IDENTIFIER '(' column_list ')' {
+    $$ = CreateSyntaxNode(kNodeColumnList, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+  }
   ;
 
 sql_drop_index:
@@ -209,6 +256,36 @@ sql_select:
     SyntaxNodeAddChildren(condition_node, $6);
     SyntaxNodeAddChildren($$, condition_node);
   }
+  | SELECT select_columns FROM IDENTIFIER table_sample {
+    $$ = CreateSyntaxNode(kNodeSelect, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  | SELECT select_columns FROM IDENTIFIER table_sample WHERE where_conditions {
+    $$ = CreateSyntaxNode(kNodeSelect, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($$, $5);
+    pSyntaxNode condition_node = CreateSyntaxNode(kNodeConditions, NULL);
+    SyntaxNodeAddChildren(condition_node, $7);
+    SyntaxNodeAddChildren($$, condition_node);
+  }
+  ;
+
+table_sample:
+  IDENTIFIER IDENTIFIER '(' NUMBER ')' {
+    $$ = CreateSyntaxNode(kNodeTableSample, $1->val_);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  | IDENTIFIER IDENTIFIER '(' NUMBER ')' IDENTIFIER '(' NUMBER ')' {
+    $$ = CreateSyntaxNode(kNodeTableSample, $1->val_);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+    SyntaxNodeAddChildren($6, $8);
+    SyntaxNodeAddChildren($$, $6);
+  }
   ;
 
 select_columns:
@@ -393,6 +470,18 @@ sql_exec_file:
   }
   ;
 
+sql_analyze:
+  IDENTIFIER TABLE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeAnalyze, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  | IDENTIFIER TABLE IDENTIFIER table_sample {
+    $$ = CreateSyntaxNode(kNodeAnalyze, $1->val_);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
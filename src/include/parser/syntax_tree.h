@@ -43,7 +43,11 @@ typedef enum {
   kNodeIndexType, /** type of index */
   kNodeTrxBegin, /** begin transaction command */
   kNodeTrxCommit, /** commit transaction command */
-  kNodeTrxRollback /** rollback transaction command */
+  kNodeTrxRollback, /** rollback transaction command */
+  kNodeTableLayout, /** page layout of table, eg: row, pax */
+  kNodeColumnEncoding, /** storage encoding of a column, eg: dictionary */
+  kNodeAnalyze, /** analyze table command */
+  kNodeTableSample /** tablesample clause, eg: tablesample system(10) repeatable(42) */
 } SyntaxNodeType;
 
 /**
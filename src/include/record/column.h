@@ -16,7 +16,7 @@ public:
 
   Column(const Column *other);
 
-  std::string GetName() const { return name_; }
+  const std::string &GetName() const { return name_; }
 
   uint32_t GetLength() const { return len_; }
 
@@ -30,6 +30,13 @@ public:
 
   TypeId GetType() const { return type_; }
 
+  /**
+   * Values of a dictionary encoded char column are stored in the table as codes, see TableDictionary
+   */
+  bool IsDictEncoded() const { return dict_encoded_; }
+
+  void SetDictEncoded(bool dict_encoded) { dict_encoded_ = dict_encoded; }
+
   uint32_t SerializeTo(char *buf) const;
 
   uint32_t GetSerializedSize() const;
@@ -45,6 +52,7 @@ private:
   uint32_t table_ind_{0}; // column position in table
   bool nullable_{false};  // whether the column can be null
   bool unique_{false};    // whether the column is unique
+  bool dict_encoded_{false};  // whether the values are stored as dictionary codes
 };
 
 #endif //MINISQL_COLUMN_H
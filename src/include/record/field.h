@@ -17,6 +17,9 @@ class Field {
 
   friend class TypeFloat;
 
+  template<TypeId type>
+  friend struct FieldKernel;
+
 public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
@@ -74,12 +77,25 @@ public:
     }
   }
 
+  // move constructor, the new field takes over the char data
+  Field(Field &&other) noexcept
+          : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+            manage_data_(other.manage_data_) {
+    other.manage_data_ = false;
+  }
+
   // copy
   Field &operator=(Field &other) {
     Swap(*this, other);
     return *this;
   }
 
+  // move, the old value of this field is released by other
+  Field &operator=(Field &&other) noexcept {
+    Swap(*this, other);
+    return *this;
+  }
+
   inline bool IsNull() const {
     return is_null_;
   }
@@ -100,6 +116,23 @@ public:
     return Type::GetInstance(type_id)->DeserializeFrom(buf, field, is_null, heap);
   }
 
+  /**
+   * Deserialize a value in place, without allocating the field from a heap. Char data is still copied.
+   */
+  inline static Field ReadFrom(const char *buf, const TypeId type_id, bool is_null) {
+    if (is_null) {
+      return Field(type_id);
+    }
+    switch (type_id) {
+      case TypeId::kTypeInt:
+        return Field(type_id, MACH_READ_FROM(int32_t, buf));
+      case TypeId::kTypeFloat:
+        return Field(type_id, MACH_READ_FROM(float, buf));
+      default:
+        return Field(type_id, const_cast<char *>(buf) + sizeof(uint32_t), MACH_READ_UINT32(buf), true);
+    }
+  }
+
   inline uint32_t GetSerializedSize() const {
     return Type::GetInstance(type_id_)->GetSerializedSize(*this, is_null_);
   }
@@ -138,11 +171,11 @@ public:
     std::swap(first.manage_data_, second.manage_data_);
   }
 
-  int32_t GetIntVal() { return value_.integer_; }
-  float GetFloatVal() { return value_.float_; }
+  int32_t GetIntVal() const { return value_.integer_; }
+  float GetFloatVal() const { return value_.float_; }
   char *GetCharVal() { return value_.chars_; }
 
-  TypeId GetType() { return type_id_; }
+  TypeId GetType() const { return type_id_; }
 
 protected:
   union Val {
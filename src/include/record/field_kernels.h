@@ -0,0 +1,149 @@
+#ifndef MINISQL_FIELD_KERNELS_H
+#define MINISQL_FIELD_KERNELS_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "record/field.h"
+#include "utils/hyper_log_log.h"
+
+/**
+ * Comparison and hash kernels specialized per type. Field::CompareXXX looks the type up and makes a virtual
+ * call for every comparison, hot paths instead pick a kernel once per query or index and call it directly.
+ * The kernels expect non-null values of the type they are specialized for.
+ */
+template<TypeId type>
+struct FieldKernel;
+
+template<>
+struct FieldKernel<TypeId::kTypeInt> {
+  static inline int Compare(const Field &left, const Field &right) {
+    return CompareRaw(left.value_.integer_, right.value_.integer_);
+  }
+
+  static inline int CompareRaw(int32_t left, int32_t right) { return (left > right) - (left < right); }
+
+  static inline uint64_t Hash(const Field &value) {
+    return HyperLogLog::Hash(reinterpret_cast<const char *>(&value.value_.integer_), sizeof(int32_t));
+  }
+};
+
+template<>
+struct FieldKernel<TypeId::kTypeFloat> {
+  static inline int Compare(const Field &left, const Field &right) {
+    return CompareRaw(left.value_.float_, right.value_.float_);
+  }
+
+  static inline int CompareRaw(float left, float right) { return (left > right) - (left < right); }
+
+  static inline uint64_t Hash(const Field &value) {
+    // -0.0 equals 0.0, so they must hash the same
+    float f = value.value_.float_ == 0 ? 0.0f : value.value_.float_;
+    return HyperLogLog::Hash(reinterpret_cast<const char *>(&f), sizeof(float));
+  }
+};
+
+template<>
+struct FieldKernel<TypeId::kTypeChar> {
+  static inline int Compare(const Field &left, const Field &right) {
+    return CompareRaw(left.value_.chars_, left.len_, right.value_.chars_, right.len_);
+  }
+
+  static inline int CompareRaw(const char *left, uint32_t left_len, const char *right, uint32_t right_len) {
+    int ret = memcmp(left, right, std::min(left_len, right_len));
+    if (ret != 0) {
+      return ret;
+    }
+    return (left_len > right_len) - (left_len < right_len);
+  }
+
+  static inline uint64_t Hash(const Field &value) { return HyperLogLog::Hash(value.value_.chars_, value.len_); }
+};
+
+/**
+ * Comparison operators of a predicate, in the order the executor numbers them
+ */
+enum class CompareOp { kEquals, kNotEquals, kLessThan, kGreaterThan, kLessThanEquals, kGreaterThanEquals };
+
+template<TypeId type, CompareOp op>
+inline bool MatchField(const Field &value, const Field &operand) {
+  // a null never matches, except that it is not equal to anything, same as the CmpBool of Field
+  if (value.IsNull() || operand.IsNull()) {
+    return op == CompareOp::kNotEquals;
+  }
+  int cmp = FieldKernel<type>::Compare(value, operand);
+  switch (op) {
+    case CompareOp::kEquals:
+      return cmp == 0;
+    case CompareOp::kNotEquals:
+      return cmp != 0;
+    case CompareOp::kLessThan:
+      return cmp < 0;
+    case CompareOp::kGreaterThan:
+      return cmp > 0;
+    case CompareOp::kLessThanEquals:
+      return cmp <= 0;
+    default:
+      return cmp >= 0;
+  }
+}
+
+using FieldCompareFunc = int (*)(const Field &, const Field &);
+using FieldHashFunc = uint64_t (*)(const Field &);
+using FieldMatchFunc = bool (*)(const Field &, const Field &);
+
+inline FieldCompareFunc GetCompareKernel(TypeId type) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return &FieldKernel<TypeId::kTypeInt>::Compare;
+    case TypeId::kTypeFloat:
+      return &FieldKernel<TypeId::kTypeFloat>::Compare;
+    default:
+      return &FieldKernel<TypeId::kTypeChar>::Compare;
+  }
+}
+
+inline FieldHashFunc GetHashKernel(TypeId type) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return &FieldKernel<TypeId::kTypeInt>::Hash;
+    case TypeId::kTypeFloat:
+      return &FieldKernel<TypeId::kTypeFloat>::Hash;
+    default:
+      return &FieldKernel<TypeId::kTypeChar>::Hash;
+  }
+}
+
+template<TypeId type>
+inline FieldMatchFunc GetMatchKernel(CompareOp op) {
+  switch (op) {
+    case CompareOp::kEquals:
+      return &MatchField<type, CompareOp::kEquals>;
+    case CompareOp::kNotEquals:
+      return &MatchField<type, CompareOp::kNotEquals>;
+    case CompareOp::kLessThan:
+      return &MatchField<type, CompareOp::kLessThan>;
+    case CompareOp::kGreaterThan:
+      return &MatchField<type, CompareOp::kGreaterThan>;
+    case CompareOp::kLessThanEquals:
+      return &MatchField<type, CompareOp::kLessThanEquals>;
+    default:
+      return &MatchField<type, CompareOp::kGreaterThanEquals>;
+  }
+}
+
+/**
+ * @return kernel testing value op operand for values of the given type
+ */
+inline FieldMatchFunc GetMatchKernel(TypeId type, CompareOp op) {
+  switch (type) {
+    case TypeId::kTypeInt:
+      return GetMatchKernel<TypeId::kTypeInt>(op);
+    case TypeId::kTypeFloat:
+      return GetMatchKernel<TypeId::kTypeFloat>(op);
+    default:
+      return GetMatchKernel<TypeId::kTypeChar>(op);
+  }
+}
+
+#endif //MINISQL_FIELD_KERNELS_H
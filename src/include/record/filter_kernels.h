@@ -0,0 +1,33 @@
+#ifndef MINISQL_FILTER_KERNELS_H
+#define MINISQL_FILTER_KERNELS_H
+
+#include <cstdint>
+
+#include "record/field_kernels.h"
+
+/**
+ * Filters comparing a batch of column values with a constant, laid out as in the minipages of PaxPage.
+ * They write a match bitmap of (count + 63) / 64 words: bit i is set iff value i op operand holds, bits past
+ * count are cleared. Nulls are not known here, the caller masks them with the null bitmap.
+ *
+ * Int and float filters compare 8 values per instruction with AVX2, 4 with SSE2, and fall back to scalar
+ * code on other targets. The target is chosen at compile time, the build uses -march=native.
+ */
+void FilterInt32(const int32_t *values, uint32_t count, CompareOp op, int32_t operand, uint64_t *match);
+
+void FilterFloat(const float *values, uint32_t count, CompareOp op, float operand, uint64_t *match);
+
+/**
+ * @param values char values of width bytes each, a uint32_t length followed by the data
+ */
+void FilterChar(const char *values, uint32_t width, uint32_t count, CompareOp op, const char *operand,
+                uint32_t length, uint64_t *match);
+
+/**
+ * Scalar versions of the filters, used for the tail of a batch and on targets without SIMD
+ */
+void FilterInt32Scalar(const int32_t *values, uint32_t count, CompareOp op, int32_t operand, uint64_t *match);
+
+void FilterFloatScalar(const float *values, uint32_t count, CompareOp op, float operand, uint64_t *match);
+
+#endif //MINISQL_FILTER_KERNELS_H
@@ -2,6 +2,7 @@
 #define MINISQL_ROW_H
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include "common/macros.h"
 #include "common/rowid.h"
@@ -11,23 +12,40 @@
 
 /**
  *  Row format:
- * -------------------------------------------
- * | Header | Field-1 | ... | Field-N |
- * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *  
+ * -------------------------------------------------------------------------------------
+ * | Null bitmap | Fixed-size values | Var offsets | Var data of char-1 | ... | char-M |
+ * -------------------------------------------------------------------------------------
+ *  Null bitmap: one bit per column, ceil(N / 8) bytes.
+ *  Fixed-size values: int and float columns in schema order, 4 bytes each. A null value keeps its 4 bytes,
+ *  so every fixed-size value is at an offset known from the schema alone.
+ *  Var offsets: for each char column in schema order, the 2 bytes end offset of its data relative to the
+ *  start of the var data. The data of a char column starts where the previous one ends.
+ *  The field count is not stored, it is always the column count of the schema.
  *
+ *  The offsets of every column are precomputed in the schema, so a single field can be read without
+ *  parsing the fields before it, see DeserializeField.
+ *
+ *  A char value kept out of line (see TableHeap) has OVERFLOW_FLAG set in its end offset, and its var data
+ *  is an 8 bytes OverflowRef instead of the string.
+ */
+
+/**
+ * Location of a char value stored in a chain of overflow pages
  */
+struct OverflowRef {
+  page_id_t page_id_;   /** first page of the chain */
+  uint32_t length_;     /** length of the whole value */
+};
+
 class Row {
+  friend class PaxPage;
+
 public:
   /**
    * Row used for insert
    * Field integrity should check by upper level
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields) {
     // deep copy
     for (auto &field : fields) {
       // std::cout << "Row构建0\n";
@@ -41,32 +59,36 @@ public:
   /**
    * Row used for deserialize
    */
-  Row() : rid_(INVALID_ROWID), heap_(new SimpleMemHeap) {}
+  Row() : rid_(INVALID_ROWID) {}
 
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid) : rid_(rid) {}
 
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
+  Row(const Row &other) {
     rid_ = other.rid_;
     for (auto &field : other.fields_) {
       void *buf = heap_->Allocate(sizeof(Field));
       fields_.push_back(new(buf)Field(*field));
     }
+    overflow_refs_ = other.overflow_refs_;
+  }
+
+  /**
+   * Row move function, the fields stay where they are in the heap taken over from other
+   */
+  Row(Row &&other) noexcept
+          : rid_(other.rid_), fields_(std::move(other.fields_)), pool_(std::move(other.pool_)),
+            overflow_refs_(std::move(other.overflow_refs_)) {
+    other.fields_.clear();
   }
 
   virtual ~Row() {
-    delete heap_;
+    TruncateFields(0);
   }
 
   /**
@@ -76,6 +98,18 @@ public:
 
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
+  /**
+   * Read a single field of a serialized row, a value kept in overflow pages is read as null
+   * @param buf start of the serialized row
+   * @param heap memory heap the field is allocated from
+   */
+  static Field *DeserializeField(const char *buf, const Schema *schema, uint32_t column_index, MemHeap *heap);
+
+  /**
+   * Same as DeserializeField, but the field is returned by value instead of allocated from a heap
+   */
+  static Field ReadField(const char *buf, const Schema *schema, uint32_t column_index);
+
   /**
    * For empty row, return 0
    * For non-empty row with null fields, eg: |null|null|null|, return header size only
@@ -96,8 +130,44 @@ public:
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
-  Row &operator=(Row &other) {
-    return other;
+  /**
+   * Replace a field with a copy of the given one, and forget its overflow reference if any
+   */
+  void SetField(uint32_t idx, const Field &field);
+
+  /**
+   * Serialize the field as a reference to overflow pages instead of its value
+   */
+  void SetOverflowRef(uint32_t idx, const OverflowRef &ref);
+
+  /**
+   * Columns whose values are in overflow pages, the fields of these columns are null until they are loaded
+   * with SetField. Filled by DeserializeFrom.
+   */
+  inline const std::vector<std::pair<uint32_t, OverflowRef>> &GetOverflowRefs() const { return overflow_refs_; }
+
+  inline void ClearOverflowRefs() { overflow_refs_.clear(); }
+
+  static constexpr uint16_t OVERFLOW_FLAG = 0x8000;
+
+  Row &operator=(const Row &other) {
+    if (this != &other) {
+      TruncateFields(0);
+      rid_ = other.rid_;
+      for (auto &field : other.fields_) {
+        fields_.push_back(ALLOC_P(heap_, Field)(*field));
+      }
+      overflow_refs_ = other.overflow_refs_;
+    }
+    return *this;
+  }
+
+  Row &operator=(Row &&other) noexcept {
+    std::swap(rid_, other.rid_);
+    fields_.swap(other.fields_);
+    pool_ = std::move(other.pool_);
+    overflow_refs_.swap(other.overflow_refs_);
+    return *this;
   }
 
   bool operator==(Row &other)
@@ -112,10 +182,29 @@ public:
     return true;
   }
 
+private:
+  /**
+   * @return the overflow reference of a column, nullptr if the value is inline
+   */
+  const OverflowRef *FindOverflowRef(uint32_t idx) const;
+
+  /**
+   * Replace the value of a field in place, the field is only allocated if the row has less than idx + 1 fields
+   */
+  void AssignField(uint32_t idx, Field &&field);
+
+  /**
+   * Destroy the fields from count on and give their memory back to the heap
+   */
+  void TruncateFields(size_t count);
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
-  MemHeap *heap_{nullptr};
+  /** fields are freed and allocated again each time the row is read, which a pool serves from its free lists */
+  PoolMemHeap pool_;
+  MemHeap *heap_{&pool_};
+  std::vector<std::pair<uint32_t, OverflowRef>> overflow_refs_;
 };
 
 #endif //MINISQL_TUPLE_H
@@ -1,5 +1,7 @@
 #include <vector>
 #include <cstdint>
+#include <string>
+#include <unordered_map>
 #include "common/dberr.h"
 #include "common/macros.h"
 #include "glog/logging.h"
@@ -10,24 +12,49 @@
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {
+    InitRowLayout();
+    InitNameIndex();
+  }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
   inline const Column *GetColumn(const uint32_t column_index) const { return columns_[column_index]; }
 
+  /**
+   * Look the name up in the name index built with the schema, callers on hot paths should still resolve the
+   * index once and keep it
+   */
   dberr_t GetColumnIndex(const std::string &col_name, uint32_t &index) const {
-    for (uint32_t i = 0; i < columns_.size(); ++i) {
-      if (columns_[i]->GetName() == col_name) {
-        index = i;
-        return DB_SUCCESS;
-      }
+    auto iter = name_index_.find(col_name);
+    if (iter == name_index_.end()) {
+      return DB_COLUMN_NAME_NOT_EXIST;
     }
-    return DB_COLUMN_NAME_NOT_EXIST;
+    index = iter->second;
+    return DB_SUCCESS;
   }
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Positions in the serialized row format, see Row
+   */
+  inline uint32_t GetNullBitmapSize() const { return null_bitmap_size_; }
+
+  /**
+   * @return offset of the value for int/float columns, offset of the end offset entry for char columns
+   */
+  inline uint32_t GetFieldOffset(const uint32_t column_index) const { return field_offsets_[column_index]; }
+
+  /**
+   * @return true if the column is the first char column, its data starts at the var data offset
+   */
+  inline bool IsFirstVarColumn(const uint32_t column_index) const {
+    return field_offsets_[column_index] == fixed_size_;
+  }
+
+  inline uint32_t GetVarDataOffset() const { return var_data_offset_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -72,9 +99,19 @@ public:
    */
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
+private:
+  void InitRowLayout();
+
+  void InitNameIndex();
+
 private:
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  std::vector<uint32_t> field_offsets_;
+  uint32_t null_bitmap_size_{0};
+  uint32_t fixed_size_{0};          /** size of null bitmap and fixed size values */
+  uint32_t var_data_offset_{0};
+  std::unordered_map<std::string, uint32_t> name_index_;  /** column name to column index */
 };
 
 using IndexSchema = Schema;
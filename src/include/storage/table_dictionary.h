@@ -0,0 +1,70 @@
+#ifndef MINISQL_TABLE_DICTIONARY_H
+#define MINISQL_TABLE_DICTIONARY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/overflow_page.h"
+
+/**
+ * String to code mappings of the dictionary encoded char columns of a table.
+ *
+ * All columns of the table share one chain of pages in the OverflowPage format, the payload of a page is a
+ * sequence of entries:
+ *  -----------------------------------------------
+ *  | ColumnIndex (2) | Length (2) | Data (Length) |
+ *  -----------------------------------------------
+ * The code of a value is the position of its entry among the entries of its column. Entries are only
+ * appended and never span two pages, so a code never changes once it is given out.
+ */
+class TableDictionary {
+public:
+  /**
+   * Allocate the first page of an empty dictionary
+   */
+  void Create(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Read back the dictionary starting at root_page_id
+   */
+  void Load(BufferPoolManager *buffer_pool_manager, page_id_t root_page_id);
+
+  inline page_id_t GetRootPageId() const { return root_page_id_; }
+
+  /**
+   * @return false if the value has no code yet
+   */
+  bool GetCode(uint32_t column_index, const char *data, uint32_t length, uint32_t *code) const;
+
+  /**
+   * Give the value a new code if it has none, the new entry is written to the pages at once
+   */
+  uint32_t GetOrInsertCode(uint32_t column_index, const char *data, uint32_t length);
+
+  const std::string &GetValue(uint32_t column_index, uint32_t code) const;
+
+  /**
+   * @return number of distinct values of the column
+   */
+  uint32_t GetValueCount(uint32_t column_index) const;
+
+  static constexpr uint32_t SIZE_ENTRY_HEADER = 2 * sizeof(uint16_t);
+  static constexpr uint32_t MAX_VALUE_LENGTH = OverflowPage::MAX_DATA_SIZE - SIZE_ENTRY_HEADER;
+
+private:
+  struct ColumnEntries {
+    std::vector<std::string> values_;
+    std::unordered_map<std::string, uint32_t> codes_;
+  };
+
+  void AddEntry(uint32_t column_index, std::string value);
+
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  std::unordered_map<uint32_t, ColumnEntries> columns_;
+};
+
+#endif  // MINISQL_TABLE_DICTIONARY_H
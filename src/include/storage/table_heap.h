@@ -1,26 +1,70 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <functional>
+
 #include "buffer/buffer_pool_manager.h"
+#include "page/overflow_page.h"
+#include "page/pax_page.h"
 #include "page/table_page.h"
+#include "record/filter_kernels.h"
+#include "storage/table_dictionary.h"
 #include "storage/table_iterator.h"
 #include "transaction/log_manager.h"
 #include "transaction/lock_manager.h"
 
+/**
+ * Page layout of a table heap, chosen when the table is created.
+ * kRowLayout stores serialized rows in slotted TablePages, kPaxLayout stores column minipages in PaxPages.
+ */
+enum class TableLayout : uint32_t {
+  kRowLayout = 0,
+  kPaxLayout = 1
+};
+
+/**
+ * Predicate of a batch scan comparing one column with a constant, see TableHeap::ScanBatch
+ */
+struct ColumnPredicate {
+  ColumnPredicate(uint32_t column_index, CompareOp op, Field &&operand)
+          : column_index_(column_index), op_(op), operand_(std::move(operand)) {}
+
+  uint32_t column_index_;
+  CompareOp op_;
+  /** must have the type the column is stored with, the int code for a dictionary encoded column */
+  Field operand_;
+};
+
+/**
+ * In kRowLayout, a char value longer than OVERFLOW_THRESHOLD is written to a chain of overflow pages and
+ * the tuple only keeps a reference to it. Reads load such values back, scans only load the columns they
+ * are asked for.
+ *
+ * Values of dictionary encoded columns are stored as int codes in both layouts, the pages are read and
+ * written with a storage schema where these columns are int columns. Reads turn the codes back into
+ * strings, scans leave the codes of the columns they are not asked for.
+ */
 class TableHeap {
   friend class TableIterator;
 
 public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           TableLayout layout = TableLayout::kRowLayout) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, heap, layout);
   }
 
+  /**
+   * @param dictionary_page_id first page of the dictionary of the table, see GetDictionaryPageId
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           TableLayout layout = TableLayout::kRowLayout,
+                           page_id_t dictionary_page_id = INVALID_PAGE_ID) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, heap, layout,
+                              dictionary_page_id);
   }
 
   ~TableHeap() {}
@@ -42,7 +86,8 @@ public:
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * Update a tuple, its RowId never changes. If the new tuple is too large to fit in the old page, it is
+   * moved to another page and the old slot forwards to it.
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -82,6 +127,34 @@ public:
    */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @param projection columns whose values are loaded from overflow pages, the other out of line values
+   *        are read as null
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &projection);
+
+  /**
+   * Sampling scan, pages skipped by block sampling are still fetched to follow the page chain,
+   * but none of their tuples is read.
+   * @return the begin iterator of the sample
+   */
+  TableIterator Begin(Transaction *txn, const TableSample &sample);
+
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> &projection, const TableSample &sample);
+
+  /**
+   * Batch scan, only for kPaxLayout. The predicates are evaluated a page at a time over the column minipages
+   * into a selection bitmap, see filter_kernels.h, and only the selected tuples are read. A null matches no
+   * predicate but not equals, same as MatchField.
+   * @param projection columns loaded for every selected row as in Begin, nullptr for all columns
+   * @param consumer called with every row matching all the predicates, the row is only valid during the call
+   * @return false without reading anything if the table is not in PAX pages or a predicate can not be
+   *         evaluated on the stored values, the caller then falls back to Begin
+   */
+  bool ScanBatch(Transaction *txn, const std::vector<ColumnPredicate> &predicates,
+                 const std::vector<uint32_t> *projection, const std::function<void(const Row &)> &consumer);
+
   /**
    * @return the end iterator of this table
    */
@@ -92,38 +165,197 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /**
+   * @return minipage positions of the pages, only meaningful for kPaxLayout
+   */
+  inline const PaxLayout &GetPaxLayout() const { return pax_layout_; }
+
+  /**
+   * @return first page of the dictionary of the encoded columns, INVALID_PAGE_ID if there is none
+   */
+  inline page_id_t GetDictionaryPageId() const { return dictionary_.GetRootPageId(); }
+
+  /**
+   * Code of a value of a dictionary encoded column, codes are what scans return for the columns they do
+   * not load, so equality can be checked on codes.
+   * @return false if no tuple has ever had the value
+   */
+  bool GetDictionaryCode(uint32_t column_index, const char *data, uint32_t length, uint32_t *code) const;
+
+private:
+  /**
+   * Layout independent access to the pages of this heap
+   */
+  void InitPage(Page *page, page_id_t page_id, page_id_t prev_id, Transaction *txn);
+
+  page_id_t GetNextPageId(Page *page);
+
+  void SetNextPageId(Page *page, page_id_t next_page_id);
+
+  bool GetFirstTupleRid(Page *page, RowId *first_rid);
+
+  bool GetNextTupleRid(Page *page, const RowId &cur_rid, RowId *next_rid);
+
+  bool GetTuple(Page *page, Row *row, Transaction *txn);
+
+  TableIterator Begin(Transaction *txn, const std::vector<uint32_t> *projection, const TableSample *sample);
+
+  /**
+   * Write the bitmap of the tuples of a PAX page matching the predicate
+   */
+  void FilterPage(PaxPage *page, const ColumnPredicate &predicate, uint32_t count, uint64_t *match);
+
+  /**
+   * Find the next tuple kept by the sample, starting after rid in the pinned page, or at its first tuple
+   * if after_rid is false. Pages are unpinned when they are left.
+   * @param sample nullptr to keep every tuple
+   * @return the pinned page holding the tuple written to rid, nullptr if there is none
+   */
+  Page *SeekTuple(Page *page, RowId *rid, bool after_rid, const TableSample *sample);
+
+  /**
+   * Insert a row whose long values already have their overflow pages
+   */
+  bool InsertRow(Row &row, Transaction *txn);
+
+  /**
+   * Insert the new version of a tuple on another page and make the slot rid forward to it
+   * @param tuple_rid where the old version of the tuple is, rid itself unless it was moved before
+   */
+  bool MoveTuple(Row &row, const RowId &rid, const RowId &tuple_rid, Transaction *txn);
+
+  /**
+   * Overflow pages of long char values
+   */
+  page_id_t WriteOverflowChain(const char *data, uint32_t length);
+
+  void ReadOverflowChain(const OverflowRef &ref, char *data);
+
+  void FreeOverflowChain(page_id_t page_id);
+
+  /**
+   * @return true if the overflow chain holds exactly the given value
+   */
+  bool OverflowChainEquals(const OverflowRef &ref, const char *data, uint32_t length);
+
+  /**
+   * Move every long char value of the row to overflow pages, recorded as overflow references of the row
+   * @param old_row the version being replaced, its chains are reused for values that did not change
+   */
+  void WriteOverflowFields(Row &row, const Row *old_row = nullptr);
+
+  /**
+   * @return the overflow reference of a column of the row, nullptr if there is none or row is nullptr
+   */
+  static const OverflowRef *FindOverflowRef(const Row *row, uint32_t column_index);
+
+  /**
+   * Load the values of the overflow references of the row
+   * @param projection columns to load, nullptr for all of them
+   */
+  void LoadOverflowFields(Row *row, const std::vector<uint32_t> *projection);
+
+  /**
+   * Replace the codes of the encoded columns of the row with their strings
+   * @param projection columns to decode, nullptr for all of them
+   */
+  void DecodeFields(Row *row, const std::vector<uint32_t> *projection);
+
+  /**
+   * Everything a read leaves to the table heap: overflow values and dictionary codes
+   */
+  void LoadFields(Row *row, const std::vector<uint32_t> *projection);
+
+  /**
+   * @return a copy of the row in the storage schema, nullptr if a value can not be encoded
+   * @param new_columns receives the columns whose values have no code yet, they are given the next free code
+   *        without touching the dictionary
+   */
+  std::unique_ptr<Row> EncodeRow(const Row &row, std::vector<uint32_t> *new_columns);
+
+  /**
+   * Write the dictionary entries of the new values of a row once it is stored, a failed write leaves none behind
+   */
+  void AddDictionaryEntries(const Row &row, const Row &storage_row, const std::vector<uint32_t> &new_columns);
+
+  /**
+   * Insert and update of rows in the storage schema
+   */
+  bool InsertStorageRow(Row &row, Transaction *txn);
+
+  bool UpdateStorageRow(Row &row, const RowId &rid, Transaction *txn);
+
+  /**
+   * @return the schema of the stored tuples, the schema itself if no column is dictionary encoded
+   */
+  static Schema *CreateStorageSchema(Schema *schema, MemHeap *heap);
+
+  /**
+   * Free the overflow chains of the row
+   * @param kept_row chains it shares with this row are left alone
+   */
+  void FreeOverflowFields(const Row &row, const Row *kept_row = nullptr);
+
+  /**
+   * @return true if a value of the table may be longer than OVERFLOW_THRESHOLD
+   */
+  static bool HasOverflowColumns(Schema *schema, TableLayout layout);
+
 private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
+                     LogManager *log_manager, LockManager *lock_manager, MemHeap *heap, TableLayout layout) :
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
+          storage_schema_(CreateStorageSchema(schema, heap)),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
-    auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(first_page_id_));
-    first_page->Init(first_page_id_, INVALID_PAGE_ID, log_manager_, txn);
-    first_page->SetNextPageId(INVALID_PAGE_ID);
+          lock_manager_(lock_manager),
+          layout_(layout),
+          pax_layout_(storage_schema_),
+          has_overflow_columns_(HasOverflowColumns(storage_schema_, layout)) {
+    auto first_page = buffer_pool_manager_->NewPage(first_page_id_);
+    InitPage(first_page, first_page_id_, INVALID_PAGE_ID, txn);
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    if (storage_schema_ != schema_) {
+      dictionary_.Create(buffer_pool_manager_);
+    }
   };
 
   /**
    * load existing table heap by first_page_id
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, MemHeap *heap, TableLayout layout,
+                     page_id_t dictionary_page_id)
           : buffer_pool_manager_(buffer_pool_manager),
             first_page_id_(first_page_id),
             schema_(schema),
+            storage_schema_(CreateStorageSchema(schema, heap)),
             log_manager_(log_manager),
-            lock_manager_(lock_manager) {}
+            lock_manager_(lock_manager),
+            layout_(layout),
+            pax_layout_(storage_schema_),
+            has_overflow_columns_(HasOverflowColumns(storage_schema_, layout)) {
+    if (dictionary_page_id != INVALID_PAGE_ID) {
+      dictionary_.Load(buffer_pool_manager_, dictionary_page_id);
+    }
+  }
 
 private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  Schema *storage_schema_;
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
+  TableLayout layout_;
+  PaxLayout pax_layout_;
+  bool has_overflow_columns_;
+  TableDictionary dictionary_;
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
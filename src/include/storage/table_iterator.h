@@ -1,6 +1,8 @@
 #ifndef MINISQL_TABLE_ITERATOR_H
 #define MINISQL_TABLE_ITERATOR_H
 
+#include <vector>
+
 #include "common/rowid.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
@@ -8,11 +10,46 @@
 
 class TableHeap;
 
+/**
+ * Sampling scan of a table heap. Block sampling keeps whole pages and Bernoulli sampling keeps single rows,
+ * each with probability percent / 100. Whether a page or row is kept only depends on its id and the seed,
+ * so a scan with the same seed returns the same sample.
+ */
+struct TableSample {
+  enum class Method { kBlock, kBernoulli };
+
+  Method method_;
+  double percent_;
+  uint32_t seed_;
+
+  inline bool KeepsPage(page_id_t page_id) const {
+    return method_ != Method::kBlock || Keeps(static_cast<uint64_t>(page_id));
+  }
+
+  inline bool KeepsRow(const RowId &rid) const {
+    return method_ != Method::kBernoulli || Keeps(static_cast<uint64_t>(rid.Get()));
+  }
+
+private:
+  inline bool Keeps(uint64_t id) const {
+    // splitmix64 finalizer, spreads ids of neighbouring pages and slots over the whole range
+    uint64_t x = id ^ (static_cast<uint64_t>(seed_) * 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<double>(x >> 11) < percent_ / 100 * static_cast<double>(1ULL << 53);
+  }
+};
+
 class TableIterator {
 
 public:
   // you may define your own constructor based on your member variables
-  explicit TableIterator(TableHeap *tableheap, Row *row);
+  /**
+   * @param projection columns loaded from overflow pages for every row, nullptr for all columns
+   */
+  explicit TableIterator(TableHeap *tableheap, Row *row, const std::vector<uint32_t> *projection = nullptr,
+                         const TableSample *sample = nullptr);
 
   explicit TableIterator(const TableIterator &other);
 
@@ -40,6 +77,10 @@ private:
   // add your own private member variables here
   TableHeap *tableheap_;
   Row *row_;
+  bool project_all_{true};
+  std::vector<uint32_t> projection_;
+  bool sampled_{false};
+  TableSample sample_{};
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
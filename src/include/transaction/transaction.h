@@ -1,13 +1,33 @@
 #ifndef MINISQL_TRANSACTION_H
 #define MINISQL_TRANSACTION_H
 
+#include <deque>
+#include <unordered_set>
+
+#include "common/config.h"
+
+class Page;
+
 /**
  * Transaction tracks information related to a transaction.
  *
  * Implemented by student self
 */
 class Transaction {
+public:
+  /** @return the pages latched by the current index operation, nullptr stands for the latch on the root id */
+  inline std::deque<Page *> *GetPageSet() { return &page_set_; }
+
+  inline void AddIntoPageSet(Page *page) { page_set_.push_back(page); }
+
+  /** @return the pages the current index operation deletes once its latches are released */
+  inline std::unordered_set<page_id_t> *GetDeletedPageSet() { return &deleted_page_set_; }
+
+  inline void AddIntoDeletedPageSet(page_id_t page_id) { deleted_page_set_.insert(page_id); }
 
+private:
+  std::deque<Page *> page_set_;
+  std::unordered_set<page_id_t> deleted_page_set_;
 };
 
 #endif  // MINISQL_TRANSACTION_H
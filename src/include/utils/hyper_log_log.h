@@ -0,0 +1,67 @@
+#ifndef MINISQL_HYPER_LOG_LOG_H
+#define MINISQL_HYPER_LOG_LOG_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * HyperLogLog sketch estimating the number of distinct values added to it in fixed memory.
+ * The standard error is about 1.04 / sqrt(2^PRECISION), 1.6% for the default precision.
+ */
+class HyperLogLog {
+public:
+  static constexpr uint32_t PRECISION = 12;
+  static constexpr uint32_t NUM_REGISTERS = 1u << PRECISION;
+
+  HyperLogLog() : registers_(NUM_REGISTERS, 0) {}
+
+  /**
+   * @param hash a well mixed 64 bits hash of the value, see Hash
+   */
+  void Add(uint64_t hash) {
+    uint32_t index = static_cast<uint32_t>(hash >> (64 - PRECISION));
+    uint64_t rest = hash << PRECISION;
+    uint8_t rank = rest == 0 ? 64 - PRECISION + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[index]) {
+      registers_[index] = rank;
+    }
+  }
+
+  uint64_t Estimate() const {
+    double sum = 0;
+    uint32_t zeros = 0;
+    for (auto rank : registers_) {
+      sum += std::ldexp(1.0, -rank);
+      zeros += rank == 0;
+    }
+    double m = NUM_REGISTERS;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // small cardinalities leave registers empty, linear counting is more accurate for them
+    if (estimate <= 2.5 * m && zeros > 0) {
+      estimate = m * std::log(m / zeros);
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+  }
+
+  /**
+   * FNV-1a followed by the murmur3 finalizer, so that every bit of the result depends on every input byte.
+   */
+  static uint64_t Hash(const char *data, uint32_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < length; i++) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+private:
+  std::vector<uint8_t> registers_;
+};
+
+#endif //MINISQL_HYPER_LOG_LOG_H
@@ -3,7 +3,11 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <new>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 #include "common/macros.h"
 
 class MemHeap {
@@ -54,4 +58,201 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Bump allocator over a list of chunks. Allocate only moves a pointer, Free does nothing,
+ * and all the memory is given back at once by Reset or when the heap is destroyed.
+ * Suited to objects that die together, e.g. everything allocated while running one statement.
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  explicit ArenaMemHeap(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  ArenaMemHeap(const ArenaMemHeap &) = delete;
+
+  ArenaMemHeap &operator=(const ArenaMemHeap &) = delete;
+
+  /**
+   * Chunks keep their address when moved, so pointers into the heap stay valid
+   */
+  ArenaMemHeap(ArenaMemHeap &&other) noexcept
+          : chunk_size_(other.chunk_size_), cur_(other.cur_), end_(other.end_), chunks_(std::move(other.chunks_)),
+            destructors_(std::move(other.destructors_)) {
+    other.cur_ = other.end_ = nullptr;
+    other.chunks_.clear();
+    other.destructors_.clear();
+  }
+
+  ArenaMemHeap &operator=(ArenaMemHeap &&other) noexcept {
+    std::swap(chunk_size_, other.chunk_size_);
+    std::swap(cur_, other.cur_);
+    std::swap(end_, other.end_);
+    chunks_.swap(other.chunks_);
+    destructors_.swap(other.destructors_);
+    return *this;
+  }
+
+  ~ArenaMemHeap() override {
+    Reset();
+    for (auto chunk : chunks_) {
+      free(chunk.first);
+    }
+  }
+
+  void *Allocate(size_t size) override {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (cur_ + size > end_) {
+      NextChunk(size);
+    }
+    void *buf = cur_;
+    cur_ += size;
+    return buf;
+  }
+
+  void Free(void *ptr) override {}
+
+  /**
+   * Construct an object in the arena, its destructor runs on Reset if it has a non-trivial one
+   */
+  template<typename T, typename... Args>
+  T *New(Args &&... args) {
+    T *obj = new(Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      destructors_.emplace_back(obj, [](void *p) { static_cast<T *>(p)->~T(); });
+    }
+    return obj;
+  }
+
+  /**
+   * Destroy the objects created by New and free every allocation. The first chunk is kept for reuse,
+   * so a heap reset after each statement does not go back to malloc for small statements.
+   */
+  void Reset() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+      it->second(it->first);
+    }
+    destructors_.clear();
+    while (chunks_.size() > 1) {
+      free(chunks_.back().first);
+      chunks_.pop_back();
+    }
+    if (chunks_.empty()) {
+      cur_ = end_ = nullptr;
+    } else {
+      cur_ = chunks_[0].first;
+      end_ = cur_ + chunks_[0].second;
+    }
+  }
+
+  static constexpr size_t ALIGNMENT = 8;
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+private:
+  void NextChunk(size_t size) {
+    // chunks double in size so that a large statement only needs a few of them
+    size_t chunk_size = chunks_.empty() ? chunk_size_ : chunks_.back().second * 2;
+    while (chunk_size < size) {
+      chunk_size *= 2;
+    }
+    auto chunk = static_cast<char *>(malloc(chunk_size));
+    ASSERT(chunk != nullptr, "Out of memory exception");
+    chunks_.emplace_back(chunk, chunk_size);
+    cur_ = chunk;
+    end_ = chunk + chunk_size;
+  }
+
+  size_t chunk_size_;
+  char *cur_{nullptr};
+  char *end_{nullptr};
+  std::vector<std::pair<char *, size_t>> chunks_;
+  std::vector<std::pair<void *, void (*)(void *)>> destructors_;
+};
+
+/**
+ * Allocator with a free list per size class, a freed block is reused by the next allocation of its class.
+ * Blocks of every class are carved from an arena, sizes above MAX_BLOCK_SIZE go to malloc.
+ * Suited to objects freed and allocated again and again, e.g. the fields of a row read by a scan.
+ */
+class PoolMemHeap : public MemHeap {
+public:
+  explicit PoolMemHeap(size_t chunk_size = DEFAULT_CHUNK_SIZE) : arena_(chunk_size) {}
+
+  PoolMemHeap(PoolMemHeap &&other) noexcept : arena_(std::move(other.arena_)), large_(std::move(other.large_)) {
+    std::swap(free_lists_, other.free_lists_);
+    other.large_.clear();
+  }
+
+  PoolMemHeap &operator=(PoolMemHeap &&other) noexcept {
+    arena_ = std::move(other.arena_);
+    std::swap(free_lists_, other.free_lists_);
+    large_.swap(other.large_);
+    return *this;
+  }
+
+  ~PoolMemHeap() override {
+    for (auto it : large_) {
+      free(it);
+    }
+  }
+
+  void *Allocate(size_t size) override {
+    if (size > MAX_BLOCK_SIZE) {
+      void *buf = malloc(HEADER_SIZE + size);
+      ASSERT(buf != nullptr, "Out of memory exception");
+      large_.insert(buf);
+      *static_cast<size_t *>(buf) = NUM_CLASSES;
+      return static_cast<char *>(buf) + HEADER_SIZE;
+    }
+    size_t size_class = SizeClass(size);
+    FreeBlock *block = free_lists_[size_class];
+    if (block != nullptr) {
+      free_lists_[size_class] = block->next_;
+      return block;
+    }
+    auto buf = static_cast<char *>(arena_.Allocate(HEADER_SIZE + (MIN_BLOCK_SIZE << size_class)));
+    *reinterpret_cast<size_t *>(buf) = size_class;
+    return buf + HEADER_SIZE;
+  }
+
+  void Free(void *ptr) override {
+    if (ptr == nullptr) {
+      return;
+    }
+    char *buf = static_cast<char *>(ptr) - HEADER_SIZE;
+    size_t size_class = *reinterpret_cast<size_t *>(buf);
+    if (size_class == NUM_CLASSES) {
+      large_.erase(buf);
+      free(buf);
+      return;
+    }
+    auto block = static_cast<FreeBlock *>(ptr);
+    block->next_ = free_lists_[size_class];
+    free_lists_[size_class] = block;
+  }
+
+  static constexpr size_t MIN_BLOCK_SIZE = 16;
+  static constexpr size_t NUM_CLASSES = 6;
+  static constexpr size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE << (NUM_CLASSES - 1);
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 512;
+
+private:
+  struct FreeBlock {
+    FreeBlock *next_;
+  };
+
+  /** every block is preceded by its size class, NUM_CLASSES for a block from malloc */
+  static constexpr size_t HEADER_SIZE = ArenaMemHeap::ALIGNMENT;
+
+  static size_t SizeClass(size_t size) {
+    size_t size_class = 0;
+    while ((MIN_BLOCK_SIZE << size_class) < size) {
+      size_class++;
+    }
+    return size_class;
+  }
+
+  ArenaMemHeap arena_;
+  FreeBlock *free_lists_[NUM_CLASSES]{};
+  std::unordered_set<void *> large_;
+};
+
 #endif //MINISQL_MEM_HEAP_H
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <string>
+#include <thread>
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
@@ -7,12 +9,13 @@
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, BPlusTreeMode mode)
         : index_id_(index_id),
           buffer_pool_manager_(buffer_pool_manager),
           comparator_(comparator),
           leaf_max_size_(leaf_max_size),
-          internal_max_size_(internal_max_size) {
+          internal_max_size_(internal_max_size),
+          mode_(mode) {
   root_page_id_ = INVALID_PAGE_ID;
   IndexRootsPage *page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID )->GetData());
   if (page != nullptr) {
@@ -50,18 +53,35 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
-  bool flag = false;
-  if(IsEmpty()) return flag;
-  auto leaf_page = FindLeafPage(key, false);
-  B_PLUS_TREE_LEAF_PAGE_TYPE* leaf = reinterpret_cast <B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page);
-  if (leaf == nullptr) return false;
+  if (mode_ == BPlusTreeMode::kOptimistic) {
+    // the lookup is done on a validated copy of the leaf, no latch is taken
+    alignas(8) char copy[PAGE_SIZE];
+    Page *page;
+    uint64_t version;
+    if (!FindLeafPageOptimistic(key, false, false, page, version, copy)) {
+      return false;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    ValueType v;
+    bool found = reinterpret_cast<LeafPage *>(copy)->Lookup(key, v, comparator_);
+    if (found) {
+      result.push_back(v);
+    }
+    return found;
+  }
+  Page *page = FindLeafPage(key);
+  if (page == nullptr) {
+    return false;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
   ValueType v;
-  if(leaf->Lookup(key, v, comparator_)){
+  bool found = leaf->Lookup(key, v, comparator_);
+  if (found) {
     result.push_back(v);
-    flag = true;
   }
-  //buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-  return flag;
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
 }
 
 /*****************************************************************************
@@ -76,17 +96,20 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  //printf("cd into insert\n");
-  //printf("root = %d\n",root_page_id_);
-  if(IsEmpty()){
-    // std::cout << "BPLUSTREE_TYPE::Insert isempty\n";
-    //printf("empty tree\n");
+  Transaction local;
+  if (transaction == nullptr) {
+    transaction = &local;
+  }
+  Page *page = FindLeafPageForWrite(key, LatchMode::kInsert, transaction);
+  if (page == nullptr) {
+    // empty tree, the latch on the root id is held
     StartNewTree(key, value);
-    // std::cout << "BPLUSTREE_TYPE::Insert isempty1\n";
+    ReleaseLatches(transaction, true);
     return true;
   }
-  // printf("non-empty tree\n");
-  return InsertIntoLeaf(key, value, transaction);
+  bool inserted = InsertIntoLeaf(key, value, transaction);
+  ReleaseLatches(transaction, inserted);
+  return inserted;
 }
 /*
  * Insert constant key & value pair into an empty tree
@@ -98,18 +121,23 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   page_id_t newid;
   auto page = buffer_pool_manager_->NewPage(newid);
-  B_PLUS_TREE_LEAF_PAGE_TYPE *root = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+  ASSERT(page != nullptr, "Out of memory.");
+  auto root = reinterpret_cast<LeafPage *>(page->GetData());
+  // the latch bumps the version, an optimistic reader holding a stale copy of
+  // a freed page with this id validates against it and restarts
+  page->WLatch();
   root->Init(newid, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  page->WUnlatch();
+  // publish the root only once the leaf holds the entry
   root_page_id_ = newid;
   UpdateRootPageId(1);
-  root->Insert(key, value, comparator_);
   buffer_pool_manager_->UnpinPage(newid, true);
-  //printf(":%d %d\n", root->IsLeafPage(), root->IsRootPage());
 }
 
 /*
  * Insert constant key & value pair into leaf page
- * User needs to first find the right leaf page as insertion target, then look
+ * The leaf page is the last page latched in the page set of transaction, look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immediately, otherwise insert entry. Remember to deal with split if necessary.
  * @return: since we only support unique key, if user try to insert duplicate
@@ -117,23 +145,16 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  //printf("cd into insertintoleaf\n");
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(FindLeafPage(key, false));
-  //printf("haha\n");
+  auto leaf = reinterpret_cast<LeafPage *>(transaction->GetPageSet()->back()->GetData());
   ValueType t;
-  if(leaf->Lookup(key, t, comparator_)) {
-    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+  if (leaf->Lookup(key, t, comparator_)) {
     return false;
   }
-  if(leaf->GetSize() < leaf->GetMaxSize()) {
-    leaf->Insert(key, value, comparator_);
-  }
-  else {
-    leaf->Insert(key, value, comparator_);
-    B_PLUS_TREE_LEAF_PAGE_TYPE *new_leaf_page = Split(leaf);
-    InsertIntoParent(leaf, new_leaf_page->KeyAt(0), new_leaf_page, transaction);
+  leaf->Insert(key, value, comparator_);
+  if (IsOverflow(leaf)) {
+    LeafPage *new_leaf_page = Split(leaf);
+    InsertIntoParent(leaf, new_leaf_page->LowKey(), new_leaf_page, transaction);
   }
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
   return true;
 }
 
@@ -143,12 +164,14 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * The new page stays pinned, InsertIntoParent unpins it.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
   page_id_t new_page_id;
   auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+  ASSERT(new_page != nullptr, "Out of memory.");
   auto new_node = reinterpret_cast <N*> (new_page->GetData());
   if(node->IsLeafPage()){
     reinterpret_cast<LeafPage *>(new_node)->Init(new_page_id, node->GetParentPageId(), leaf_max_size_);
@@ -158,8 +181,6 @@ N *BPLUSTREE_TYPE::Split(N *node) {
     reinterpret_cast<InternalPage *>(new_node)->Init(new_page_id, node->GetParentPageId(), internal_max_size_);
     reinterpret_cast<InternalPage *>(node)->MoveHalfTo(reinterpret_cast<InternalPage *>(new_node), buffer_pool_manager_);
   }
-  buffer_pool_manager_->UnpinPage(new_page_id, true);
-  //buffer_pool_manager_->UnpinPage(node->GetPageId(),true);
   return new_node;
 }
 
@@ -168,46 +189,270 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * @param   old_node      input page from split() method
  * @param   key
  * @param   new_node      returned page from split() method
- * User needs to first find the parent page of old_node, parent node must be
- * adjusted to take info of new_node into account. Remember to deal with split
- * recursively if necessary.
+ * The parent of old_node is still latched by this insert, since old_node was
+ * not safe. Parent node must be adjusted to take info of new_node into account.
+ * Remember to deal with split recursively if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
                                       Transaction *transaction) {
   if(old_node->IsRootPage()){
-    Page *const new_root_page = buffer_pool_manager_->NewPage(root_page_id_);
+    page_id_t root_id;
+    Page *const new_root_page = buffer_pool_manager_->NewPage(root_id);
+    ASSERT(new_root_page != nullptr, "Out of memory.");
     InternalPage* new_root = reinterpret_cast<InternalPage *>(new_root_page->GetData());
-    new_root->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
-    old_node->SetParentPageId(root_page_id_);
-    new_node->SetParentPageId(root_page_id_);
+    new_root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+    old_node->SetParentPageId(root_id);
+    new_node->SetParentPageId(root_id);
     new_root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    root_page_id_ = root_id;
     UpdateRootPageId(false);
-    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    buffer_pool_manager_->UnpinPage(root_id, true);
     buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
-    //buffer_pool_manager_->UnpinPage(old_node->GetPageId(), true);
     return;
   }
   page_id_t parent_page_id = old_node->GetParentPageId();
-  Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-  auto parent = reinterpret_cast<InternalPage *>(parent_page);
-  if(parent->GetSize() < parent->GetMaxSize()){
-    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    new_node->SetParentPageId(parent_page_id);
-    buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
-  }
-  else{
-    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    new_node->SetParentPageId(parent_page_id);
-    buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_page_id)->GetData());
+  parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(parent_page_id);
+  buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+  if (IsOverflow(parent)) {
     auto new_parent = Split(parent);
     InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
   }
   buffer_pool_manager_->UnpinPage(parent_page_id, true);
-  //Check();
-  return;
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree bottom up from the sorted pairs of sorter, which must be finished.
+ * Leaves are filled in key order and linked, the first key of every node is
+ * appended to the open node of the level above, so each level is written
+ * once and only one node per level is pinned at a time. The number of nodes of
+ * each level is known from the number of pairs, entries are spread evenly so
+ * that no node is left under its min size.
+ * Slotted nodes are filled to fill_factor of their bytes instead, see
+ * BulkSlottedAdd, the size of a node is only known once its fences are.
+ * @return: false if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(ExternalSorter<KeyType, ValueType, KeyComparator> &sorter, double fill_factor) {
+  root_latch_.WLock();
+  if (!IsEmpty()) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  int n = static_cast<int>(sorter.Size());
+  if (n == 0) {
+    root_latch_.WUnlock();
+    return true;
+  }
+  if constexpr (Format::SLOTTED) {
+    SlottedBulkLoad load;
+    KeyType key;
+    ValueType value;
+    while (sorter.Next(key, value)) {
+      BulkSlottedAdd<LeafPage>(load, 0, load.leaves_, key, value, fill_factor);
+    }
+    BulkSlottedClose<LeafPage>(load, 0, load.leaves_, true, fill_factor);
+    for (size_t level = 1; load.root_ == INVALID_PAGE_ID; level++) {
+      BulkSlottedClose<InternalPage>(load, level, load.levels_[level - 1], true, fill_factor);
+    }
+    buffer_pool_manager_->UnpinPage(load.last_leaf_->GetPageId(), true);
+    root_page_id_ = load.root_;
+    UpdateRootPageId(1);
+    root_latch_.WUnlock();
+    return true;
+  }
+  std::vector<BulkLevel> levels;
+  levels.push_back({n, BulkNodeCount(n, leaf_max_size_, fill_factor)});
+  while (levels.back().nodes_ > 1) {
+    int children = levels.back().nodes_;
+    levels.push_back({children, BulkNodeCount(children, internal_max_size_, fill_factor)});
+  }
+  KeyType key;
+  ValueType value;
+  BulkLevel &leaves = levels[0];
+  while (sorter.Next(key, value)) {
+    if (leaves.page_ == nullptr || leaves.filled_ == leaves.Quota()) {
+      BulkNextNode(levels, 0, key);
+    }
+    reinterpret_cast<LeafPage *>(leaves.page_)->Append(key, value);
+    leaves.filled_++;
+  }
+  for (auto &level : levels) {
+    ASSERT(level.node_ == level.nodes_ - 1 && level.filled_ == level.Quota(), "Bulk load level not filled.");
+    buffer_pool_manager_->UnpinPage(level.page_->GetPageId(), true);
+  }
+  root_page_id_ = levels.back().page_->GetPageId();
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
+}
+
+/*
+ * Number of nodes holding entries at fill_factor of max_size, fewer nodes if
+ * they would be under min size on average
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::BulkNodeCount(int entries, int max_size, double fill_factor) {
+  int per_node = std::min(std::max(static_cast<int>(max_size * fill_factor), 1), max_size);
+  int nodes = (entries + per_node - 1) / per_node;
+  while (nodes > 1 && entries / nodes < max_size / 2) {
+    nodes--;
+  }
+  return nodes;
+}
+
+/*
+ * Close the open node of level and start the next one, whose first key is key.
+ * The new node is appended to the level above, a new leaf is linked after the
+ * last one.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreePage *BPLUSTREE_TYPE::BulkNextNode(std::vector<BulkLevel> &levels, size_t level, const KeyType &key) {
+  page_id_t page_id;
+  auto page = buffer_pool_manager_->NewPage(page_id);
+  ASSERT(page != nullptr, "Out of memory.");
+  page_id_t parent_id = INVALID_PAGE_ID;
+  if (level + 1 < levels.size()) {
+    parent_id = BulkAppendChild(levels, level + 1, key, page_id);
+  }
+  BulkLevel &current = levels[level];
+  if (level == 0) {
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, parent_id, leaf_max_size_);
+    if (current.page_ != nullptr) {
+      reinterpret_cast<LeafPage *>(current.page_)->SetNextPageId(page_id);
+    }
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_id, internal_max_size_);
+  }
+  if (current.page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(current.page_->GetPageId(), true);
+  }
+  current.page_ = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  current.node_++;
+  current.filled_ = 0;
+  return current.page_;
+}
+
+/*
+ * Append child with its first key to the open internal node of level
+ * @return: page id of the node, the parent of child
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::BulkAppendChild(std::vector<BulkLevel> &levels, size_t level, const KeyType &key,
+                                          page_id_t child) {
+  BulkLevel &current = levels[level];
+  if (current.page_ == nullptr || current.filled_ == current.Quota()) {
+    BulkNextNode(levels, level, key);
+  }
+  reinterpret_cast<InternalPage *>(current.page_)->Append(key, child);
+  current.filled_++;
+  return current.page_->GetPageId();
+}
+
+/*
+ * Append key & value to the open node of level of a slotted tree, and close
+ * nodes while its entries take more than fill_factor of a page. The entries of a
+ * node share the prefix of its low fence and its last key, which only gets
+ * shorter as keys grow, their bytes are counted again when it does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template<typename N, typename V>
+void BPLUSTREE_TYPE::BulkSlottedAdd(SlottedBulkLoad &load, size_t level, SlottedBulkNode<V> &node,
+                                    const KeyType &key, const V &value, double fill_factor) {
+  auto &entries = node.entries_;
+  entries.emplace_back(key, value);
+  uint32_t prefix_length = N::PrefixLength(node.bounded_ ? &node.low_ : nullptr, &key);
+  if (entries.size() == 1 || prefix_length < node.prefix_length_) {
+    node.prefix_length_ = prefix_length;
+    node.bytes_ = N::EntriesBytes(entries.data(), static_cast<int>(entries.size()), prefix_length, level == 0);
+  } else {
+    node.bytes_ += N::EntriesBytes(&entries.back(), 1, prefix_length, true);
+  }
+  while (entries.size() > 1 && node.bytes_ > N::FillBytes(fill_factor)) {
+    BulkSlottedClose<N>(load, level, node, false, fill_factor);
+  }
+}
+
+/*
+ * Write the first entries of the open node of level to a new node and append it
+ * to the level above. The node takes the most entries that fit in fill_factor of
+ * a page with the prefix of its fences. The high fence of a leaf is the shortest
+ * key separating it from the next entry, the one of an internal node is the key
+ * of the next entry. The last node of a level takes all entries left, and it is
+ * the root if it is the only node of its level.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template<typename N, typename V>
+void BPLUSTREE_TYPE::BulkSlottedClose(SlottedBulkLoad &load, size_t level, SlottedBulkNode<V> &node, bool last,
+                                      double fill_factor) {
+  bool leaf = level == 0;
+  auto &entries = node.entries_;
+  uint32_t fill_bytes = N::FillBytes(fill_factor);
+  if (last) {
+    // the last node has no high fence and no prefix
+    while (entries.size() > 1 &&
+           N::EntriesBytes(entries.data(), static_cast<int>(entries.size()), 0, leaf) > fill_bytes) {
+      BulkSlottedClose<N>(load, level, node, false, fill_factor);
+    }
+  }
+  const KeyType *low = node.bounded_ ? &node.low_ : nullptr;
+  int count = static_cast<int>(entries.size());
+  KeyType high;
+  if (!last) {
+    for (count--; ; count--) {
+      high = leaf ? N::Separator(entries[count - 1].first, entries[count].first) : entries[count].first;
+      if (count == 1 || N::EntriesBytes(entries.data(), count, N::PrefixLength(low, &high), leaf) <= fill_bytes) {
+        break;
+      }
+    }
+  }
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  ASSERT(page != nullptr, "Out of memory.");
+  auto new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, INVALID_PAGE_ID, leaf ? leaf_max_size_ : internal_max_size_);
+  new_node->Rebuild(entries.data(), count, low, last ? nullptr : &high);
+  if constexpr (std::is_same<N, LeafPage>::value) {
+    // the last leaf stays pinned until the next one is linked after it
+    if (load.last_leaf_ != nullptr) {
+      reinterpret_cast<LeafPage *>(load.last_leaf_->GetData())->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(load.last_leaf_->GetPageId(), true);
+    }
+    load.last_leaf_ = page;
+  } else {
+    for (int i = 0; i < count; i++) {
+      auto child = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(entries[i].second)->GetData());
+      child->SetParentPageId(page_id);
+      buffer_pool_manager_->UnpinPage(entries[i].second, true);
+    }
+    buffer_pool_manager_->UnpinPage(page_id, true);
+  }
+  if (last && node.closed_ == 0) {
+    load.root_ = page_id;
+    return;
+  }
+  KeyType separator = node.bounded_ ? node.low_ : KeyType();
+  node.closed_++;
+  entries.erase(entries.begin(), entries.begin() + count);
+  if (!last) {
+    node.low_ = high;
+    node.bounded_ = true;
+    node.prefix_length_ = N::PrefixLength(&node.low_, &entries.back().first);
+    node.bytes_ = N::EntriesBytes(entries.data(), static_cast<int>(entries.size()), node.prefix_length_, leaf);
+  }
+  if (load.levels_.size() == level) {
+    load.levels_.emplace_back();
+  }
+  BulkSlottedAdd<InternalPage>(load, level + 1, load.levels_[level], separator, page_id, fill_factor);
+}
+
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -216,79 +461,78 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * If current tree is empty, return immediately.
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * necessary. Pages emptied by merges are deleted once the latches are released.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  //printf("into f remove\n");
-  if(IsEmpty()) return;
-  auto leaf_page = FindLeafPage(key, false);
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page);
-  int size_after_deletion = leaf->RemoveAndDeleteRecord(key, comparator_);
-  if(size_after_deletion < leaf->GetMinSize()){
+  Transaction local;
+  if (transaction == nullptr) {
+    transaction = &local;
+  }
+  Page *page = FindLeafPageForWrite(key, LatchMode::kRemove, transaction);
+  if (page == nullptr) {
+    ReleaseLatches(transaction, false);
+    return;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->RemoveAndDeleteRecord(key, comparator_);
+  if (IsUnderflow(leaf)) {
     CoalesceOrRedistribute(leaf, transaction);
   }
-  //buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
-  return;
+  ReleaseLatches(transaction, true);
+  DeletePages(transaction);
 }
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * The parent is latched by this remove, the sibling is latched here while it
+ * is merged or borrowed from.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
-
-
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
+  if (node->IsRootPage()) {
+    return AdjustRoot(node, transaction);
+  }
+  page_id_t parent_page_id = node->GetParentPageId();
+  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_page_id)->GetData());
+  int index_parent = parent->ValueIndex(node->GetPageId());
+  if (parent->GetSize() < 2) {
+    // only a slotted page that could not be merged is left with one child, it has no sibling
+    buffer_pool_manager_->UnpinPage(parent_page_id, false);
+    return false;
+  }
+  // the left sibling, or the right one for the first child
+  page_id_t neighbor_page_id = parent->ValueAt(index_parent > 0 ? index_parent - 1 : 1);
+  Page *neighbor_page = buffer_pool_manager_->FetchPage(neighbor_page_id);
+  neighbor_page->WLatch();
+  N *neighbor_node = reinterpret_cast<N *>(neighbor_page->GetData());
   bool flag = false;
-  if(node->IsRootPage())
-    flag = AdjustRoot(node);
-  else{
-    auto page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-    if(page != nullptr){
-      InternalPage* parent = reinterpret_cast <InternalPage*> (page->GetData());
-      int index_parent = parent->ValueIndex(node->GetPageId());
-      if(index_parent > 0){
-        auto neighbor_page = buffer_pool_manager_->FetchPage(parent->ValueAt(index_parent - 1));
-        N* neighbor_node = reinterpret_cast <N *> (neighbor_page->GetData());
-        if(node->GetSize() + neighbor_node->GetSize() <= node->GetMaxSize()){
-          Coalesce(&neighbor_node, &node, &parent, index_parent, transaction);
-          buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-          buffer_pool_manager_->UnpinPage(neighbor_page->GetPageId(), true);
-          flag = true;
-        }
-        else{
-          Redistribute(neighbor_node, node, index_parent);
-          buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-          buffer_pool_manager_->UnpinPage(neighbor_page->GetPageId(), true);
-        }
-      }
-      else if(index_parent == 0){
-        auto neighbor_page = buffer_pool_manager_->FetchPage(parent->ValueAt(index_parent + 1));
-        N* neighbor_node = reinterpret_cast <N *> (neighbor_page->GetData());
-        if(node->GetSize() + neighbor_node->GetSize() <= node->GetMaxSize()){
-          Coalesce(&node, &neighbor_node, &parent, index_parent + 1, transaction);
-          buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-          buffer_pool_manager_->UnpinPage(neighbor_page->GetPageId(), true);
-        }
-        else{
-          Redistribute(neighbor_node, node, index_parent);
-          buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-          buffer_pool_manager_->UnpinPage(neighbor_page->GetPageId(), true);
-        }
-      }
+  bool merge = index_parent > 0 ? CanMerge(neighbor_node, node, parent->KeyAt(index_parent))
+                                : CanMerge(node, neighbor_node, parent->KeyAt(1));
+  if (merge) {
+    if (index_parent > 0) {
+      Coalesce(&neighbor_node, &node, &parent, index_parent, transaction);
+      flag = true;
+    } else {
+      Coalesce(&node, &neighbor_node, &parent, 1, transaction);
     }
+  } else {
+    Redistribute(neighbor_node, node, index_parent);
   }
+  neighbor_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(neighbor_page_id, true);
+  buffer_pool_manager_->UnpinPage(parent_page_id, true);
   return flag;
 }
 
 /*
- * Move all the key & value pairs from one page to its sibling page, and notify
- * buffer pool manager to delete this page. Parent page must be adjusted to
+ * Move all the key & value pairs from one page to its sibling page, and add
+ * this page to the deleted pages of transaction. Parent page must be adjusted to
  * take info of deletion into account. Remember to deal with coalesce or
  * redistribute recursively if necessary.
  * Using template N to represent either internal page or leaf page.
@@ -299,8 +543,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
-                              BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
+bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node, InternalPage **parent, int index,
                               Transaction *transaction) {
   if((*node)->IsLeafPage()) {
     LeafPage* now = reinterpret_cast<LeafPage *>(*node);
@@ -313,11 +556,9 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
     KeyType middle = (*parent)->KeyAt(index);
     now->MoveAllTo(nei, middle, buffer_pool_manager_);
   }
-  //buffer_pool_manager_->UnpinPage((*node)->GetPageId(), true);
-  buffer_pool_manager_->DeletePage((*node)->GetPageId());
-  //buffer_pool_manager_->UnpinPage((*neighbor_node)->GetPageId(), true);
+  transaction->AddIntoDeletedPageSet((*node)->GetPageId());
   (*parent)->Remove(index);
-  if((*parent)->GetSize() < (*parent)->GetMinSize()){
+  if (IsUnderflow(*parent)) {
     return CoalesceOrRedistribute(*parent, transaction);
   }
   else {
@@ -331,6 +572,8 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  * otherwise move sibling page's last key & value pair into head of input
  * "node".
  * Using template N to represent either internal page or leaf page.
+ * Slotted pages spread their bytes evenly over both pages instead, nothing moves
+ * if the pages or the new separator in the parent would not fit.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  */
@@ -340,40 +583,61 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
   auto *page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
   if(page == nullptr) return;
   InternalPage *parent = reinterpret_cast<InternalPage *>(page->GetData());
-  int setindex;
-  if(node->IsLeafPage()){
-    LeafPage* leaf_node = reinterpret_cast<LeafPage*>(node);
-    LeafPage* leaf_neighbor = reinterpret_cast<LeafPage*>(neighbor_node);
-    if(index){
-      setindex = parent->ValueIndex(leaf_node->GetPageId());
-      leaf_neighbor->MoveLastToFrontOf(leaf_node);
-      parent->SetKeyAt(setindex, leaf_node->KeyAt(0));
-    } 
-    else{
-      setindex = 1;
-      leaf_neighbor->MoveFirstToEndOf(leaf_node);
-      parent->SetKeyAt(setindex, leaf_neighbor->KeyAt(0));
-    }
-    //buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(),true);
-    //buffer_pool_manager_->UnpinPage(leaf_neighbor->GetPageId(),true);
-    buffer_pool_manager_->UnpinPage(node->GetParentPageId(), true);
-  } 
-  else{
-    InternalPage* internal_node = reinterpret_cast<InternalPage*>(node);
-    InternalPage* internal_neighbor = reinterpret_cast<InternalPage*>(neighbor_node);
-    if(index){
-      setindex = parent->ValueIndex(internal_node->GetPageId());
-      internal_neighbor->MoveLastToFrontOf(internal_node, parent->KeyAt(setindex), buffer_pool_manager_);
-      parent->SetKeyAt(setindex, internal_node->KeyAt(0));
+  if constexpr (Format::SLOTTED) {
+    if (node->IsLeafPage()) {
+      auto leaf_node = reinterpret_cast<LeafPage *>(node);
+      auto leaf_neighbor = reinterpret_cast<LeafPage *>(neighbor_node);
+      if (index) {
+        leaf_neighbor->Redistribute(leaf_node, parent, index);
+      } else {
+        leaf_node->Redistribute(leaf_neighbor, parent, 1);
+      }
+    } else {
+      auto internal_node = reinterpret_cast<InternalPage *>(node);
+      auto internal_neighbor = reinterpret_cast<InternalPage *>(neighbor_node);
+      if (index) {
+        internal_neighbor->Redistribute(internal_node, parent->KeyAt(index), parent, index, buffer_pool_manager_);
+      } else {
+        internal_node->Redistribute(internal_neighbor, parent->KeyAt(1), parent, 1, buffer_pool_manager_);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  } else {
+    int setindex;
+    if(node->IsLeafPage()){
+      LeafPage* leaf_node = reinterpret_cast<LeafPage*>(node);
+      LeafPage* leaf_neighbor = reinterpret_cast<LeafPage*>(neighbor_node);
+      if(index){
+        setindex = parent->ValueIndex(leaf_node->GetPageId());
+        leaf_neighbor->MoveLastToFrontOf(leaf_node);
+        parent->SetKeyAt(setindex, leaf_node->KeyAt(0));
+      } 
+      else{
+        setindex = 1;
+        leaf_neighbor->MoveFirstToEndOf(leaf_node);
+        parent->SetKeyAt(setindex, leaf_neighbor->KeyAt(0));
+      }
+      //buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(),true);
+      //buffer_pool_manager_->UnpinPage(leaf_neighbor->GetPageId(),true);
+      buffer_pool_manager_->UnpinPage(node->GetParentPageId(), true);
     } 
     else{
-      setindex = 1;
-      internal_neighbor->MoveFirstToEndOf(internal_node, parent->KeyAt(setindex), buffer_pool_manager_);
-      parent->SetKeyAt(setindex, internal_neighbor->KeyAt(0));
+      InternalPage* internal_node = reinterpret_cast<InternalPage*>(node);
+      InternalPage* internal_neighbor = reinterpret_cast<InternalPage*>(neighbor_node);
+      if(index){
+        setindex = parent->ValueIndex(internal_node->GetPageId());
+        internal_neighbor->MoveLastToFrontOf(internal_node, parent->KeyAt(setindex), buffer_pool_manager_);
+        parent->SetKeyAt(setindex, internal_node->KeyAt(0));
+      } 
+      else{
+        setindex = 1;
+        internal_neighbor->MoveFirstToEndOf(internal_node, parent->KeyAt(setindex), buffer_pool_manager_);
+        parent->SetKeyAt(setindex, internal_neighbor->KeyAt(0));
+      }
+      //buffer_pool_manager_->UnpinPage(internal_node->GetPageId(),true);
+      //buffer_pool_manager_->UnpinPage(internal_neighbor->GetPageId(),true);
+      buffer_pool_manager_->UnpinPage(node->GetParentPageId(), true);
     }
-    //buffer_pool_manager_->UnpinPage(internal_node->GetPageId(),true);
-    //buffer_pool_manager_->UnpinPage(internal_neighbor->GetPageId(),true);
-    buffer_pool_manager_->UnpinPage(node->GetParentPageId(), true);
   }
   //Check();
 }
@@ -385,33 +649,29 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
  * case 1: when you delete the last element in root page, but root page still
  * has one last child
  * case 2: when you delete the last element in whole b+ tree
+ * The latch on the root id is held, since the root was not safe.
  * @return : true means root page should be deleted, false means no deletion
  * happened
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
-  bool flag = false;
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *transaction) {
   if(old_root_node->IsLeafPage() && old_root_node->GetSize() == 0){
     root_page_id_ = INVALID_PAGE_ID;
-    //buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), false);
-    buffer_pool_manager_->DeletePage(old_root_node->GetPageId());
     UpdateRootPageId(0);
-    flag = true;
+    transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+    return true;
   }
-  else if((!old_root_node->IsLeafPage()) && old_root_node->GetSize() == 1){
+  if((!old_root_node->IsLeafPage()) && old_root_node->GetSize() == 1){
     InternalPage *node = reinterpret_cast <InternalPage *> (old_root_node);
-    const page_id_t new_id = node->RemoveAndReturnOnlyChild();
-    root_page_id_ = new_id;
+    root_page_id_ = node->RemoveAndReturnOnlyChild();
     UpdateRootPageId(0);
-    auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-    InternalPage *new_root = reinterpret_cast<InternalPage *>(page);
+    auto new_root = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
     new_root->SetParentPageId(INVALID_PAGE_ID);
-    //buffer_pool_manager_->UnpinPage(new_root->GetPageId(), true);
-    //buffer_pool_manager_->UnpinPage(old_root_node->GetPageId(), false);
-    buffer_pool_manager_->DeletePage(old_root_node->GetPageId());
-    flag = true;
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    transaction->AddIntoDeletedPageSet(old_root_node->GetPageId());
+    return true;
   }
-  return flag;
+  return false;
 }
 
 /*****************************************************************************
@@ -424,12 +684,8 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
-  KeyType *t = new KeyType;
-  KeyType tmp = *t;
-  auto leaf_page = FindLeafPage(tmp, true);
-  auto leaf = reinterpret_cast<LeafPage *>(leaf_page);
-  delete t;
-  return INDEXITERATOR_TYPE(leaf, buffer_pool_manager_, 0);
+  Page *page = FindLeafPage(KeyType(), true);
+  return INDEXITERATOR_TYPE(this, page, buffer_pool_manager_, 0);
 }
 
 /*
@@ -439,37 +695,39 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  auto leaf_page = FindLeafPage(key, false);//wsx:true->false
-  auto leaf = reinterpret_cast<LeafPage *>(leaf_page);
+  Page *page = FindLeafPage(key);
+  int index = 0;
+  if (page != nullptr) {
+    index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  }
+  return INDEXITERATOR_TYPE(this, page, buffer_pool_manager_, index);
+}
+
+/*
+ * Construct an index iterator at the first pair whose key is greater than key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::UpperBound(const KeyType &key) {
+  Page *page = FindLeafPage(key);
   int index = 0;
-  if (leaf_page != nullptr) {
+  if (page != nullptr) {
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
     index = leaf->KeyIndex(key, comparator_);
+    if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+      index++;
+    }
   }
-  return INDEXITERATOR_TYPE(leaf, buffer_pool_manager_, index);
+  return INDEXITERATOR_TYPE(this, page, buffer_pool_manager_, index);
 }
 
 /*
  * Input parameter is void, construct an index iterator representing the end
- * of the key/value pair in the leaf node
+ * of the key/value pairs, past the last pair
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
-  auto root_page = reinterpret_cast <BPlusTreePage *> (buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  KeyType end_key;
-  if (root_page->IsLeafPage()) {
-    LeafPage *root_ = reinterpret_cast<LeafPage *>(root_page);
-    end_key = root_->KeyAt(root_->GetSize() - 1);
-  } 
-  else {
-    InternalPage *root_ = reinterpret_cast<InternalPage *>(root_page);
-    end_key = root_->KeyAt(root_->GetSize() - 1);
-  }
-  auto end = reinterpret_cast<LeafPage *> (FindLeafPage(end_key, false, true));//wsx加了个false参数
-  // auto end = reinterpret_cast<LeafPage *> (FindLeafPage(end_key));
-  buffer_pool_manager_->UnpinPage(root_page_id_, false);
-  return INDEXITERATOR_TYPE(end, buffer_pool_manager_, end->GetSize() - 1);
-  return INDEXITERATOR_TYPE();
+  return INDEXITERATOR_TYPE(this, nullptr, buffer_pool_manager_, -1);
 }
 
 /*****************************************************************************
@@ -478,39 +736,253 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
- * Note: the leaf page is pinned, you need to unpin it after use.
+ * Read latches are coupled down the tree, the latch of a node is released once
+ * its child is latched.
+ * Note: the leaf page is pinned and read latched, you need to unlatch and unpin
+ * it after use.
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool rightmost) {
-  if(IsEmpty()) return nullptr; 
- //printf("cd into FindLeafPage\n");
-  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-  BPlusTreePage* node = reinterpret_cast <BPlusTreePage *> (page->GetData());
-  while(!node->IsLeafPage()){
-    //printf("into loop\n");
-    auto internal = reinterpret_cast <InternalPage *> (node);
+  if (leftMost && rightmost) {
+    std::cout << "不能同时最左或最右\n";
+    return nullptr;
+  }
+  if (mode_ == BPlusTreeMode::kOptimistic) {
+    // only the leaf is latched, it is still the leaf found if it did not change since its copy was validated
+    alignas(8) char copy[PAGE_SIZE];
+    Page *page;
+    uint64_t version;
+    while (FindLeafPageOptimistic(key, leftMost, rightmost, page, version, copy)) {
+      page->RLatch();
+      if (page->ValidateVersion(version)) {
+        return page;
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    return nullptr;
+  }
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  page->RLatch();
+  root_latch_.RUnlock();
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
     page_id_t child_page_id;
-    if(!leftMost && !rightmost){
+    if (leftMost) {
+      child_page_id = internal->ValueAt(0);
+    } else if (rightmost) {
+      child_page_id = internal->ValueAt(internal->GetSize() - 1);
+    } else {
       child_page_id = internal->Lookup(key, comparator_);
     }
-    else if (leftMost && !rightmost){
-      child_page_id = internal->ValueAt(0);
+    Page *child = buffer_pool_manager_->FetchPage(child_page_id);
+    child->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = child;
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Find the leaf page of key without latches, for kOptimistic mode. Each page is
+ * read through a copy taken by ReadOptimistic, the child is looked up in the
+ * copy of its parent, and the version of the parent is validated again once the
+ * child is copied, so the child still was the one holding key then. Writers
+ * change the parent of every page they split or merge, so a failed validation
+ * restarts the lookup from the root.
+ * @return: false if the tree is empty, otherwise leaf is the leaf page, pinned
+ * and not latched, and leaf_copy holds its content at version
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, bool leftMost, bool rightmost, Page *&leaf,
+                                            uint64_t &version, char *leaf_copy) {
+  while (true) {
+    page_id_t root_id = root_page_id_;
+    if (root_id == INVALID_PAGE_ID) {
+      return false;
     }
-    else if (rightmost && !leftMost)
-    {
-      child_page_id = internal->ValueAt(internal->GetSize() - 1);
+    Page *page = buffer_pool_manager_->FetchPage(root_id);
+    bool valid = ReadOptimistic(page, version, leaf_copy) && root_page_id_ == root_id;
+    auto node = reinterpret_cast<BPlusTreePage *>(leaf_copy);
+    while (valid && !node->IsLeafPage()) {
+      auto internal = reinterpret_cast<InternalPage *>(node);
+      page_id_t child_page_id;
+      if (leftMost) {
+        child_page_id = internal->ValueAt(0);
+      } else if (rightmost) {
+        child_page_id = internal->ValueAt(internal->GetSize() - 1);
+      } else {
+        child_page_id = internal->Lookup(key, comparator_);
+      }
+      Page *child = buffer_pool_manager_->FetchPage(child_page_id);
+      uint64_t child_version;
+      valid = ReadOptimistic(child, child_version, leaf_copy) && page->ValidateVersion(version);
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = child;
+      version = child_version;
     }
-    else
-    {
-      std::cout << "不能同时最左或最右\n";
-      return nullptr;
+    if (valid) {
+      leaf = page;
+      return true;
     }
     buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    page = buffer_pool_manager_->FetchPage(child_page_id);
-    node = reinterpret_cast <BPlusTreePage *> (page->GetData());
+    // let the writer holding the page go on
+    std::this_thread::yield();
   }
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return page;
+}
+
+/*
+ * Copy the data of page to copy without a latch
+ * @return: false if a writer held the page or changed it during the copy, the
+ * copy must not be used then
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReadOptimistic(Page *page, uint64_t &version, char *copy) const {
+  version = page->GetVersion();
+  if (version & 1) {
+    return false;
+  }
+  memcpy(copy, page->GetData(), PAGE_SIZE);
+  return page->ValidateVersion(version);
+}
+
+/*
+ * Find the leaf page of key for an insert or remove, with write latches coupled
+ * down the tree. The latch on the root id and the latched pages are kept in the
+ * page set of transaction, all of them are released once a node is safe, i.e.
+ * it will not split for an insert or merge for a remove, so that only the
+ * pages the operation may change stay latched.
+ * @return: the leaf page, or nullptr if the tree is empty, the latch on the root
+ * id is held then
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageForWrite(const KeyType &key, LatchMode mode, Transaction *transaction) {
+  root_latch_.WLock();
+  transaction->AddIntoPageSet(nullptr);
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  while (true) {
+    page->WLatch();
+    auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, mode)) {
+      ReleaseLatches(transaction, false);
+    }
+    transaction->AddIntoPageSet(page);
+    if (node->IsLeafPage()) {
+      return page;
+    }
+    page = buffer_pool_manager_->FetchPage(reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_));
+  }
+}
+
+/*
+ * @return: true if the node does not split for an insert, or does not merge
+ * with a sibling for a remove
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, LatchMode mode) const {
+  if constexpr (Format::SLOTTED) {
+    auto leaf = reinterpret_cast<LeafPage *>(node);
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    if (mode == LatchMode::kInsert) {
+      return node->IsLeafPage() ? leaf->IsInsertSafe() : internal->IsInsertSafe();
+    }
+    if (!node->IsRootPage()) {
+      return node->IsLeafPage() ? leaf->IsRemoveSafe() : internal->IsRemoveSafe();
+    }
+  } else {
+    if (mode == LatchMode::kInsert) {
+      return node->GetSize() < node->GetMaxSize();
+    }
+    if (!node->IsRootPage()) {
+      return node->GetSize() > node->GetMinSize();
+    }
+  }
+  // a root leaf is deleted when empty, a root internal page when it has one child left
+  return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+}
+
+/*
+ * @return: true if the node is too full after an insert and must split
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsOverflow(BPlusTreePage *node) const {
+  if constexpr (Format::SLOTTED) {
+    return node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->IsOverflow()
+                              : reinterpret_cast<InternalPage *>(node)->IsOverflow();
+  } else {
+    return node->GetSize() > node->GetMaxSize();
+  }
+}
+
+/*
+ * @return: true if the node is under its min size after a remove and is merged
+ * or redistributed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsUnderflow(BPlusTreePage *node) const {
+  if constexpr (Format::SLOTTED) {
+    return node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->IsUnderflow()
+                              : reinterpret_cast<InternalPage *>(node)->IsUnderflow();
+  } else {
+    return node->GetSize() < node->GetMinSize();
+  }
+}
+
+/*
+ * @return: true if right fits in left, its left sibling, middle_key separates
+ * them in their parent
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template<typename N>
+bool BPLUSTREE_TYPE::CanMerge(N *left, N *right, const KeyType &middle_key) const {
+  if constexpr (Format::SLOTTED) {
+    if (left->IsLeafPage()) {
+      return reinterpret_cast<LeafPage *>(left)->CanMerge(reinterpret_cast<LeafPage *>(right));
+    }
+    return reinterpret_cast<InternalPage *>(left)->CanMerge(reinterpret_cast<InternalPage *>(right), middle_key);
+  } else {
+    return left->GetSize() + right->GetSize() <= left->GetMaxSize();
+  }
+}
+
+/*
+ * Release the latches in the page set of transaction and unpin the pages
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatches(Transaction *transaction, bool is_dirty) {
+  for (Page *page : *transaction->GetPageSet()) {
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  }
+  transaction->GetPageSet()->clear();
+}
+
+/*
+ * Delete the pages emptied by merges. An optimistic reader or an iterator may
+ * have pinned one before it found its parent changed, such a page is deleted
+ * by the buffer pool once the reader unpins it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePages(Transaction *transaction) {
+  for (page_id_t page_id : *transaction->GetDeletedPageSet()) {
+    buffer_pool_manager_->DeletePageWhenUnpinned(page_id);
+  }
+  transaction->GetDeletedPageSet()->clear();
 }
 
 /*
@@ -519,19 +991,21 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool right
  * Call this method everytime root page id is changed.
  * @parameter: insert_record      default value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
- * updating it.
+ * updating it, the record is updated if the index has one.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  auto root_page = reinterpret_cast <IndexRootsPage *> (buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
-  if (insert_record) root_page->Insert(index_id_, root_page_id_);
-  else root_page->Update(index_id_, root_page_id_);
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  // the roots of all indexes share the page
+  page->WLatch();
+  auto root_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (!insert_record || !root_page->Insert(index_id_, root_page_id_)) {
+    root_page->Update(index_id_, root_page_id_);
+  }
+  page->WUnlatch();
   buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
 }
 
-/**
- * This method is used for debug only, You don't need to modify
- */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const {
   std::string leaf_prefix("LEAF_");
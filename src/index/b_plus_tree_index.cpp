@@ -3,18 +3,61 @@
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
-                                     BufferPoolManager *buffer_pool_manager)
+                                     BufferPoolManager *buffer_pool_manager, BPlusTreeMode mode, bool unique,
+                                     uint32_t include_count)
         : Index(index_id, key_schema),
-          comparator_(key_schema_),
-          container_(index_id, buffer_pool_manager, comparator_) {
+          unique_(unique),
+          include_count_(include_count),
+          comparator_(key_schema_, unique),
+          container_(index_id, buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE, mode) {
 
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t BPLUSTREE_INDEX_TYPE::EncodeKey(const Row &key, const RowId &row_id, KeyType &index_key) const {
+  uint32_t size = index_key.SerializeFromKey(key, key_schema_);
+  if (size == KEY_TOO_LONG || (!unique_ && !index_key.AppendRowId(size, row_id))) {
+    return KEY_TOO_LONG;
+  }
+  if (include_count_ == 0) {
+    return size;
+  }
+  return index_key.GetEncodedSize(key_schema_, key_schema_->GetColumnCount() - include_count_);
+}
+
+/*
+ * The key with 0 bytes after its first key_size bytes sorts before all entries starting with them
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template<typename F>
+void BPLUSTREE_INDEX_TYPE::ScanPrefix(KeyType index_key, uint32_t key_size, F &&f) {
+  memset(index_key.data + key_size, 0, sizeof(index_key.data) - key_size);
+  for (auto iter = container_.Begin(index_key); iter != container_.End(); ++iter) {
+    if (memcmp((*iter).first.data, index_key.data, key_size) != 0 || !f(*iter)) {
+      break;
+    }
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  uint32_t key_size = EncodeKey(key, row_id, index_key);
+  if (key_size == KEY_TOO_LONG) {
+    return DB_FAILED;
+  }
+  if (unique_ && include_count_ > 0) {
+    // the included columns make keys that are equal differ in the tree, the key is looked up first
+    bool exists = false;
+    ScanPrefix(index_key, key_size, [&](const MappingType &) {
+      exists = true;
+      return false;
+    });
+    if (exists) {
+      return DB_FAILED;
+    }
+  }
 
   // std::cout << "BPLUSTREE_INDEX_TYPE::InsertEntry flag1\n";
 
@@ -30,8 +73,10 @@ dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transact
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, Transaction *txn) {
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
-
+  // a key too long for the index was never inserted
+  if (EncodeKey(key, key.GetRowId(), index_key) == KEY_TOO_LONG) {
+    return DB_SUCCESS;
+  }
   container_.Remove(index_key, txn);
   return DB_SUCCESS;
 }
@@ -39,11 +84,95 @@ dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, Transaction *txn) {
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
-  if (container_.GetValue(index_key, result, txn)) {
-    return DB_SUCCESS;
+  uint32_t key_size = index_key.SerializeFromKey(key, key_schema_);
+  if (key_size == KEY_TOO_LONG) {
+    return DB_KEY_NOT_FOUND;
   }
-  return DB_KEY_NOT_FOUND;
+  if (unique_ && include_count_ == 0) {
+    if (container_.GetValue(index_key, result, txn)) {
+      return DB_SUCCESS;
+    }
+    return DB_KEY_NOT_FOUND;
+  }
+  // the entries of the key start at the smallest included values and row id, they end at the first other key
+  size_t old_size = result.size();
+  ScanPrefix(index_key, key_size, [&](const MappingType &entry) {
+    result.push_back(entry.second);
+    return true;
+  });
+  return result.size() > old_size ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::BulkInsert(const std::function<bool(std::vector<Field> &, RowId &)> &next,
+                                         double fill_factor, Transaction *txn) {
+  if (!container_.IsEmpty()) {
+    return Index::BulkInsert(next, fill_factor, txn);
+  }
+  ExternalSorter<KeyType, ValueType, KeyComparator> sorter(comparator_, sort_memory_);
+  std::vector<Field> key_fields;
+  RowId row_id;
+  KeyType index_key;
+  while (next(key_fields, row_id)) {
+    ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+    if (EncodeKey(Row(key_fields), row_id, index_key) == KEY_TOO_LONG) {
+      return DB_FAILED;
+    }
+    sorter.Add(index_key, row_id);
+  }
+  sorter.Finish();
+  container_.BulkLoad(sorter, fill_factor);
+  return DB_SUCCESS;
+}
+
+/*
+ * An exclusive lower bound seeks past the entries starting with it, the bytes after it are all 0xff. A bound too
+ * long for the keys has no place in the key order, the scan fails before calling callback.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::ScanRange(const Row *lower, const Row *upper, bool lower_inclusive,
+                                        bool upper_inclusive, const ScanCallback &callback, Transaction *txn,
+                                        bool decode_keys) {
+  KeyType lower_key, upper_key;
+  uint32_t lower_size = 0, upper_size = 0;
+  if (lower != nullptr) {
+    lower_size = lower_key.SerializeFromKey(*lower, key_schema_);
+    if (lower_size == KEY_TOO_LONG) {
+      return DB_FAILED;
+    }
+    if (!lower_inclusive) {
+      memset(lower_key.data + lower_size, 0xff, sizeof(lower_key.data) - lower_size);
+    }
+  }
+  if (upper != nullptr) {
+    upper_size = upper_key.SerializeFromKey(*upper, key_schema_);
+    if (upper_size == KEY_TOO_LONG) {
+      return DB_FAILED;
+    }
+  }
+  Row key;
+  for (auto iter = lower != nullptr ? container_.Begin(lower_key) : container_.Begin(); iter != container_.End();
+       ++iter) {
+    const MappingType &entry = *iter;
+    // an entry equal to the seek key still starts with the bound
+    if (lower != nullptr && !lower_inclusive && memcmp(entry.first.data, lower_key.data, lower_size) == 0) {
+      continue;
+    }
+    if (upper != nullptr) {
+      int cmp = memcmp(entry.first.data, upper_key.data, upper_size);
+      if (cmp > 0 || (cmp == 0 && !upper_inclusive)) {
+        break;
+      }
+    }
+    if (decode_keys) {
+      entry.first.DeserializeToKey(key, key_schema_);
+      key.SetRowId(entry.second);
+    }
+    if (!callback(entry.second, decode_keys ? &key : nullptr)) {
+      break;
+    }
+  }
+  return DB_SUCCESS;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -0,0 +1,374 @@
+#include <unordered_set>
+
+#include "index/extendible_hash_index.h"
+#include "page/index_roots_page.h"
+#include "utils/hyper_log_log.h"
+
+template<size_t KeySize>
+ExtendibleHashIndex<KeySize>::ExtendibleHashIndex(index_id_t index_id, IndexSchema *key_schema,
+                                                  BufferPoolManager *buffer_pool_manager, bool unique,
+                                                  uint32_t include_count)
+        : Index(index_id, key_schema),
+          buffer_pool_manager_(buffer_pool_manager),
+          unique_(unique),
+          include_count_(include_count) {
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  // the roots of all indexes share the page
+  page->WLatch();
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(page->GetData());
+  if (!roots_page->GetRootId(index_id_, &directory_page_id_)) {
+    page_id_t bucket_page_id;
+    auto bucket = reinterpret_cast<BucketPage *>(buffer_pool_manager_->NewPage(bucket_page_id)->GetData());
+    bucket->Init();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    auto directory =
+            reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(directory_page_id_)->GetData());
+    directory->Init(directory_page_id_, bucket_page_id);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    roots_page->Insert(index_id_, directory_page_id_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+template<size_t KeySize>
+uint32_t ExtendibleHashIndex<KeySize>::EncodeKey(const Row &key, KeyType &index_key) const {
+  uint32_t size = index_key.SerializeFromKey(key, key_schema_);
+  if (size == KEY_TOO_LONG || include_count_ == 0) {
+    return size;
+  }
+  return index_key.GetEncodedSize(key_schema_, key_schema_->GetColumnCount() - include_count_);
+}
+
+/*
+ * The hash is kept on disk in the layout of the directory, so it must not change between builds as std::hash may
+ */
+template<size_t KeySize>
+uint32_t ExtendibleHashIndex<KeySize>::Hash(const KeyType &index_key, uint32_t key_size) {
+  return static_cast<uint32_t>(HyperLogLog::Hash(index_key.data, key_size));
+}
+
+template<size_t KeySize>
+uint32_t ExtendibleHashIndex<KeySize>::EntryHash(const KeyType &index_key) const {
+  return Hash(index_key, index_key.GetEncodedSize(key_schema_, key_schema_->GetColumnCount() - include_count_));
+}
+
+template<size_t KeySize>
+typename ExtendibleHashIndex<KeySize>::BucketPage *ExtendibleHashIndex<KeySize>::FetchBucket(page_id_t bucket_page_id) {
+  return reinterpret_cast<BucketPage *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
+}
+
+/*
+ * The entries of a key are those whose encoding starts with the key_size bytes of the key columns, whatever their
+ * included values are
+ */
+template<size_t KeySize>
+dberr_t ExtendibleHashIndex<KeySize>::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_FAILED;
+  }
+  KeyType index_key;
+  uint32_t key_size = EncodeKey(key, index_key);
+  if (key_size == KEY_TOO_LONG) {
+    return DB_FAILED;
+  }
+  uint32_t hash = Hash(index_key, key_size);
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->WLatch();
+  auto directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  dberr_t ret = DB_SUCCESS;
+  for (;;) {
+    uint32_t bucket_idx = hash & directory->GetGlobalDepthMask();
+    page_id_t free_page_id = INVALID_PAGE_ID, last_page_id = INVALID_PAGE_ID;
+    bool exists = false;
+    for (page_id_t page_id = directory->GetBucketPageId(bucket_idx); page_id != INVALID_PAGE_ID && !exists;) {
+      BucketPage *bucket = FetchBucket(page_id);
+      for (int i = 0; i < bucket->GetSize() && !exists; i++) {
+        const auto &entry = bucket->GetItem(i);
+        exists = memcmp(entry.first.data, index_key.data, key_size) == 0 && (unique_ || entry.second == row_id);
+      }
+      if (free_page_id == INVALID_PAGE_ID && !bucket->IsFull()) {
+        free_page_id = page_id;
+      }
+      last_page_id = page_id;
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    if (exists) {
+      ret = DB_FAILED;
+      break;
+    }
+    if (free_page_id != INVALID_PAGE_ID) {
+      BucketPage *bucket = FetchBucket(free_page_id);
+      bucket->Append(index_key, row_id);
+      buffer_pool_manager_->UnpinPage(free_page_id, true);
+      break;
+    }
+    // more hash bits only tell the entries apart if their hashes differ, otherwise the bucket overflows
+    bool same_hash = true;
+    for (page_id_t page_id = directory->GetBucketPageId(bucket_idx); page_id != INVALID_PAGE_ID && same_hash;) {
+      BucketPage *bucket = FetchBucket(page_id);
+      for (int i = 0; i < bucket->GetSize() && same_hash; i++) {
+        same_hash = EntryHash(bucket->GetItem(i).first) == hash;
+      }
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    if (!same_hash && SplitBucket(directory, bucket_idx)) {
+      continue;
+    }
+    page_id_t overflow_page_id;
+    Page *overflow_page = buffer_pool_manager_->NewPage(overflow_page_id);
+    if (overflow_page == nullptr) {
+      ret = DB_FAILED;
+      break;
+    }
+    auto overflow = reinterpret_cast<BucketPage *>(overflow_page->GetData());
+    overflow->Init();
+    overflow->Append(index_key, row_id);
+    buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+    FetchBucket(last_page_id)->SetNextPageId(overflow_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    break;
+  }
+  directory_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  return ret;
+}
+
+template<size_t KeySize>
+dberr_t ExtendibleHashIndex<KeySize>::RemoveEntry(const Row &key, Transaction *txn) {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  KeyType index_key;
+  uint32_t key_size = EncodeKey(key, index_key);
+  if (key_size == KEY_TOO_LONG) {
+    // a key too long for the index was never inserted
+    return DB_SUCCESS;
+  }
+  uint32_t hash = Hash(index_key, key_size);
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->WLatch();
+  auto directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  uint32_t bucket_idx = hash & directory->GetGlobalDepthMask();
+  bool removed = false;
+  for (page_id_t page_id = directory->GetBucketPageId(bucket_idx), prev_page_id = INVALID_PAGE_ID;
+       page_id != INVALID_PAGE_ID && !removed;) {
+    BucketPage *bucket = FetchBucket(page_id);
+    for (int i = 0; i < bucket->GetSize() && !removed; i++) {
+      const auto &entry = bucket->GetItem(i);
+      if (memcmp(entry.first.data, index_key.data, key_size) == 0 && (unique_ || entry.second == key.GetRowId())) {
+        bucket->RemoveAt(i);
+        removed = true;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    bool empty = removed && bucket->GetSize() == 0;
+    buffer_pool_manager_->UnpinPage(page_id, removed);
+    if (empty && prev_page_id != INVALID_PAGE_ID) {
+      // an empty overflow page leaves the chain
+      FetchBucket(prev_page_id)->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->DeletePage(page_id);
+    } else if (empty && next_page_id == INVALID_PAGE_ID) {
+      MergeBucket(directory, bucket_idx);
+    }
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  directory_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, removed);
+  return DB_SUCCESS;
+}
+
+template<size_t KeySize>
+dberr_t ExtendibleHashIndex<KeySize>::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn) {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_KEY_NOT_FOUND;
+  }
+  KeyType index_key;
+  uint32_t key_size = index_key.SerializeFromKey(key, key_schema_);
+  if (key_size == KEY_TOO_LONG) {
+    return DB_KEY_NOT_FOUND;
+  }
+  uint32_t hash = Hash(index_key, key_size);
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  auto directory = reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  size_t old_size = result.size();
+  bool done = false;
+  for (page_id_t page_id = directory->GetBucketPageId(hash & directory->GetGlobalDepthMask());
+       page_id != INVALID_PAGE_ID && !done;) {
+    BucketPage *bucket = FetchBucket(page_id);
+    for (int i = 0; i < bucket->GetSize() && !done; i++) {
+      const auto &entry = bucket->GetItem(i);
+      if (memcmp(entry.first.data, index_key.data, key_size) == 0) {
+        result.push_back(entry.second);
+        // a unique index has one entry of the key
+        done = unique_;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return result.size() > old_size ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+template<size_t KeySize>
+dberr_t ExtendibleHashIndex<KeySize>::Destroy() {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return DB_SUCCESS;
+  }
+  auto directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  std::unordered_set<page_id_t> bucket_page_ids;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    bucket_page_ids.insert(directory->GetBucketPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  for (auto bucket_page_id : bucket_page_ids) {
+    TakeEntries(bucket_page_id, entries);
+    entries.clear();
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+  }
+  buffer_pool_manager_->DeletePage(directory_page_id_);
+  Page *page = buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID);
+  page->WLatch();
+  reinterpret_cast<IndexRootsPage *>(page->GetData())->Delete(index_id_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  directory_page_id_ = INVALID_PAGE_ID;
+  return DB_SUCCESS;
+}
+
+template<size_t KeySize>
+uint32_t ExtendibleHashIndex<KeySize>::GetGlobalDepth() {
+  auto directory =
+          reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  uint32_t global_depth = directory->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return global_depth;
+}
+
+/*
+ * The slots of the bucket whose next hash bit is 1 point to a new bucket, the entries are spread over both
+ */
+template<size_t KeySize>
+bool ExtendibleHashIndex<KeySize>::SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == directory->GetGlobalDepth()) {
+    if (!directory->CanGrow()) {
+      return false;
+    }
+    directory->IncrGlobalDepth();
+  }
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx), new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+  if (new_page == nullptr) {
+    return false;
+  }
+  reinterpret_cast<BucketPage *>(new_page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  uint32_t high_bit = 1u << local_depth;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) != bucket_page_id) {
+      continue;
+    }
+    directory->SetLocalDepth(i, local_depth + 1);
+    if (i & high_bit) {
+      directory->SetBucketPageId(i, new_page_id);
+    }
+  }
+  std::vector<std::pair<KeyType, ValueType>> entries, low_entries, high_entries;
+  TakeEntries(bucket_page_id, entries);
+  for (auto &entry : entries) {
+    (EntryHash(entry.first) & high_bit ? high_entries : low_entries).push_back(entry);
+  }
+  FillBucket(bucket_page_id, low_entries);
+  FillBucket(new_page_id, high_entries);
+  return true;
+}
+
+template<size_t KeySize>
+void ExtendibleHashIndex<KeySize>::MergeBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  uint32_t image_idx = directory->GetSplitImageIndex(bucket_idx);
+  if (local_depth == 0 || directory->GetLocalDepth(image_idx) != local_depth) {
+    return;
+  }
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == bucket_page_id || directory->GetBucketPageId(i) == image_page_id) {
+      directory->SetBucketPageId(i, image_page_id);
+      directory->SetLocalDepth(i, local_depth - 1);
+    }
+  }
+  buffer_pool_manager_->DeletePage(bucket_page_id);
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+}
+
+template<size_t KeySize>
+void ExtendibleHashIndex<KeySize>::TakeEntries(page_id_t bucket_page_id,
+                                               std::vector<std::pair<KeyType, ValueType>> &entries) {
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    BucketPage *bucket = FetchBucket(page_id);
+    for (int i = 0; i < bucket->GetSize(); i++) {
+      entries.push_back(bucket->GetItem(i));
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (page_id == bucket_page_id) {
+      bucket->Init();
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    } else {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    page_id = next_page_id;
+  }
+}
+
+template<size_t KeySize>
+void ExtendibleHashIndex<KeySize>::FillBucket(page_id_t bucket_page_id,
+                                              const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  page_id_t page_id = bucket_page_id;
+  BucketPage *bucket = FetchBucket(page_id);
+  for (auto &entry : entries) {
+    if (bucket->IsFull()) {
+      page_id_t overflow_page_id;
+      auto overflow = reinterpret_cast<BucketPage *>(buffer_pool_manager_->NewPage(overflow_page_id)->GetData());
+      overflow->Init();
+      bucket->SetNextPageId(overflow_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      page_id = overflow_page_id;
+      bucket = overflow;
+    }
+    bucket->Append(entry.first, entry.second);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+template
+class ExtendibleHashIndex<4>;
+
+template
+class ExtendibleHashIndex<8>;
+
+template
+class ExtendibleHashIndex<16>;
+
+template
+class ExtendibleHashIndex<32>;
+
+template
+class ExtendibleHashIndex<64>;
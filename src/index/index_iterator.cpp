@@ -1,41 +1,124 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
 #include "index/index_iterator.h"
+#include "index/b_plus_tree.h"
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() {
+  tree_ = nullptr;
+  page_ = nullptr;
   leaf_ = nullptr;
   buffer_pool_manager_ = nullptr;
   index_ = -1;
 }
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf, BufferPoolManager *buffer_pool_manager, int index){
-  leaf_ = leaf;
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree,
+                                                           Page *page, BufferPoolManager *buffer_pool_manager,
+                                                           int index) {
+  tree_ = tree;
+  page_ = page;
+  leaf_ = page == nullptr ? nullptr : reinterpret_cast<LeafPage *>(page->GetData());
   buffer_pool_manager_ = buffer_pool_manager;
-  index_ = index;
+  index_ = page == nullptr ? -1 : index;
+  SkipToValid();
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(const IndexIterator &other)
+        : tree_(other.tree_), page_(other.page_), leaf_(other.leaf_),
+          buffer_pool_manager_(other.buffer_pool_manager_), index_(other.index_) {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->FetchPage(page_->GetPageId());
+    page_->RLatch();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+        : tree_(other.tree_), page_(other.page_), leaf_(other.leaf_),
+          buffer_pool_manager_(other.buffer_pool_manager_), index_(other.index_) {
+  other.page_ = nullptr;
+  other.leaf_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(const IndexIterator &other) {
+  if (this != &other) {
+    *this = IndexIterator(other);
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    Release();
+    tree_ = other.tree_;
+    page_ = other.page_;
+    leaf_ = other.leaf_;
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    index_ = other.index_;
+    other.page_ = nullptr;
+    other.leaf_ = nullptr;
+  }
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
+  Release();
+}
 
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+    leaf_ = nullptr;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() {
-  return leaf_->GetItem(index_);
+  if constexpr (Format::SLOTTED) {
+    item_ = leaf_->GetItem(index_);
+    return item_;
+  } else {
+    return leaf_->GetItem(index_);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   index_ += 1;
-  if (index_ >= leaf_->GetSize()) {
-    if (leaf_->GetNextPageId() == INVALID_PAGE_ID){
+  SkipToValid();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::SkipToValid() {
+  while (leaf_ != nullptr && index_ >= leaf_->GetSize()) {
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      // past the end
+      Release();
       index_ = -1;
+      break;
     }
-    else{
-      auto page = buffer_pool_manager_->FetchPage(leaf_->GetNextPageId());
-      leaf_ = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page);
+    Page *next = buffer_pool_manager_->FetchPage(next_page_id);
+    if (next->TryRLatch()) {
+      Release();
+      page_ = next;
+      leaf_ = reinterpret_cast<LeafPage *>(next->GetData());
       index_ = 0;
-      buffer_pool_manager_->UnpinPage(leaf_->GetNextPageId(), false);
+      continue;
     }
+    // a writer holding the next leaf may be waiting for this one, let it go and search again
+    buffer_pool_manager_->UnpinPage(next_page_id, false);
+    if constexpr (Format::SLOTTED) {
+      if (leaf_->GetSize() == 0) {
+        // no key of the leaf was passed, all keys before it were
+        auto low = leaf_->GetLowFence();
+        Release();
+        *this = low.bounded_ ? tree_->Begin(low.key_) : tree_->Begin();
+        continue;
+      }
+    }
+    KeyType last_key = leaf_->KeyAt(leaf_->GetSize() - 1);
+    Release();
+    *this = tree_->UpperBound(last_key);
   }
-  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
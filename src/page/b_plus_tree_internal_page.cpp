@@ -1,5 +1,6 @@
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/key_search.h"
 #include "page/b_plus_tree_internal_page.h"
 
 /*****************************************************************************
@@ -69,12 +70,8 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  for(int i = 1; i < GetSize(); ++i){
-    if(comparator(key, array_[i].first) < 0){
-      return array_[i-1].second;
-    }
-  }
-  return array_[GetSize() - 1].second;
+  // the child left of the first key greater than key
+  return array_[KeyUpperBound(array_, 1, GetSize(), key, comparator) - 1].second;
 }
 
 /*****************************************************************************
@@ -113,6 +110,15 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
   return sz+1;
 }
 
+/*
+ * Append key & value pair after the last pair, the key of the first pair is not used
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  array_[GetSize()] = MappingType(key, value);
+  IncreaseSize(1);
+}
+
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
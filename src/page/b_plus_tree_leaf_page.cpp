@@ -1,6 +1,7 @@
 #include <algorithm>
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
+#include "index/key_search.h"
 #include "page/b_plus_tree_leaf_page.h"
 
 /*****************************************************************************
@@ -41,15 +42,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int sz = GetSize();
-  int flag = sz;
-  for(int i = 0; i < sz; i++){
-    if(comparator(array_[i].first, key) >= 0){
-      flag = i;
-      break;
-    }
-  }
-  return flag;
+  return KeyLowerBound(array_, 0, GetSize(), key, comparator);
 }
 
 /*
@@ -61,6 +54,11 @@ KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
   return array_[index].first;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::LowKey() const {
+  return array_[0].first;
+}
+
 /*
  * Helper method to find and return the key & value pair associated with input
  * "index"(a.k.a array offset)
@@ -80,16 +78,26 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
   int sz = GetSize();
-  for (int i = sz-1; i >= KeyIndex(key, comparator); i--) {
+  int index = KeyIndex(key, comparator);
+  for (int i = sz-1; i >= index; i--) {
     array_[i+1].first = array_[i].first;
     array_[i+1].second = array_[i].second;
   }
-  array_[KeyIndex(key, comparator)].first = key;
-  array_[KeyIndex(key, comparator)].second = value;
+  array_[index].first = key;
+  array_[index].second = value;
   IncreaseSize(1);
   return sz+1;
 }
 
+/*
+ * Append key & value pair after the last pair, key must be larger than all keys in the page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  array_[GetSize()] = MappingType(key, value);
+  IncreaseSize(1);
+}
+
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
@@ -127,16 +135,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  int sz = GetSize();
-  bool flag = false;
-  for(int i = 0; i < sz; i++){
-    if(comparator(array_[i].first, key) == 0){
-      value = array_[i].second;
-      flag = true;
-      break;
-    }
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
   }
-  return flag;
+  value = array_[index].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -151,16 +155,8 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
   int sz = GetSize();
-  bool flag = false;
-  int flagi;
-  for(int i = 0; i < sz; i++){
-    if(comparator(array_[i].first, key) == 0){
-      flag = true;
-      flagi = i;
-      break;
-    }
-  }
-  if(flag){
+  int flagi = KeyIndex(key, comparator);
+  if(flagi < sz && comparator(array_[flagi].first, key) == 0){
     for(int i = flagi; i < sz - 1; i++){
       array_[i] = array_[i+1];
     }
@@ -0,0 +1,175 @@
+#include "index/generic_key.h"
+#include "page/b_plus_tree_slotted_internal_page.h"
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  B_PLUS_TREE_SLOTTED_PAGE_TYPE::Init(IndexPageType::INTERNAL_PAGE, page_id, parent_id, max_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < this->GetSize(); i++) {
+    if (this->ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Search from the second key, the child left of the first key greater than key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
+  return this->ValueAt(this->UpperBound(key, 1) - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Adopt(int begin, int end, BufferPoolManager *buffer_pool_manager) {
+  for (int i = begin; i < end; i++) {
+    auto child_page = buffer_pool_manager->FetchPage(this->ValueAt(i));
+    reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(this->GetPageId());
+    buffer_pool_manager->UnpinPage(child_page->GetPageId(), true);
+  }
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVE
+ *****************************************************************************/
+/*
+ * The new root has unbounded fences, so its keys have no prefix
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                             const ValueType &new_value) {
+  this->InsertAt(0, new_key, old_value);
+  this->InsertAt(1, new_key, new_value);
+}
+
+/*
+ * @return:  new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                            const ValueType &new_value) {
+  this->InsertAt(ValueIndex(old_value) + 1, new_key, new_value);
+  return this->GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  this->InsertAt(this->GetSize(), key, value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Remove(int index) {
+  this->RemoveAt(index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
+  ValueType child = this->ValueAt(0);
+  this->RemoveAt(0);
+  return child;
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Move the second half of the bytes of the children to recipient, the new right
+ * sibling. The key of the first child moved goes up to the parent, it becomes
+ * the high fence of this page and the low fence of recipient.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeSlottedInternalPage *recipient,
+                                                        BufferPoolManager *buffer_pool_manager) {
+  std::vector<MappingType> entries;
+  this->GetEntries(entries);
+  auto low = this->GetLowFence();
+  auto high = this->GetHighFence();
+  int size = static_cast<int>(entries.size());
+  int half = this->SplitPoint(entries.data(), size, this->GetPrefixLength(), false);
+  KeyType middle_key = entries[half].first;
+  this->Rebuild(entries.data(), half, low.Get(), &middle_key);
+  recipient->Rebuild(entries.data() + half, size - half, &middle_key, high.Get());
+  recipient->Adopt(0, size - half, buffer_pool_manager);
+}
+
+/*
+ * The middle_key from the parent is kept as the key of the first child of right
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::CanMerge(const BPlusTreeSlottedInternalPage *right,
+                                                      const KeyType &middle_key) const {
+  uint32_t prefix_length = this->PrefixLength(this->GetLowFence().Get(), right->GetHighFence().Get());
+  return this->Fits(this->GetBytesWithPrefix(prefix_length) + right->GetBytesWithPrefix(prefix_length) +
+                    this->KeyBytes(middle_key, prefix_length));
+}
+
+/*
+ * Move all children of this page to recipient, its left sibling, middle_key
+ * separates them in the parent
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeSlottedInternalPage *recipient,
+                                                       const KeyType &middle_key,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  std::vector<MappingType> entries;
+  recipient->GetEntries(entries);
+  int recipient_size = static_cast<int>(entries.size());
+  this->GetEntries(entries);
+  entries[recipient_size].first = middle_key;
+  int size = static_cast<int>(entries.size());
+  recipient->Rebuild(entries.data(), size, recipient->GetLowFence().Get(), this->GetHighFence().Get());
+  recipient->Adopt(recipient_size, size, buffer_pool_manager);
+  this->SetSize(0);
+}
+
+/*
+ * Spread the children of this page and right, its right sibling at index of
+ * parent separated by middle_key, evenly over both pages and set the new middle
+ * key in parent.
+ * @return: false if nothing moved, since the pages or parent would not fit
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_INTERNAL_PAGE_TYPE::Redistribute(BPlusTreeSlottedInternalPage *right,
+                                                          const KeyType &middle_key,
+                                                          BPlusTreeSlottedInternalPage *parent, int index,
+                                                          BufferPoolManager *buffer_pool_manager) {
+  std::vector<MappingType> entries;
+  this->GetEntries(entries);
+  int left_size = static_cast<int>(entries.size());
+  right->GetEntries(entries);
+  entries[left_size].first = middle_key;
+  int size = static_cast<int>(entries.size());
+  auto low = this->GetLowFence();
+  auto high = right->GetHighFence();
+  int half = this->SplitPoint(entries.data(), size, this->PrefixLength(low.Get(), high.Get()), false);
+  KeyType new_middle_key = entries[half].first;
+  if (half == left_size ||
+      !this->Fits(this->EntriesBytes(entries.data(), half, this->PrefixLength(low.Get(), &new_middle_key), false)) ||
+      !this->Fits(this->EntriesBytes(entries.data() + half, size - half,
+                                     this->PrefixLength(&new_middle_key, high.Get()), false)) ||
+      !parent->CanSetKeyAt(index, new_middle_key)) {
+    return false;
+  }
+  this->Rebuild(entries.data(), half, low.Get(), &new_middle_key);
+  right->Rebuild(entries.data() + half, size - half, &new_middle_key, high.Get());
+  parent->SetKeyAt(index, new_middle_key);
+  if (half > left_size) {
+    Adopt(left_size, half, buffer_pool_manager);
+  } else {
+    right->Adopt(0, left_size - half, buffer_pool_manager);
+  }
+  return true;
+}
+
+template
+class BPlusTreeSlottedInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+
+template
+class BPlusTreeSlottedInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
@@ -0,0 +1,161 @@
+#include "index/generic_key.h"
+#include "page/b_plus_tree_slotted_leaf_page.h"
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  B_PLUS_TREE_SLOTTED_PAGE_TYPE::Init(IndexPageType::LEAF_PAGE, page_id, parent_id, max_size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::GetNextPageId() const {
+  return this->next_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  this->next_page_id_ = next_page_id;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::LowKey() const {
+  return this->GetLowFence().key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return this->LowerBound(key, 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::GetItem(int index) const {
+  return MappingType(this->KeyAt(index), this->ValueAt(index));
+}
+
+/*****************************************************************************
+ * INSERTION, LOOKUP AND REMOVE
+ *****************************************************************************/
+/*
+ * @return page size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                               const KeyComparator &comparator) {
+  this->InsertAt(KeyIndex(key, comparator), key, value);
+  return this->GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value,
+                                                const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index == this->GetSize() || comparator(this->KeyAt(index), key) != 0) {
+    return false;
+  }
+  value = this->ValueAt(index);
+  return true;
+}
+
+/*
+ * @return page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index < this->GetSize() && comparator(this->KeyAt(index), key) == 0) {
+    this->RemoveAt(index);
+  }
+  return this->GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  this->InsertAt(this->GetSize(), key, value);
+}
+
+/*****************************************************************************
+ * SPLIT, MERGE AND REDISTRIBUTE
+ *****************************************************************************/
+/*
+ * Move the second half of the bytes of the pairs to recipient, the new right
+ * sibling. The pages are separated by the shortest key greater than the last key
+ * of this page, which becomes the high fence of this page and the low fence of
+ * recipient.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeSlottedLeafPage *recipient) {
+  std::vector<MappingType> entries;
+  this->GetEntries(entries);
+  auto low = this->GetLowFence();
+  auto high = this->GetHighFence();
+  int size = static_cast<int>(entries.size());
+  int half = this->SplitPoint(entries.data(), size, this->GetPrefixLength(), true);
+  KeyType separator = this->Separator(entries[half - 1].first, entries[half].first);
+  this->Rebuild(entries.data(), half, low.Get(), &separator);
+  recipient->Rebuild(entries.data() + half, size - half, &separator, high.Get());
+  recipient->SetNextPageId(GetNextPageId());
+  SetNextPageId(recipient->GetPageId());
+}
+
+/*
+ * The merged page has the fences of both pages, its prefix may be shorter than
+ * theirs
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::CanMerge(const BPlusTreeSlottedLeafPage *right) const {
+  uint32_t prefix_length = this->PrefixLength(this->GetLowFence().Get(), right->GetHighFence().Get());
+  return this->Fits(this->GetBytesWithPrefix(prefix_length) + right->GetBytesWithPrefix(prefix_length));
+}
+
+/*
+ * Move all pairs of this page to recipient, its left sibling
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeSlottedLeafPage *recipient) {
+  std::vector<MappingType> entries;
+  recipient->GetEntries(entries);
+  this->GetEntries(entries);
+  recipient->Rebuild(entries.data(), static_cast<int>(entries.size()), recipient->GetLowFence().Get(),
+                     this->GetHighFence().Get());
+  recipient->SetNextPageId(GetNextPageId());
+  this->SetSize(0);
+}
+
+/*
+ * Spread the pairs of this page and right, its right sibling at index of parent,
+ * evenly over both pages and set the new separator in parent.
+ * @return: false if nothing moved, since the pages or parent would not fit
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_LEAF_PAGE_TYPE::Redistribute(BPlusTreeSlottedLeafPage *right, ParentPage *parent,
+                                                      int index) {
+  std::vector<MappingType> entries;
+  this->GetEntries(entries);
+  right->GetEntries(entries);
+  int size = static_cast<int>(entries.size());
+  if (size < 2) {
+    return false;
+  }
+  auto low = this->GetLowFence();
+  auto high = right->GetHighFence();
+  int half = this->SplitPoint(entries.data(), size, this->PrefixLength(low.Get(), high.Get()), true);
+  KeyType separator = this->Separator(entries[half - 1].first, entries[half].first);
+  if (!this->Fits(this->EntriesBytes(entries.data(), half, this->PrefixLength(low.Get(), &separator), true)) ||
+      !this->Fits(this->EntriesBytes(entries.data() + half, size - half, this->PrefixLength(&separator, high.Get()),
+                                     true)) ||
+      !parent->CanSetKeyAt(index, separator)) {
+    return false;
+  }
+  this->Rebuild(entries.data(), half, low.Get(), &separator);
+  right->Rebuild(entries.data() + half, size - half, &separator, high.Get());
+  parent->SetKeyAt(index, separator);
+  return true;
+}
+
+template
+class BPlusTreeSlottedLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class BPlusTreeSlottedLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
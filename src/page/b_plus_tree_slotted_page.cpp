@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <cstring>
+#include "index/generic_key.h"
+#include "page/b_plus_tree_slotted_page.h"
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/*
+ * Init method after creating a new slotted page, the page has no entries and
+ * unbounded fences
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::Init(IndexPageType page_type, page_id_t page_id, page_id_t parent_id,
+                                         int max_size) {
+  SetPageType(page_type);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
+  next_page_id_ = INVALID_PAGE_ID;
+  heap_begin_ = PAGE_SIZE;
+  dead_bytes_ = 0;
+  SetFences(nullptr, nullptr);
+}
+
+/*
+ * Helper method to rebuild the key at index from the prefix and its suffix, the
+ * first key of an internal page is its low fence
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_SLOTTED_PAGE_TYPE::KeyAt(int index) const {
+  KeyType key;
+  if (!HasKey(index)) {
+    memcpy(key.data, low_fence_, KEY_SIZE);
+    return key;
+  }
+  memset(key.data, 0, KEY_SIZE);
+  memcpy(key.data, low_fence_, prefix_length_);
+  memcpy(key.data + prefix_length_, Data() + slots_[index].offset_, slots_[index].length_);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_SLOTTED_PAGE_TYPE::ValueAt(int index) const {
+  ValueType value;
+  memcpy(&value, Data() + slots_[index].offset_ + slots_[index].length_, sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  memcpy(Data() + slots_[index].offset_ + slots_[index].length_, &value, sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename B_PLUS_TREE_SLOTTED_PAGE_TYPE::Fence B_PLUS_TREE_SLOTTED_PAGE_TYPE::GetLowFence() const {
+  Fence fence;
+  fence.bounded_ = fence_flags_ & LOW_BOUNDED;
+  memcpy(fence.key_.data, low_fence_, KEY_SIZE);
+  return fence;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename B_PLUS_TREE_SLOTTED_PAGE_TYPE::Fence B_PLUS_TREE_SLOTTED_PAGE_TYPE::GetHighFence() const {
+  Fence fence;
+  fence.bounded_ = fence_flags_ & HIGH_BOUNDED;
+  memcpy(fence.key_.data, high_fence_, KEY_SIZE);
+  return fence;
+}
+
+/*
+ * Set the fences and the prefix they share, an unbounded fence is kept as 0
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::SetFences(const KeyType *low, const KeyType *high) {
+  fence_flags_ = (low != nullptr ? LOW_BOUNDED : 0) | (high != nullptr ? HIGH_BOUNDED : 0);
+  memset(low_fence_, 0, KEY_SIZE);
+  memset(high_fence_, 0, KEY_SIZE);
+  if (low != nullptr) {
+    memcpy(low_fence_, low->data, KEY_SIZE);
+  }
+  if (high != nullptr) {
+    memcpy(high_fence_, high->data, KEY_SIZE);
+  }
+  prefix_length_ = PrefixLength(low, high);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::GetUsedBytes() const {
+  return GetSize() * SLOT_SIZE + PAGE_SIZE - heap_begin_ - dead_bytes_;
+}
+
+/*
+ * A key kept with a suffix ends after the prefix, so it takes prefix_length_ +
+ * length bytes, a key without suffix is the prefix filled with 0
+ */
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::GetBytesWithPrefix(uint32_t prefix_length) const {
+  ASSERT(prefix_length <= prefix_length_, "Prefix longer than the prefix of the page.");
+  uint32_t prefix_key = std::max(TrimmedLength(low_fence_, prefix_length_), prefix_length) - prefix_length;
+  uint32_t bytes = 0;
+  for (int i = 0; i < GetSize(); i++) {
+    bytes += SLOT_SIZE + sizeof(ValueType);
+    if (HasKey(i)) {
+      bytes += slots_[i].length_ > 0 ? prefix_length_ + slots_[i].length_ - prefix_length : prefix_key;
+    }
+  }
+  return bytes;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::TrimmedLength(const char *data, uint32_t size) {
+  while (size > 0 && data[size - 1] == 0) {
+    size--;
+  }
+  return size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::Head(const char *suffix, uint32_t length) {
+  uint32_t head = 0;
+  for (uint32_t i = 0; i < sizeof(uint32_t); i++) {
+    head = head << 8 | (i < length ? static_cast<uint8_t>(suffix[i]) : 0);
+  }
+  return head;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::PrefixLength(const KeyType *low, const KeyType *high) {
+  if (low == nullptr || high == nullptr) {
+    return 0;
+  }
+  uint32_t length = 0;
+  while (length < KEY_SIZE && low->data[length] == high->data[length]) {
+    length++;
+  }
+  return length;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::KeyBytes(const KeyType &key, uint32_t prefix_length) {
+  return TrimmedLength(key.data + prefix_length, KEY_SIZE - prefix_length);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::EntriesBytes(const MappingType *entries, int count, uint32_t prefix_length,
+                                                     bool leaf) {
+  uint32_t bytes = count * (SLOT_SIZE + sizeof(ValueType));
+  for (int i = leaf ? 0 : 1; i < count; i++) {
+    bytes += KeyBytes(entries[i].first, prefix_length);
+  }
+  return bytes;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_PAGE_TYPE::SplitPoint(const MappingType *entries, int count, uint32_t prefix_length,
+                                              bool leaf) {
+  uint32_t total = EntriesBytes(entries, count, prefix_length, leaf);
+  uint32_t bytes = 0;
+  int index = 1;
+  for (; index < count - 1; index++) {
+    bytes += EntriesBytes(entries + index - 1, 1, prefix_length, leaf || index > 1);
+    if (2 * bytes >= total) {
+      break;
+    }
+  }
+  return index;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_SLOTTED_PAGE_TYPE::Separator(const KeyType &left, const KeyType &right) {
+  KeyType separator;
+  memset(separator.data, 0, KEY_SIZE);
+  uint32_t length = 0;
+  while (length < KEY_SIZE && left.data[length] == right.data[length]) {
+    length++;
+  }
+  memcpy(separator.data, right.data, std::min(length + 1, KEY_SIZE));
+  return separator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t B_PLUS_TREE_SLOTTED_PAGE_TYPE::FillBytes(double fill_factor) {
+  auto bytes = static_cast<uint32_t>(CAPACITY * fill_factor);
+  return std::min(std::max(bytes, 2 * MAX_ENTRY_SIZE), CAPACITY - MAX_ENTRY_SIZE);
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * Binary search on the slots. A key outside the prefix of the page is before or
+ * after all its keys, otherwise only its suffix is compared with the entries.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template<bool upper>
+int B_PLUS_TREE_SLOTTED_PAGE_TYPE::Search(const KeyType &key, int begin) const {
+  int end = GetSize();
+  int cmp = memcmp(key.data, low_fence_, prefix_length_);
+  if (cmp != 0) {
+    return cmp < 0 ? begin : std::max(begin, end);
+  }
+  const char *suffix = key.data + prefix_length_;
+  uint32_t length = TrimmedLength(suffix, KEY_SIZE - prefix_length_);
+  uint32_t head = Head(suffix, length);
+  while (begin < end) {
+    int mid = begin + (end - begin) / 2;
+    cmp = CompareAt(suffix, length, head, mid);
+    if (upper ? cmp >= 0 : cmp > 0) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin;
+}
+
+/*
+ * Both suffixes are filled with 0 after their length and end with a byte other
+ * than 0, so past their common length the longer one is greater
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_SLOTTED_PAGE_TYPE::CompareAt(const char *suffix, uint32_t length, uint32_t head, int index) const {
+  const Slot &slot = slots_[index];
+  if (head != slot.head_) {
+    return head < slot.head_ ? -1 : 1;
+  }
+  uint32_t common = std::min<uint32_t>(length, slot.length_);
+  if (common > sizeof(uint32_t)) {
+    int cmp = memcmp(suffix + sizeof(uint32_t), Data() + slot.offset_ + sizeof(uint32_t), common - sizeof(uint32_t));
+    if (cmp != 0) {
+      return cmp;
+    }
+  }
+  if (length == slot.length_ || std::max<uint32_t>(length, slot.length_) <= sizeof(uint32_t)) {
+    return 0;
+  }
+  return length < slot.length_ ? -1 : 1;
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVE
+ *****************************************************************************/
+/*
+ * Write the suffix and value of the entry to the heap and insert its slot at
+ * index, the heap is compacted first if the free space is fragmented
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  uint32_t length = 0;
+  if (HasKey(index)) {
+    ASSERT(memcmp(key.data, low_fence_, prefix_length_) == 0, "Key out of the fences of the page.");
+    length = KeyBytes(key, prefix_length_);
+  }
+  uint32_t bytes = length + sizeof(ValueType);
+  uint32_t slots_end = HEADER_SIZE + (GetSize() + 1) * SLOT_SIZE;
+  if (heap_begin_ < slots_end + bytes) {
+    Compact();
+  }
+  ASSERT(heap_begin_ >= slots_end + bytes, "Slotted page overflow.");
+  heap_begin_ -= bytes;
+  memcpy(Data() + heap_begin_, key.data + prefix_length_, length);
+  memcpy(Data() + heap_begin_ + length, &value, sizeof(ValueType));
+  memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * SLOT_SIZE);
+  slots_[index].offset_ = heap_begin_;
+  slots_[index].length_ = length;
+  slots_[index].head_ = Head(key.data + prefix_length_, length);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::RemoveAt(int index) {
+  dead_bytes_ += slots_[index].length_ + sizeof(ValueType);
+  memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * SLOT_SIZE);
+  IncreaseSize(-1);
+  if (GetSize() == 0) {
+    heap_begin_ = PAGE_SIZE;
+    dead_bytes_ = 0;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_SLOTTED_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const {
+  return GetFreeBytes() + slots_[index].length_ >= KeyBytes(key, prefix_length_) + MAX_ENTRY_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  ValueType value = ValueAt(index);
+  RemoveAt(index);
+  InsertAt(index, key, value);
+}
+
+/*
+ * Move the live entries to the end of the page, in slot order
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::Compact() {
+  char copy[PAGE_SIZE];
+  memcpy(copy, Data(), PAGE_SIZE);
+  heap_begin_ = PAGE_SIZE;
+  for (int i = 0; i < GetSize(); i++) {
+    uint32_t bytes = slots_[i].length_ + sizeof(ValueType);
+    heap_begin_ -= bytes;
+    memcpy(Data() + heap_begin_, copy + slots_[i].offset_, bytes);
+    slots_[i].offset_ = heap_begin_;
+  }
+  dead_bytes_ = 0;
+}
+
+/*****************************************************************************
+ * REBUILD
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::GetEntries(std::vector<MappingType> &entries) const {
+  for (int i = 0; i < GetSize(); i++) {
+    entries.emplace_back(KeyAt(i), ValueAt(i));
+  }
+}
+
+/*
+ * Used by splits, merges and redistributions, which change the fences and so
+ * the prefix of the keys. entries must not point into the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_SLOTTED_PAGE_TYPE::Rebuild(const MappingType *entries, int count, const KeyType *low,
+                                            const KeyType *high) {
+  SetSize(0);
+  heap_begin_ = PAGE_SIZE;
+  dead_bytes_ = 0;
+  SetFences(low, high);
+  for (int i = 0; i < count; i++) {
+    InsertAt(i, entries[i].first, entries[i].second);
+  }
+}
+
+template
+class BPlusTreeSlottedPage<GenericKey<32>, RowId, GenericComparator<32>>;
+
+template
+class BPlusTreeSlottedPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeSlottedPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+
+template
+class BPlusTreeSlottedPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
@@ -0,0 +1,39 @@
+#include "index/generic_key.h"
+#include "page/hash_table_bucket_page.h"
+
+template<typename KeyType, typename ValueType>
+void HASH_TABLE_BUCKET_TYPE::Init() {
+  size_ = 0;
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+template<typename KeyType, typename ValueType>
+void HASH_TABLE_BUCKET_TYPE::Append(const KeyType &key, const ValueType &value) {
+  ASSERT(!IsFull(), "Append to a full bucket.");
+  array_[size_].first = key;
+  array_[size_].second = value;
+  size_++;
+}
+
+template<typename KeyType, typename ValueType>
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(int index) {
+  size_--;
+  if (index != size_) {
+    array_[index] = array_[size_];
+  }
+}
+
+template
+class HashTableBucketPage<GenericKey<4>, RowId>;
+
+template
+class HashTableBucketPage<GenericKey<8>, RowId>;
+
+template
+class HashTableBucketPage<GenericKey<16>, RowId>;
+
+template
+class HashTableBucketPage<GenericKey<32>, RowId>;
+
+template
+class HashTableBucketPage<GenericKey<64>, RowId>;
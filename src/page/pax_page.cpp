@@ -0,0 +1,181 @@
+#include "page/pax_page.h"
+
+PaxLayout::PaxLayout(const Schema *schema) {
+  uint32_t row_bits = 2;
+  for (auto column : schema->GetColumns()) {
+    ColumnLayout col{};
+    col.type_ = column->GetType();
+    if (col.type_ == TypeId::kTypeChar) {
+      col.max_len_ = column->GetLength();
+      col.width_ = sizeof(uint32_t) + col.max_len_;
+    } else {
+      col.width_ = Type::GetTypeSize(col.type_);
+    }
+    row_bits += 1 + 8 * col.width_;
+    columns_.push_back(col);
+  }
+  // Start from the capacity ignoring the bitmap and alignment padding, and shrink until the page is large enough.
+  uint32_t capacity = (PAGE_SIZE - SIZE_PAX_PAGE_HEADER) * 8 / row_bits;
+  while (capacity > 0 && ComputeLayout(capacity) > PAGE_SIZE) {
+    capacity--;
+  }
+  capacity_ = capacity;
+  ComputeLayout(capacity_);
+}
+
+uint32_t PaxLayout::ComputeLayout(uint32_t capacity) {
+  uint32_t offset = SIZE_PAX_PAGE_HEADER + 2 * GetBitmapSize(capacity);
+  for (auto &col : columns_) {
+    col.null_offset_ = offset;
+    offset += GetBitmapSize(capacity);
+    col.value_offset_ = offset;
+    // keep the next bitmap 8 bytes aligned
+    offset += (col.width_ * capacity + 7) / 8 * 8;
+  }
+  return offset;
+}
+
+bool PaxLayout::CheckRow(const Row &row) const {
+  if (row.GetFieldCount() != columns_.size()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    Field *field = row.GetField(i);
+    if (field->GetType() != columns_[i].type_) {
+      return false;
+    }
+    if (columns_[i].type_ == TypeId::kTypeChar && !field->IsNull() && field->GetLength() > columns_[i].max_len_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_id, const PaxLayout &layout, LogManager *log_mgr,
+                   Transaction *txn) {
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetTupleCount(0);
+  SetCapacity(layout.GetCapacity());
+  memset(GetData() + PaxLayout::OFFSET_USED_BITMAP, 0, 2 * PaxLayout::GetBitmapSize(layout.GetCapacity()));
+}
+
+uint32_t PaxPage::FindBit(const uint64_t *bitmap, uint32_t start_slot, uint32_t end_slot, bool value) {
+  if (start_slot >= end_slot) {
+    return end_slot;
+  }
+  uint32_t word_idx = start_slot / 64;
+  uint32_t end_word = (end_slot + 63) / 64;
+  uint64_t word = (value ? bitmap[word_idx] : ~bitmap[word_idx]) & (~0ULL << (start_slot % 64));
+  while (word == 0) {
+    if (++word_idx == end_word) {
+      return end_slot;
+    }
+    word = value ? bitmap[word_idx] : ~bitmap[word_idx];
+  }
+  uint32_t slot_num = word_idx * 64 + __builtin_ctzll(word);
+  return slot_num < end_slot ? slot_num : end_slot;
+}
+
+void PaxPage::WriteTuple(const Row &row, const PaxLayout &layout, uint32_t slot_num) {
+  for (uint32_t i = 0; i < layout.GetColumnCount(); i++) {
+    Field *field = row.GetField(i);
+    SetBit(GetBitmap(layout.GetNullBitmapOffset(i)), slot_num, field->IsNull());
+    if (!field->IsNull()) {
+      field->SerializeTo(GetData() + layout.GetValueOffset(i) + layout.GetValueWidth(i) * slot_num);
+    }
+  }
+}
+
+bool PaxPage::InsertTuple(Row &row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager,
+                          LogManager *log_manager) {
+  ASSERT(layout.CheckRow(row), "Row does not match the pax layout.");
+  uint32_t slot_num = FindBit(GetUsedBitmap(), 0, layout.GetCapacity(), false);
+  if (slot_num == layout.GetCapacity()) {
+    return false;
+  }
+  WriteTuple(row, layout, slot_num);
+  SetBit(GetUsedBitmap(), slot_num, true);
+  SetBit(GetMutableLiveBitmap(), slot_num, true);
+  if (slot_num >= GetTupleCount()) {
+    SetTupleCount(slot_num + 1);
+  }
+  row.SetRowId(RowId(GetTablePageId(), slot_num));
+  return true;
+}
+
+bool PaxPage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  // If the slot number is invalid or the tuple is already deleted, abort.
+  if (slot_num >= GetTupleCount() || !TestBit(GetLiveBitmap(), slot_num)) {
+    return false;
+  }
+  SetBit(GetMutableLiveBitmap(), slot_num, false);
+  return true;
+}
+
+int PaxPage::UpdateTuple(const Row &new_row, Row *old_row, const PaxLayout &layout, Transaction *txn,
+                         LockManager *lock_manager, LogManager *log_manager) {
+  ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "invalid old row.");
+  if (!layout.CheckRow(new_row)) {
+    return 0;
+  }
+  // Copy out the old value, fails if the tuple does not exist or is deleted.
+  if (!GetTuple(old_row, layout, txn, lock_manager)) {
+    return 0;
+  }
+  WriteTuple(new_row, layout, old_row->GetRowId().GetSlotNum());
+  return 1;
+}
+
+void PaxPage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  SetBit(GetUsedBitmap(), slot_num, false);
+  SetBit(GetMutableLiveBitmap(), slot_num, false);
+}
+
+void PaxPage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
+  if (TestBit(GetUsedBitmap(), slot_num)) {
+    SetBit(GetMutableLiveBitmap(), slot_num, true);
+  }
+}
+
+bool PaxPage::GetTuple(Row *row, const PaxLayout &layout, Transaction *txn, LockManager *lock_manager) {
+  ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || !TestBit(GetLiveBitmap(), slot_num)) {
+    return false;
+  }
+  row->TruncateFields(layout.GetColumnCount());
+  for (uint32_t i = 0; i < layout.GetColumnCount(); i++) {
+    bool is_null = TestBit(GetNullBitmap(layout, i), slot_num);
+    row->AssignField(i, Field::ReadFrom(GetData() + layout.GetValueOffset(i) + layout.GetValueWidth(i) * slot_num,
+                                        layout.GetColumnType(i), is_null));
+  }
+  return true;
+}
+
+bool PaxPage::GetFirstTupleRid(RowId *first_rid) {
+  uint32_t slot_num = FindBit(GetLiveBitmap(), 0, GetTupleCount(), true);
+  if (slot_num < GetTupleCount()) {
+    first_rid->Set(GetTablePageId(), slot_num);
+    return true;
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+bool PaxPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+  ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  uint32_t slot_num = FindBit(GetLiveBitmap(), cur_rid.GetSlotNum() + 1, GetTupleCount(), true);
+  if (slot_num < GetTupleCount()) {
+    next_rid->Set(GetTablePageId(), slot_num);
+    return true;
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "page/table_page.h"
 
 void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn) {
@@ -6,25 +9,75 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(PAGE_SIZE);
   SetTupleCount(0);
+  memset(GetData() + OFFSET_LIVE_BITMAP, 0, 2 * SIZE_SLOT_BITMAP);
+  SetFragmentedBytes(0);
+}
+
+bool TablePage::ReserveSpace(uint32_t size) {
+  if (GetFreeSpaceRemaining() >= size) {
+    return true;
+  }
+  if (GetFreeSpaceRemaining() + GetFragmentedBytes() < size) {
+    return false;
+  }
+  Compact();
+  return true;
+}
+
+void TablePage::Compact() {
+  // (offset, slot) of every slot still owning bytes in the tuple region, including tuples marked deleted.
+  std::vector<std::pair<uint32_t, uint32_t>> tuples;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleBytes(GetTupleSize(i)) != 0) {
+      tuples.emplace_back(GetTupleOffsetAtSlot(i), i);
+    }
+  }
+  // Slide tuples towards the end of the page, the one with the highest offset first, so that a move never
+  // overwrites a tuple which has not been moved yet.
+  std::sort(tuples.begin(), tuples.end(), std::greater<>());
+  uint32_t free_space_pointer = PAGE_SIZE;
+  for (auto &tuple : tuples) {
+    uint32_t tuple_size = GetTupleBytes(GetTupleSize(tuple.second));
+    free_space_pointer -= tuple_size;
+    if (free_space_pointer != tuple.first) {
+      memmove(GetData() + free_space_pointer, GetData() + tuple.first, tuple_size);
+      SetTupleOffsetAtSlot(tuple.second, free_space_pointer);
+    }
+  }
+  SetFreeSpacePointer(free_space_pointer);
+  SetFragmentedBytes(0);
+}
+
+uint32_t TablePage::FindSlotBit(size_t bitmap_offset, uint32_t start_slot) {
+  if (start_slot >= MAX_SLOT_NUM) {
+    return MAX_SLOT_NUM;
+  }
+  uint64_t *words = GetSlotBitmap(bitmap_offset);
+  uint32_t word_idx = start_slot / SLOT_BITMAP_WORD_BITS;
+  // Mask off the bits before start_slot in the first word.
+  uint64_t word = words[word_idx] & (~0ULL << (start_slot % SLOT_BITMAP_WORD_BITS));
+  while (word == 0) {
+    if (++word_idx == SLOT_BITMAP_WORDS) {
+      return MAX_SLOT_NUM;
+    }
+    word = words[word_idx];
+  }
+  return word_idx * SLOT_BITMAP_WORD_BITS + __builtin_ctzll(word);
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
-  }
   // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
+  uint32_t i = FindSlotBit(OFFSET_FREE_BITMAP, 0);
+  if (i >= GetTupleCount()) {
+    // No hole to reuse, a new slot is needed.
+    i = GetTupleCount();
+    if (i == MAX_SLOT_NUM || !ReserveSpace(serialized_size + SIZE_TUPLE)) {
+      return false;
     }
-  }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  } else if (!ReserveSpace(serialized_size)) {
     return false;
   }
   // Otherwise we claim available free space..
@@ -35,6 +88,8 @@ bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
   // Set the tuple.
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
   SetTupleSize(i, serialized_size);
+  SetSlotBit(OFFSET_FREE_BITMAP, i, false);
+  SetSlotBit(OFFSET_LIVE_BITMAP, i, true);
   // Set rid
   row.SetRowId(RowId(GetTablePageId(), i));
   if (i == GetTupleCount()) {
@@ -58,6 +113,7 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   if (tuple_size > 0) {
     SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
   }
+  SetSlotBit(OFFSET_LIVE_BITMAP, slot_num, false);
   return true;
 }
 
@@ -75,65 +131,68 @@ int TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
     return 0;
   }
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort.
-  if (IsDeleted(tuple_size)) {
+  // If the tuple is deleted or moved to another slot, abort.
+  if (IsDeleted(tuple_size) || IsForwarded(tuple_size)) {
     return 0;
   }
+  // A moved tuple stays moved after the update.
+  uint32_t moved_flag = tuple_size & MOVED_MASK;
+  tuple_size = GetTupleBytes(tuple_size);
   // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
-  if (GetFreeSpaceRemaining() + tuple_size < serialized_size) {
+  if (GetFreeSpaceRemaining() + GetFragmentedBytes() + tuple_size < serialized_size) {
     return 2;
   }
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
-  // std::cout << "TablePage::UpdateTuple tuple_size read_bytes " << tuple_size << ' ' << read_bytes << std::endl;
   ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
-    }
+  if (serialized_size <= tuple_size) {
+    // Overwrite in place, the tail of the old tuple becomes fragmented space.
+    new_row.SerializeTo(GetData() + tuple_offset, schema);
+    SetTupleSize(slot_num, serialized_size | moved_flag);
+    SetFragmentedBytes(GetFragmentedBytes() + tuple_size - serialized_size);
+    return 1;
   }
+  // Give up the old bytes first so that a compaction can reuse them, then write the new tuple at the
+  // free space pointer.
+  SetTupleSize(slot_num, 0);
+  SetFragmentedBytes(GetFragmentedBytes() + tuple_size);
+  bool __attribute__((unused)) reserved = ReserveSpace(serialized_size);
+  ASSERT(reserved, "Space should have been checked before.");
+  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
+  new_row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, serialized_size | moved_flag);
   return 1;
 }
 //wsx_end
 
-void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
-  uint32_t slot_num = rid.GetSlotNum();
-  ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
-
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t tuple_size = GetTupleSize(slot_num);
-  // Check if this is a delete operation, i.e. commit a delete.
-  if (IsDeleted(tuple_size)) {
-    tuple_size = UnsetDeletedFlag(tuple_size);
+void TablePage::ReleaseTupleSpace(uint32_t slot_num) {
+  uint32_t tuple_size = GetTupleBytes(GetTupleSize(slot_num));
+  if (tuple_size == 0) {
+    return;
   }
-
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
+  // Leave the other tuples where they are, the space is reclaimed by a later compaction. The tuple right at
+  // the free space pointer can be given back directly.
+  if (tuple_offset == free_space_pointer) {
+    SetFreeSpacePointer(free_space_pointer + tuple_size);
+  } else {
+    SetFragmentedBytes(GetFragmentedBytes() + tuple_size);
+  }
+}
 
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
+void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  // A forwarding slot owns no bytes, the moved tuple is deleted by the table heap.
+  ReleaseTupleSpace(slot_num);
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
-    }
-  }
+  SetSlotBit(OFFSET_LIVE_BITMAP, slot_num, false);
+  SetSlotBit(OFFSET_FREE_BITMAP, slot_num, true);
 }
 
 void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -144,6 +203,7 @@ void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *l
   // Unset the deleted flag.
   if (IsDeleted(tuple_size)) {
     SetTupleSize(slot_num, UnsetDeletedFlag(tuple_size));
+    SetSlotBit(OFFSET_LIVE_BITMAP, slot_num, true);
   }
 }
 
@@ -164,6 +224,22 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   }
   // std::cout << "TablePage::GetTuple2\n";
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
+  return ReadTuple(row, schema);
+}
+
+bool TablePage::ReadTuple(Row *row, Schema *schema) {
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsForwarded(tuple_size)) {
+    return false;
+  }
+  tuple_size = GetTupleBytes(tuple_size);
+  if (tuple_size == 0) {
+    return false;
+  }
   // std::cout << "TablePage::GetTuple slot_num: " << slot_num << std::endl;
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   // std::cout << "TablePage::GetTuple3 " << slot_num << "\n";
@@ -174,13 +250,41 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   return true;
 }
 
+bool TablePage::GetForwardRid(const RowId &rid, RowId *target, bool include_deleted) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (!IsForwarded(tuple_size) || (!include_deleted && (tuple_size & DELETE_MASK))) {
+    return false;
+  }
+  target->Set(static_cast<page_id_t>(GetTupleOffsetAtSlot(slot_num)), tuple_size & FORWARD_SLOT_MASK);
+  return true;
+}
+
+void TablePage::SetForwardRid(const RowId &rid, const RowId &target) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount() && !IsDeleted(GetTupleSize(slot_num)), "Can only forward a live tuple.");
+  ASSERT(target.GetSlotNum() <= FORWARD_SLOT_MASK, "Invalid forward slot.");
+  ReleaseTupleSpace(slot_num);
+  SetTupleOffsetAtSlot(slot_num, static_cast<uint32_t>(target.GetPageId()));
+  SetTupleSize(slot_num, FORWARD_MASK | target.GetSlotNum());
+}
+
+void TablePage::MarkMoved(const RowId &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount() && !IsDeleted(GetTupleSize(slot_num)), "Can only move a live tuple.");
+  SetTupleSize(slot_num, GetTupleSize(slot_num) | MOVED_MASK);
+  SetSlotBit(OFFSET_LIVE_BITMAP, slot_num, false);
+}
+
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
-  for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
-      first_rid->Set(GetTablePageId(), i);
-      return true;
-    }
+  uint32_t slot_num = FindSlotBit(OFFSET_LIVE_BITMAP, 0);
+  if (slot_num < GetTupleCount()) {
+    first_rid->Set(GetTablePageId(), slot_num);
+    return true;
   }
   first_rid->Set(INVALID_PAGE_ID, 0);
   return false;
@@ -189,11 +293,10 @@ bool TablePage::GetFirstTupleRid(RowId *first_rid) {
 bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
-  for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
-      next_rid->Set(GetTablePageId(), i);
-      return true;
-    }
+  uint32_t slot_num = FindSlotBit(OFFSET_LIVE_BITMAP, cur_rid.GetSlotNum() + 1);
+  if (slot_num < GetTupleCount()) {
+    next_rid->Set(GetTablePageId(), slot_num);
+    return true;
   }
   // Otherwise return false as there are no more tuples.
   next_rid->Set(INVALID_PAGE_ID, 0);
@@ -169,6 +169,14 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeTableLayout:
+      return "kNodeTableLayout";
+    case kNodeColumnEncoding:
+      return "kNodeColumnEncoding";
+    case kNodeAnalyze:
+      return "kNodeAnalyze";
+    case kNodeTableSample:
+      return "kNodeTableSample";
     default:
       return "error type";
   }
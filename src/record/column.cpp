@@ -24,7 +24,7 @@ Column::Column(std::string column_name, TypeId type, uint32_t length, uint32_t i
 
 Column::Column(const Column *other) : name_(other->name_), type_(other->type_), len_(other->len_),
                                       table_ind_(other->table_ind_), nullable_(other->nullable_),
-                                      unique_(other->unique_) {}
+                                      unique_(other->unique_), dict_encoded_(other->dict_encoded_) {}
 
 //wsx_start
 
@@ -52,11 +52,14 @@ uint32_t Column::SerializeTo(char *buf) const {
   MACH_WRITE_TO(bool, buf, unique_);//write whether the column is unique
   buf += sizeof(bool);
 
+  MACH_WRITE_TO(bool, buf, dict_encoded_);//write whether the column is dictionary encoded
+  buf += sizeof(bool);
+
   return GetSerializedSize();
 }
 
 uint32_t Column::GetSerializedSize() const {
-  return static_cast<uint32_t>( 4 * sizeof(uint32_t) + name_.length() + sizeof(int) + 2 * sizeof(bool) );
+  return static_cast<uint32_t>( 4 * sizeof(uint32_t) + name_.length() + sizeof(int) + 3 * sizeof(bool) );
 }
 
 uint32_t Column::DeserializeFrom(char *buf, Column *&column, MemHeap *heap) {
@@ -67,7 +70,7 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column, MemHeap *heap) {
   uint32_t column_len, column_index, name_len;
   TypeId column_type;
   int column_type_int;
-  bool column_nullable, column_unique;
+  bool column_nullable, column_unique, column_dict_encoded;
   ASSERT(MACH_READ_FROM(uint32_t, buf) == COLUMN_MAGIC_NUM, "Wrong for MAGIC_NUM.");//check magic_num
   buf += sizeof(uint32_t);//update the buf
 
@@ -106,6 +109,9 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column, MemHeap *heap) {
   column_unique = MACH_READ_FROM(bool, buf);
   buf += sizeof(bool);
 
+  column_dict_encoded = MACH_READ_FROM(bool, buf);
+  buf += sizeof(bool);
+
   if (column_type == TypeId::kTypeChar)
   {
     column = ALLOC_P(heap, Column)(column_name, column_type, column_len, column_index, column_nullable, column_unique);
@@ -114,8 +120,9 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column, MemHeap *heap) {
   {
     column = ALLOC_P(heap, Column)(column_name, column_type, column_index, column_nullable, column_unique);
   }
+  column->SetDictEncoded(column_dict_encoded);
 
-  return static_cast<uint32_t>( 4 * sizeof(uint32_t) + name_len + sizeof(int) + 2 * sizeof(bool) );
+  return static_cast<uint32_t>( 4 * sizeof(uint32_t) + name_len + sizeof(int) + 3 * sizeof(bool) );
 }
 
 //wsx_end
\ No newline at end of file
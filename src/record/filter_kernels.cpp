@@ -0,0 +1,277 @@
+#include "record/filter_kernels.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template<CompareOp op, typename T>
+inline bool Holds(T value, T operand) {
+  switch (op) {
+    case CompareOp::kEquals:
+      return value == operand;
+    case CompareOp::kNotEquals:
+      return value != operand;
+    case CompareOp::kLessThan:
+      return value < operand;
+    case CompareOp::kGreaterThan:
+      return value > operand;
+    case CompareOp::kLessThanEquals:
+      return value <= operand;
+    default:
+      return value >= operand;
+  }
+}
+
+/**
+ * Set the bits of the values in [begin, count) that match, the bits must be cleared before
+ */
+template<CompareOp op, typename T>
+inline void FilterTail(const T *values, uint32_t begin, uint32_t count, T operand, uint64_t *match) {
+  for (uint32_t i = begin; i < count; i++) {
+    match[i / 64] |= static_cast<uint64_t>(Holds<op>(values[i], operand)) << (i % 64);
+  }
+}
+
+#if defined(__AVX2__)
+
+constexpr uint32_t LANES = 8;
+
+template<CompareOp op>
+inline uint32_t MatchLanes(const int32_t *values, __m256i operand) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+  __m256i r;
+  switch (op) {
+    case CompareOp::kEquals:
+      r = _mm256_cmpeq_epi32(v, operand);
+      break;
+    case CompareOp::kNotEquals:
+      r = _mm256_xor_si256(_mm256_cmpeq_epi32(v, operand), _mm256_set1_epi32(-1));
+      break;
+    case CompareOp::kLessThan:
+      r = _mm256_cmpgt_epi32(operand, v);
+      break;
+    case CompareOp::kGreaterThan:
+      r = _mm256_cmpgt_epi32(v, operand);
+      break;
+    case CompareOp::kLessThanEquals:
+      r = _mm256_xor_si256(_mm256_cmpgt_epi32(v, operand), _mm256_set1_epi32(-1));
+      break;
+    default:
+      r = _mm256_xor_si256(_mm256_cmpgt_epi32(operand, v), _mm256_set1_epi32(-1));
+      break;
+  }
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(r)));
+}
+
+template<CompareOp op>
+inline uint32_t MatchLanes(const float *values, __m256 operand) {
+  __m256 v = _mm256_loadu_ps(values);
+  __m256 r;
+  // ordered predicates are false for NaN and not equals is true for it, same as the scalar operators
+  switch (op) {
+    case CompareOp::kEquals:
+      r = _mm256_cmp_ps(v, operand, _CMP_EQ_OQ);
+      break;
+    case CompareOp::kNotEquals:
+      r = _mm256_cmp_ps(v, operand, _CMP_NEQ_UQ);
+      break;
+    case CompareOp::kLessThan:
+      r = _mm256_cmp_ps(v, operand, _CMP_LT_OQ);
+      break;
+    case CompareOp::kGreaterThan:
+      r = _mm256_cmp_ps(v, operand, _CMP_GT_OQ);
+      break;
+    case CompareOp::kLessThanEquals:
+      r = _mm256_cmp_ps(v, operand, _CMP_LE_OQ);
+      break;
+    default:
+      r = _mm256_cmp_ps(v, operand, _CMP_GE_OQ);
+      break;
+  }
+  return static_cast<uint32_t>(_mm256_movemask_ps(r));
+}
+
+inline __m256i Broadcast(int32_t operand) { return _mm256_set1_epi32(operand); }
+
+inline __m256 Broadcast(float operand) { return _mm256_set1_ps(operand); }
+
+#elif defined(__SSE2__)
+
+constexpr uint32_t LANES = 4;
+
+template<CompareOp op>
+inline uint32_t MatchLanes(const int32_t *values, __m128i operand) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+  __m128i r;
+  switch (op) {
+    case CompareOp::kEquals:
+      r = _mm_cmpeq_epi32(v, operand);
+      break;
+    case CompareOp::kNotEquals:
+      r = _mm_xor_si128(_mm_cmpeq_epi32(v, operand), _mm_set1_epi32(-1));
+      break;
+    case CompareOp::kLessThan:
+      r = _mm_cmplt_epi32(v, operand);
+      break;
+    case CompareOp::kGreaterThan:
+      r = _mm_cmpgt_epi32(v, operand);
+      break;
+    case CompareOp::kLessThanEquals:
+      r = _mm_xor_si128(_mm_cmpgt_epi32(v, operand), _mm_set1_epi32(-1));
+      break;
+    default:
+      r = _mm_xor_si128(_mm_cmplt_epi32(v, operand), _mm_set1_epi32(-1));
+      break;
+  }
+  return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(r)));
+}
+
+template<CompareOp op>
+inline uint32_t MatchLanes(const float *values, __m128 operand) {
+  __m128 v = _mm_loadu_ps(values);
+  __m128 r;
+  switch (op) {
+    case CompareOp::kEquals:
+      r = _mm_cmpeq_ps(v, operand);
+      break;
+    case CompareOp::kNotEquals:
+      r = _mm_cmpneq_ps(v, operand);
+      break;
+    case CompareOp::kLessThan:
+      r = _mm_cmplt_ps(v, operand);
+      break;
+    case CompareOp::kGreaterThan:
+      r = _mm_cmpgt_ps(v, operand);
+      break;
+    case CompareOp::kLessThanEquals:
+      r = _mm_cmple_ps(v, operand);
+      break;
+    default:
+      r = _mm_cmpge_ps(v, operand);
+      break;
+  }
+  return static_cast<uint32_t>(_mm_movemask_ps(r));
+}
+
+inline __m128i Broadcast(int32_t operand) { return _mm_set1_epi32(operand); }
+
+inline __m128 Broadcast(float operand) { return _mm_set1_ps(operand); }
+
+#endif
+
+template<CompareOp op, typename T>
+void FilterValues(const T *values, uint32_t count, T operand, uint64_t *match) {
+  memset(match, 0, (count + 63) / 64 * sizeof(uint64_t));
+  uint32_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+  auto broadcast = Broadcast(operand);
+  // LANES divides 64, so the bits of a step never cross a word
+  for (; i + LANES <= count; i += LANES) {
+    match[i / 64] |= static_cast<uint64_t>(MatchLanes<op>(values + i, broadcast)) << (i % 64);
+  }
+#endif
+  FilterTail<op>(values, i, count, operand, match);
+}
+
+template<CompareOp op, typename T>
+void FilterValuesScalar(const T *values, uint32_t count, T operand, uint64_t *match) {
+  memset(match, 0, (count + 63) / 64 * sizeof(uint64_t));
+  FilterTail<op>(values, 0, count, operand, match);
+}
+
+/**
+ * Instantiate a filter for the operator known at runtime, the loop itself has no branch on it
+ */
+template<typename T, template<CompareOp> class Filter>
+void Dispatch(const T *values, uint32_t count, CompareOp op, T operand, uint64_t *match) {
+  switch (op) {
+    case CompareOp::kEquals:
+      return Filter<CompareOp::kEquals>::Run(values, count, operand, match);
+    case CompareOp::kNotEquals:
+      return Filter<CompareOp::kNotEquals>::Run(values, count, operand, match);
+    case CompareOp::kLessThan:
+      return Filter<CompareOp::kLessThan>::Run(values, count, operand, match);
+    case CompareOp::kGreaterThan:
+      return Filter<CompareOp::kGreaterThan>::Run(values, count, operand, match);
+    case CompareOp::kLessThanEquals:
+      return Filter<CompareOp::kLessThanEquals>::Run(values, count, operand, match);
+    default:
+      return Filter<CompareOp::kGreaterThanEquals>::Run(values, count, operand, match);
+  }
+}
+
+template<CompareOp op>
+struct SimdFilter {
+  template<typename T>
+  static void Run(const T *values, uint32_t count, T operand, uint64_t *match) {
+    FilterValues<op>(values, count, operand, match);
+  }
+};
+
+template<CompareOp op>
+struct ScalarFilter {
+  template<typename T>
+  static void Run(const T *values, uint32_t count, T operand, uint64_t *match) {
+    FilterValuesScalar<op>(values, count, operand, match);
+  }
+};
+
+template<CompareOp op>
+void FilterCharValues(const char *values, uint32_t width, uint32_t count, const char *operand, uint32_t length,
+                      uint64_t *match) {
+  memset(match, 0, (count + 63) / 64 * sizeof(uint64_t));
+  for (uint32_t i = 0; i < count; i++, values += width) {
+    uint32_t len = MACH_READ_UINT32(values);
+    bool holds;
+    if (op == CompareOp::kEquals || op == CompareOp::kNotEquals) {
+      // most values differ in length or in their first bytes, memcmp only runs for candidates
+      bool equals = len == length && (length == 0 || (values[sizeof(uint32_t)] == operand[0] &&
+                                                      memcmp(values + sizeof(uint32_t), operand, length) == 0));
+      holds = (op == CompareOp::kEquals) == equals;
+    } else {
+      holds = Holds<op>(FieldKernel<TypeId::kTypeChar>::CompareRaw(values + sizeof(uint32_t), len, operand, length),
+                        0);
+    }
+    match[i / 64] |= static_cast<uint64_t>(holds) << (i % 64);
+  }
+}
+
+}  // namespace
+
+void FilterInt32(const int32_t *values, uint32_t count, CompareOp op, int32_t operand, uint64_t *match) {
+  Dispatch<int32_t, SimdFilter>(values, count, op, operand, match);
+}
+
+void FilterFloat(const float *values, uint32_t count, CompareOp op, float operand, uint64_t *match) {
+  Dispatch<float, SimdFilter>(values, count, op, operand, match);
+}
+
+void FilterInt32Scalar(const int32_t *values, uint32_t count, CompareOp op, int32_t operand, uint64_t *match) {
+  Dispatch<int32_t, ScalarFilter>(values, count, op, operand, match);
+}
+
+void FilterFloatScalar(const float *values, uint32_t count, CompareOp op, float operand, uint64_t *match) {
+  Dispatch<float, ScalarFilter>(values, count, op, operand, match);
+}
+
+void FilterChar(const char *values, uint32_t width, uint32_t count, CompareOp op, const char *operand,
+                uint32_t length, uint64_t *match) {
+  switch (op) {
+    case CompareOp::kEquals:
+      return FilterCharValues<CompareOp::kEquals>(values, width, count, operand, length, match);
+    case CompareOp::kNotEquals:
+      return FilterCharValues<CompareOp::kNotEquals>(values, width, count, operand, length, match);
+    case CompareOp::kLessThan:
+      return FilterCharValues<CompareOp::kLessThan>(values, width, count, operand, length, match);
+    case CompareOp::kGreaterThan:
+      return FilterCharValues<CompareOp::kGreaterThan>(values, width, count, operand, length, match);
+    case CompareOp::kLessThanEquals:
+      return FilterCharValues<CompareOp::kLessThanEquals>(values, width, count, operand, length, match);
+    default:
+      return FilterCharValues<CompareOp::kGreaterThanEquals>(values, width, count, operand, length, match);
+  }
+}
@@ -3,58 +3,165 @@
 //wsx_start
 
 uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-  //write the number of field
-  int64_t field_num = fields_.size();
-  MACH_WRITE_TO(int64_t, buf, field_num);
-  buf += sizeof(int64_t);
-
-  //get and write the null_bitmap
-  int64_t null_bitmap = 0;
-  for (int64_t i = 0; i < field_num; i++)
+  ASSERT(fields_.size() == schema->GetColumnCount(), "Fields size do not match schema's column size.");
+  uint32_t field_num = fields_.size();
+  if (field_num == 0) {
+    return 0;
+  }
+  //write the null bitmap, one bit per field
+  memset(buf, 0, schema->GetNullBitmapSize());
+  for (uint32_t i = 0; i < field_num; i++)
   {
-    if (fields_[i] == nullptr)
+    if (fields_[i]->IsNull())
     {
-      null_bitmap |= (1 << i);
+      buf[i / 8] |= static_cast<char>(1 << (i % 8));
     }
   }
-  MACH_WRITE_TO(int64_t, buf, null_bitmap);
-  buf += sizeof(int64_t);
 
-  //write the data of field by using its function
-  for (int64_t i = 0; i < field_num; i++)
+  //write the fixed size values at their offsets and the char data one after another
+  char *var_data = buf + schema->GetVarDataOffset();
+  uint16_t var_end = 0;
+  for (uint32_t i = 0; i < field_num; i++)
   {
-    buf += fields_[i]->SerializeTo(buf);
+    char *field_buf = buf + schema->GetFieldOffset(i);
+    if (fields_[i]->GetType() != TypeId::kTypeChar)
+    {
+      if (fields_[i]->IsNull()) memset(field_buf, 0, Type::GetTypeSize(fields_[i]->GetType()));
+      else fields_[i]->SerializeTo(field_buf);
+      continue;
+    }
+    const OverflowRef *ref = FindOverflowRef(i);
+    if (ref != nullptr)
+    {
+      //the value is in overflow pages, write the reference in place of it
+      buf[i / 8] &= static_cast<char>(~(1 << (i % 8)));
+      memcpy(var_data + var_end, ref, sizeof(OverflowRef));
+      var_end += sizeof(OverflowRef);
+      MACH_WRITE_TO(uint16_t, field_buf, var_end | OVERFLOW_FLAG);
+      continue;
+    }
+    if (!fields_[i]->IsNull())
+    {
+      memcpy(var_data + var_end, fields_[i]->GetData(), fields_[i]->GetLength());
+      var_end += fields_[i]->GetLength();
+    }
+    MACH_WRITE_TO(uint16_t, field_buf, var_end);
   }
-  return GetSerializedSize(schema);
+  return schema->GetVarDataOffset() + var_end;
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  //read the data of header of the row
-  int64_t field_num = MACH_READ_FROM(int64_t, buf);
-  buf += sizeof(int64_t);
-  int64_t null_bitmap = MACH_READ_FROM(int64_t, buf);
-  buf += sizeof(int64_t);
-  fields_.clear();
-  for (int64_t i = 0; i < field_num; i++)
+  overflow_refs_.clear();
+  uint32_t field_num = schema->GetColumnCount();
+  //a row read again and again by a scan keeps its fields, only their values are replaced
+  TruncateFields(field_num);
+  uint16_t var_end = 0;
+  for (uint32_t i = 0; i < field_num; i++)
   {
-    bool is_null = null_bitmap & (1 << i);
-    const Column *col = schema->GetColumn(i);
-    Field *fie;
-    buf += Field::DeserializeFrom(buf, col->GetType(), &fie, is_null, heap_);
-    fields_.push_back(fie);
+    AssignField(i, ReadField(buf, schema, i));
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar)
+    {
+      uint16_t entry = MACH_READ_FROM(uint16_t, buf + schema->GetFieldOffset(i));
+      var_end = entry & ~OVERFLOW_FLAG;
+      if (entry & OVERFLOW_FLAG)
+      {
+        OverflowRef ref;
+        memcpy(&ref, buf + schema->GetVarDataOffset() + var_end - sizeof(OverflowRef), sizeof(OverflowRef));
+        overflow_refs_.emplace_back(i, ref);
+      }
+    }
   }
-  // std::cout << "Row::DeserializeFrom\n";
-  return GetSerializedSize(schema);
+  return field_num == 0 ? 0 : schema->GetVarDataOffset() + var_end;
+}
+
+Field *Row::DeserializeField(const char *buf, const Schema *schema, uint32_t column_index, MemHeap *heap) {
+  return ALLOC_P(heap, Field)(ReadField(buf, schema, column_index));
+}
+
+Field Row::ReadField(const char *buf, const Schema *schema, uint32_t column_index) {
+  TypeId type = schema->GetColumn(column_index)->GetType();
+  bool is_null = (buf[column_index / 8] >> (column_index % 8)) & 1;
+  const char *field_buf = buf + schema->GetFieldOffset(column_index);
+  if (type != TypeId::kTypeChar)
+  {
+    return Field::ReadFrom(field_buf, type, is_null);
+  }
+  uint16_t var_end = MACH_READ_FROM(uint16_t, field_buf);
+  if (is_null || (var_end & OVERFLOW_FLAG))
+  {
+    return Field(TypeId::kTypeChar);
+  }
+  //the data starts at the end of the previous char column
+  uint16_t var_begin = schema->IsFirstVarColumn(column_index) ? 0 : MACH_READ_FROM(uint16_t, field_buf - sizeof(uint16_t));
+  var_begin &= ~OVERFLOW_FLAG;
+  char *data = const_cast<char *>(buf) + schema->GetVarDataOffset() + var_begin;
+  return Field(TypeId::kTypeChar, data, var_end - var_begin, true);
 }
 
 uint32_t Row::GetSerializedSize(Schema *schema) const {
-  uint32_t buf_add = 2 * sizeof(int64_t);
-  int64_t field_num = fields_.size();
-  for (int64_t i = 0; i < field_num; i++)
+  if (fields_.empty()) {
+    return 0;
+  }
+  uint32_t size = schema->GetVarDataOffset();
+  for (uint32_t i = 0; i < fields_.size(); i++)
+  {
+    if (fields_[i]->GetType() != TypeId::kTypeChar) continue;
+    if (FindOverflowRef(i) != nullptr) size += sizeof(OverflowRef);
+    else if (!fields_[i]->IsNull()) size += fields_[i]->GetLength();
+  }
+  return size;
+}
+
+void Row::SetField(uint32_t idx, const Field &field) {
+  ASSERT(idx < fields_.size(), "Failed to access field");
+  *fields_[idx] = Field(field);
+  for (auto it = overflow_refs_.begin(); it != overflow_refs_.end(); ++it)
+  {
+    if (it->first == idx)
+    {
+      overflow_refs_.erase(it);
+      break;
+    }
+  }
+}
+
+void Row::AssignField(uint32_t idx, Field &&field) {
+  if (idx < fields_.size()) {
+    *fields_[idx] = std::move(field);
+  } else {
+    fields_.push_back(ALLOC_P(heap_, Field)(std::move(field)));
+  }
+}
+
+void Row::TruncateFields(size_t count) {
+  for (size_t i = count; i < fields_.size(); i++) {
+    fields_[i]->~Field();
+    heap_->Free(fields_[i]);
+  }
+  if (count < fields_.size()) {
+    fields_.resize(count);
+  }
+}
+
+void Row::SetOverflowRef(uint32_t idx, const OverflowRef &ref) {
+  ASSERT(idx < fields_.size() && fields_[idx]->GetType() == TypeId::kTypeChar, "Only char values can overflow");
+  for (auto &overflow_ref : overflow_refs_)
+  {
+    if (overflow_ref.first == idx)
+    {
+      overflow_ref.second = ref;
+      return;
+    }
+  }
+  overflow_refs_.emplace_back(idx, ref);
+}
+
+const OverflowRef *Row::FindOverflowRef(uint32_t idx) const {
+  for (auto &overflow_ref : overflow_refs_)
   {
-    buf_add += fields_[i]->GetSerializedSize();
+    if (overflow_ref.first == idx) return &overflow_ref.second;
   }
-  return buf_add;
+  return nullptr;
 }
 
-//wsx_end
\ No newline at end of file
+//wsx_end
@@ -1,6 +1,34 @@
 #include "record/schema.h"
 #include<iostream>
 
+void Schema::InitRowLayout() {
+  null_bitmap_size_ = (columns_.size() + 7) / 8;
+  field_offsets_.resize(columns_.size());
+  uint32_t offset = null_bitmap_size_;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() != TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += Type::GetTypeSize(columns_[i]->GetType());
+    }
+  }
+  fixed_size_ = offset;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i]->GetType() == TypeId::kTypeChar) {
+      field_offsets_[i] = offset;
+      offset += sizeof(uint16_t);
+    }
+  }
+  var_data_offset_ = offset;
+}
+
+void Schema::InitNameIndex() {
+  name_index_.reserve(columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    // a duplicated name resolves to its first column, as the linear lookup did
+    name_index_.emplace(columns_[i]->GetName(), i);
+  }
+}
+
 //wsx_start
 
 uint32_t Schema::SerializeTo(char *buf) const {
@@ -20,7 +48,11 @@ uint32_t Schema::SerializeTo(char *buf) const {
 }
 
 uint32_t Schema::GetSerializedSize() const {
-  return static_cast<uint32_t>( sizeof(uint32_t) + sizeof(int) + columns_.size() * columns_[0]->GetSerializedSize() );
+  uint32_t size = sizeof(uint32_t) + sizeof(int);
+  for (auto column : columns_) {
+    size += column->GetSerializedSize();
+  }
+  return size;
 }
 
 uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap) {
@@ -45,7 +77,7 @@ uint32_t Schema::DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap) {
   
   schema = ALLOC_P(heap, Schema)(columns);
 
-  return static_cast<uint32_t>( sizeof(uint32_t) + sizeof(int) + schema->GetColumnCount() * schema->GetColumn(0)->GetSerializedSize() );
+  return schema->GetSerializedSize();
 }
 
 //wsx_end
\ No newline at end of file
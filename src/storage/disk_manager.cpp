@@ -98,7 +98,7 @@ void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  uint32_t i_extent = logical_page_id / 3;
+  uint32_t i_extent = logical_page_id / BITMAP_SIZE;
   uint32_t pi_bitmap = i_extent * (BITMAP_SIZE + 1) + 1; //the Physica id of bitmap page
   char bitmap_data[PAGE_SIZE];
   ReadPhysicalPage(pi_bitmap, bitmap_data);
@@ -0,0 +1,87 @@
+#include "storage/table_dictionary.h"
+
+void TableDictionary::Create(BufferPoolManager *buffer_pool_manager) {
+  buffer_pool_manager_ = buffer_pool_manager;
+  auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(root_page_id_));
+  page->Init();
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  last_page_id_ = root_page_id_;
+}
+
+void TableDictionary::Load(BufferPoolManager *buffer_pool_manager, page_id_t root_page_id) {
+  buffer_pool_manager_ = buffer_pool_manager;
+  root_page_id_ = root_page_id;
+  for (page_id_t page_id = root_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    const char *entry = page->GetPayload();
+    const char *end = entry + page->GetDataSize();
+    while (entry < end) {
+      uint16_t column_index = MACH_READ_FROM(uint16_t, entry);
+      uint16_t length = MACH_READ_FROM(uint16_t, entry + sizeof(uint16_t));
+      AddEntry(column_index, std::string(entry + SIZE_ENTRY_HEADER, length));
+      entry += SIZE_ENTRY_HEADER + length;
+    }
+    last_page_id_ = page_id;
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+bool TableDictionary::GetCode(uint32_t column_index, const char *data, uint32_t length, uint32_t *code) const {
+  auto column = columns_.find(column_index);
+  if (column == columns_.end()) {
+    return false;
+  }
+  auto iter = column->second.codes_.find(std::string(data, length));
+  if (iter == column->second.codes_.end()) {
+    return false;
+  }
+  *code = iter->second;
+  return true;
+}
+
+uint32_t TableDictionary::GetOrInsertCode(uint32_t column_index, const char *data, uint32_t length) {
+  uint32_t code;
+  if (GetCode(column_index, data, length, &code)) {
+    return code;
+  }
+  ASSERT(root_page_id_ != INVALID_PAGE_ID, "Dictionary is not created.");
+  ASSERT(length <= MAX_VALUE_LENGTH, "Value is too long for the dictionary.");
+  // append the entry to the last page, or to a new page if it is full
+  auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(last_page_id_));
+  if (page->GetDataSize() + SIZE_ENTRY_HEADER + length > OverflowPage::MAX_DATA_SIZE) {
+    page_id_t new_page_id;
+    auto new_page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(new_page_id));
+    new_page->Init();
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id_, true);
+    page = new_page;
+    last_page_id_ = new_page_id;
+  }
+  char *entry = page->GetPayload() + page->GetDataSize();
+  MACH_WRITE_TO(uint16_t, entry, static_cast<uint16_t>(column_index));
+  MACH_WRITE_TO(uint16_t, entry + sizeof(uint16_t), static_cast<uint16_t>(length));
+  memcpy(entry + SIZE_ENTRY_HEADER, data, length);
+  page->SetDataSize(page->GetDataSize() + SIZE_ENTRY_HEADER + length);
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  AddEntry(column_index, std::string(data, length));
+  return columns_[column_index].values_.size() - 1;
+}
+
+const std::string &TableDictionary::GetValue(uint32_t column_index, uint32_t code) const {
+  auto &values = columns_.at(column_index).values_;
+  ASSERT(code < values.size(), "Invalid dictionary code.");
+  return values[code];
+}
+
+uint32_t TableDictionary::GetValueCount(uint32_t column_index) const {
+  auto column = columns_.find(column_index);
+  return column == columns_.end() ? 0 : column->second.values_.size();
+}
+
+void TableDictionary::AddEntry(uint32_t column_index, std::string value) {
+  auto &column = columns_[column_index];
+  column.codes_.emplace(value, column.values_.size());
+  column.values_.push_back(std::move(value));
+}
@@ -1,19 +1,336 @@
+#include <algorithm>
+#include <memory>
+
 #include "storage/table_heap.h"
 
+void TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_id, Transaction *txn) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    reinterpret_cast<PaxPage *>(page)->Init(page_id, prev_id, pax_layout_, log_manager_, txn);
+  } else {
+    reinterpret_cast<TablePage *>(page)->Init(page_id, prev_id, log_manager_, txn);
+  }
+}
+
+page_id_t TableHeap::GetNextPageId(Page *page) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    return reinterpret_cast<PaxPage *>(page)->GetNextPageId();
+  }
+  return reinterpret_cast<TablePage *>(page)->GetNextPageId();
+}
+
+void TableHeap::SetNextPageId(Page *page, page_id_t next_page_id) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    reinterpret_cast<PaxPage *>(page)->SetNextPageId(next_page_id);
+  } else {
+    reinterpret_cast<TablePage *>(page)->SetNextPageId(next_page_id);
+  }
+}
+
+bool TableHeap::GetFirstTupleRid(Page *page, RowId *first_rid) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    return reinterpret_cast<PaxPage *>(page)->GetFirstTupleRid(first_rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetFirstTupleRid(first_rid);
+}
+
+bool TableHeap::GetNextTupleRid(Page *page, const RowId &cur_rid, RowId *next_rid) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    return reinterpret_cast<PaxPage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+  }
+  return reinterpret_cast<TablePage *>(page)->GetNextTupleRid(cur_rid, next_rid);
+}
+
+bool TableHeap::GetTuple(Page *page, Row *row, Transaction *txn) {
+  if (layout_ == TableLayout::kPaxLayout) {
+    return reinterpret_cast<PaxPage *>(page)->GetTuple(row, pax_layout_, txn, lock_manager_);
+  }
+  auto table_page = reinterpret_cast<TablePage *>(page);
+  RowId rid = row->GetRowId();
+  RowId tuple_rid;
+  if (!table_page->GetForwardRid(rid, &tuple_rid)) {
+    return table_page->GetTuple(row, storage_schema_, txn, lock_manager_);
+  }
+  // Follow the forwarding slot, the row keeps the RowId it is asked with.
+  auto tuple_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(tuple_rid.GetPageId()));
+  if (tuple_page == nullptr) {
+    return false;
+  }
+  row->SetRowId(tuple_rid);
+  bool ret = tuple_page->GetTuple(row, storage_schema_, txn, lock_manager_);
+  buffer_pool_manager_->UnpinPage(tuple_rid.GetPageId(), false);
+  row->SetRowId(rid);
+  return ret;
+}
+
+bool TableHeap::HasOverflowColumns(Schema *schema, TableLayout layout) {
+  if (layout != TableLayout::kRowLayout) {
+    return false;
+  }
+  for (auto column : schema->GetColumns()) {
+    if (column->GetType() == TypeId::kTypeChar && column->GetLength() > OVERFLOW_THRESHOLD) {
+      return true;
+    }
+  }
+  return false;
+}
+
+page_id_t TableHeap::WriteOverflowChain(const char *data, uint32_t length) {
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  uint32_t written = 0;
+  do {
+    page_id_t page_id;
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->NewPage(page_id));
+    page->Init();
+    uint32_t size = std::min(length - written, OverflowPage::MAX_DATA_SIZE);
+    memcpy(page->GetPayload(), data + written, size);
+    page->SetDataSize(size);
+    written += size;
+    if (prev_page != nullptr) {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_page = page;
+    prev_page_id = page_id;
+  } while (written < length);
+  buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  return first_page_id;
+}
+
+void TableHeap::ReadOverflowChain(const OverflowRef &ref, char *data) {
+  uint32_t read = 0;
+  for (page_id_t page_id = ref.page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(read + page->GetDataSize() <= ref.length_, "Overflow chain is longer than the value.");
+    memcpy(data + read, page->GetPayload(), page->GetDataSize());
+    read += page->GetDataSize();
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT(read == ref.length_, "Overflow chain is shorter than the value.");
+}
+
+bool TableHeap::OverflowChainEquals(const OverflowRef &ref, const char *data, uint32_t length) {
+  if (ref.length_ != length) {
+    return false;
+  }
+  uint32_t read = 0;
+  bool equal = true;
+  for (page_id_t page_id = ref.page_id_; equal && page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(read + page->GetDataSize() <= ref.length_, "Overflow chain is longer than the value.");
+    equal = memcmp(data + read, page->GetPayload(), page->GetDataSize()) == 0;
+    read += page->GetDataSize();
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return equal;
+}
+
+void TableHeap::FreeOverflowChain(page_id_t page_id) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<OverflowPage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::WriteOverflowFields(Row &row, const Row *old_row) {
+  if (!has_overflow_columns_) {
+    return;
+  }
+  ASSERT(row.GetOverflowRefs().empty(), "Overflow values of the row are not loaded.");
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    Field *field = row.GetField(i);
+    if (field->GetType() != TypeId::kTypeChar || field->IsNull() || field->GetLength() <= OVERFLOW_THRESHOLD) {
+      continue;
+    }
+    // an unchanged value keeps the chain it already has
+    const OverflowRef *old_ref = FindOverflowRef(old_row, i);
+    if (old_ref != nullptr && OverflowChainEquals(*old_ref, field->GetData(), field->GetLength())) {
+      row.SetOverflowRef(i, *old_ref);
+      continue;
+    }
+    OverflowRef ref{WriteOverflowChain(field->GetData(), field->GetLength()), field->GetLength()};
+    row.SetOverflowRef(i, ref);
+  }
+}
+
+const OverflowRef *TableHeap::FindOverflowRef(const Row *row, uint32_t column_index) {
+  if (row == nullptr) {
+    return nullptr;
+  }
+  for (auto &ref : row->GetOverflowRefs()) {
+    if (ref.first == column_index) {
+      return &ref.second;
+    }
+  }
+  return nullptr;
+}
+
+void TableHeap::LoadOverflowFields(Row *row, const std::vector<uint32_t> *projection) {
+  // SetField drops the reference of the loaded column, so iterate over a copy
+  auto refs = row->GetOverflowRefs();
+  for (auto &ref : refs) {
+    if (projection != nullptr && std::find(projection->begin(), projection->end(), ref.first) == projection->end()) {
+      continue;
+    }
+    std::unique_ptr<char[]> data(new char[ref.second.length_]);
+    ReadOverflowChain(ref.second, data.get());
+    row->SetField(ref.first, Field(TypeId::kTypeChar, data.get(), ref.second.length_, true));
+  }
+}
+
+Schema *TableHeap::CreateStorageSchema(Schema *schema, MemHeap *heap) {
+  bool has_encoded_columns = false;
+  for (auto column : schema->GetColumns()) {
+    has_encoded_columns = has_encoded_columns || column->IsDictEncoded();
+  }
+  if (!has_encoded_columns) {
+    return schema;
+  }
+  std::vector<Column *> columns;
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    if (column->IsDictEncoded()) {
+      columns.push_back(ALLOC_P(heap, Column)(column->GetName(), TypeId::kTypeInt, i, column->IsNullable(),
+                                              column->IsUnique()));
+    } else {
+      columns.push_back(ALLOC_P(heap, Column)(column));
+    }
+  }
+  return ALLOC_P(heap, Schema)(columns);
+}
+
+std::unique_ptr<Row> TableHeap::EncodeRow(const Row &row, std::vector<uint32_t> *new_columns) {
+  if (row.GetFieldCount() != schema_->GetColumnCount()) {
+    return nullptr;
+  }
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    Field *field = row.GetField(i);
+    if (!schema_->GetColumn(i)->IsDictEncoded()) {
+      fields.push_back(*field);
+    } else if (field->IsNull()) {
+      fields.emplace_back(TypeId::kTypeInt);
+    } else if (field->GetType() != TypeId::kTypeChar || field->GetLength() > TableDictionary::MAX_VALUE_LENGTH) {
+      return nullptr;
+    } else {
+      // a new value takes the next code of its column, its entry is only written once the row is stored
+      uint32_t code;
+      if (!dictionary_.GetCode(i, field->GetData(), field->GetLength(), &code)) {
+        code = dictionary_.GetValueCount(i);
+        new_columns->push_back(i);
+      }
+      fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(code));
+    }
+  }
+  auto storage_row = std::make_unique<Row>(fields);
+  storage_row->SetRowId(row.GetRowId());
+  return storage_row;
+}
+
+void TableHeap::AddDictionaryEntries(const Row &row, const Row &storage_row, const std::vector<uint32_t> &new_columns) {
+  for (auto i : new_columns) {
+    Field *field = row.GetField(i);
+    uint32_t __attribute__((unused)) code = dictionary_.GetOrInsertCode(i, field->GetData(), field->GetLength());
+    ASSERT(static_cast<int32_t>(code) == storage_row.GetField(i)->GetIntVal(),
+           "Dictionary code changed before the row was stored.");
+  }
+}
+
+void TableHeap::DecodeFields(Row *row, const std::vector<uint32_t> *projection) {
+  if (storage_schema_ == schema_) {
+    return;
+  }
+  for (uint32_t i = 0; i < row->GetFieldCount(); i++) {
+    if (!schema_->GetColumn(i)->IsDictEncoded() || row->GetField(i)->GetType() != TypeId::kTypeInt) {
+      continue;
+    }
+    if (projection != nullptr && std::find(projection->begin(), projection->end(), i) == projection->end()) {
+      continue;
+    }
+    if (row->GetField(i)->IsNull()) {
+      row->SetField(i, Field(TypeId::kTypeChar));
+      continue;
+    }
+    const std::string &value = dictionary_.GetValue(i, row->GetField(i)->GetIntVal());
+    row->SetField(i, Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true));
+  }
+}
+
+void TableHeap::LoadFields(Row *row, const std::vector<uint32_t> *projection) {
+  LoadOverflowFields(row, projection);
+  DecodeFields(row, projection);
+}
+
+bool TableHeap::GetDictionaryCode(uint32_t column_index, const char *data, uint32_t length, uint32_t *code) const {
+  return dictionary_.GetCode(column_index, data, length, code);
+}
+
+void TableHeap::FreeOverflowFields(const Row &row, const Row *kept_row) {
+  for (auto &ref : row.GetOverflowRefs()) {
+    const OverflowRef *kept_ref = FindOverflowRef(kept_row, ref.first);
+    if (kept_ref == nullptr || kept_ref->page_id_ != ref.second.page_id_) {
+      FreeOverflowChain(ref.second.page_id_);
+    }
+  }
+}
+
 //wsx_start1
 
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
+  if (storage_schema_ == schema_) {
+    return InsertStorageRow(row, txn);
+  }
+  std::vector<uint32_t> new_columns;
+  auto storage_row = EncodeRow(row, &new_columns);
+  if (storage_row == nullptr || !InsertStorageRow(*storage_row, txn)) {
+    return false;
+  }
+  AddDictionaryEntries(row, *storage_row, new_columns);
+  row.SetRowId(storage_row->GetRowId());
+  return true;
+}
+
+bool TableHeap::InsertStorageRow(Row &row, Transaction *txn) {
+  if (layout_ == TableLayout::kPaxLayout && !pax_layout_.CheckRow(row)) {
+    return false;
+  }
+  WriteOverflowFields(row);
+  bool inserted = InsertRow(row, txn);
+  if (!inserted) {
+    FreeOverflowFields(row);
+  }
+  row.ClearOverflowRefs();
+  return inserted;
+}
+
+bool TableHeap::InsertRow(Row &row, Transaction *txn) {
   //check if some current pages are enough for the new row
   page_id_t this_page_id = first_page_id_;
   for (; this_page_id != INVALID_PAGE_ID; )
   {
-    auto this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_page_id));
-    if (this_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_))
+    auto this_page = buffer_pool_manager_->FetchPage(this_page_id);
+    bool inserted;
+    if (layout_ == TableLayout::kPaxLayout) {
+      inserted = reinterpret_cast<PaxPage *>(this_page)->InsertTuple(row, pax_layout_, txn, lock_manager_, log_manager_);
+    } else {
+      inserted = reinterpret_cast<TablePage *>(this_page)->InsertTuple(row, storage_schema_, txn, lock_manager_, log_manager_);
+    }
+    if (inserted)
     {
-      // buffer_pool_manager_->UnpinPage(this_page_id, true);//将该页unpin
+      buffer_pool_manager_->UnpinPage(this_page_id, true);//将该页unpin
       return true;
     }
-    page_id_t next_page_id = this_page->GetNextPageId();
+    page_id_t next_page_id = GetNextPageId(this_page);
     buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
     if (next_page_id == INVALID_PAGE_ID) break;
     this_page_id = next_page_id;
@@ -21,21 +338,28 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
 
   //all current pages are not enough for the new row, so we need to create a new page and insert it into the double link list
   page_id_t new_page_id;
-  auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(new_page_id));
-  new_page->Init(new_page_id, this_page_id, log_manager_, txn);
-  if (new_page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_))
+  auto new_page = buffer_pool_manager_->NewPage(new_page_id);
+  InitPage(new_page, new_page_id, this_page_id, txn);
+  bool inserted;
+  if (layout_ == TableLayout::kPaxLayout) {
+    inserted = reinterpret_cast<PaxPage *>(new_page)->InsertTuple(row, pax_layout_, txn, lock_manager_, log_manager_);
+  } else {
+    inserted = reinterpret_cast<TablePage *>(new_page)->InsertTuple(row, storage_schema_, txn, lock_manager_, log_manager_);
+  }
+  if (inserted)
   {
     //insert it into the double link list
     if (this_page_id != INVALID_PAGE_ID) {
-      auto end_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_page_id));
-      end_page->SetNextPageId(new_page_id);
+      auto end_page = buffer_pool_manager_->FetchPage(this_page_id);
+      SetNextPageId(end_page, new_page_id);
       buffer_pool_manager_->UnpinPage(this_page_id, true);//将该页unpin
     }
     else  first_page_id_ = new_page_id; 
-    // buffer_pool_manager_->UnpinPage(new_page_id, true);//将该页unpin
+    buffer_pool_manager_->UnpinPage(new_page_id, true);//将该页unpin
     return true;
   }
   buffer_pool_manager_->UnpinPage(new_page_id, false);//将该页unpin
+  buffer_pool_manager_->DeletePage(new_page_id);
   return false;
 }
 
@@ -43,64 +367,144 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
 
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     return false;
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  if (layout_ == TableLayout::kPaxLayout) {
+    reinterpret_cast<PaxPage *>(page)->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  } else {
+    reinterpret_cast<TablePage *>(page)->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
   return true;
 }
 
 //wsx_start2
 
 bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
+  if (storage_schema_ == schema_) {
+    return UpdateStorageRow(row, rid, txn);
+  }
+  std::vector<uint32_t> new_columns;
+  auto storage_row = EncodeRow(row, &new_columns);
+  if (storage_row == nullptr || !UpdateStorageRow(*storage_row, rid, txn)) {
+    return false;
+  }
+  AddDictionaryEntries(row, *storage_row, new_columns);
+  row.SetRowId(rid);
+  return true;
+}
+
+bool TableHeap::UpdateStorageRow(Row &row, const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
   page_id_t this_page_id = rid.GetPageId();
-  auto this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_page_id));
+  auto this_page = buffer_pool_manager_->FetchPage(this_page_id);
   // If the page could not be found, return false
   if (this_page == nullptr) {
-    buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
     return false;
   }
 
-  Row old_row(rid);
+  //a moved tuple is updated where it is now, its forwarding slot stays at rid
+  RowId tuple_rid = rid;
+  if (layout_ == TableLayout::kRowLayout && reinterpret_cast<TablePage *>(this_page)->GetForwardRid(rid, &tuple_rid))
+  {
+    buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
+    this_page_id = tuple_rid.GetPageId();
+    this_page = buffer_pool_manager_->FetchPage(this_page_id);
+  }
+
+  //the chains of the old version are shared with the new one where the value did not change
+  Row old_row(tuple_rid);
+  if (has_overflow_columns_) reinterpret_cast<TablePage *>(this_page)->ReadTuple(&old_row, storage_schema_);
+  WriteOverflowFields(row, &old_row);
   // if (!this_page->GetTuple(&old_row, schema_, txn, lock_manager_))
   // {
   //   buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
   //   return false;
   // }
 
-  int update_ret = this_page->UpdateTuple(row, &old_row, schema_, txn, lock_manager_, log_manager_);
+  int update_ret;
+  if (layout_ == TableLayout::kPaxLayout) {
+    update_ret = reinterpret_cast<PaxPage *>(this_page)->UpdateTuple(row, &old_row, pax_layout_, txn, lock_manager_,
+                                                                     log_manager_);
+  } else {
+    update_ret = reinterpret_cast<TablePage *>(this_page)->UpdateTuple(row, &old_row, storage_schema_, txn, lock_manager_,
+                                                                       log_manager_);
+  }
   if (update_ret == 1)
   {
     row.SetRowId(rid);
     buffer_pool_manager_->UnpinPage(this_page_id, true);//将该页unpin
+    FreeOverflowFields(old_row, &row);
+    row.ClearOverflowRefs();
     return true;
   } 
-  else if (update_ret == 2)//current page is no enough for the new row, so we delete and insert again
+  else if (update_ret == 2)//current page is no enough for the new row, so we move it and leave a forwarding slot at rid
   {
     buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
-    ApplyDelete(rid, txn);
-    bool ret_insert = InsertTuple(row, txn);
-    return ret_insert;
+    bool ret_move = MoveTuple(row, rid, tuple_rid, txn);
+    if (ret_move) {
+      FreeOverflowFields(old_row, &row);
+    } else {
+      FreeOverflowFields(row, &old_row);
+    }
+    row.ClearOverflowRefs();
+    return ret_move;
   }
   else
   {
     buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
+    FreeOverflowFields(row, &old_row);
+    row.ClearOverflowRefs();
     return false;
   } 
 }
 
+bool TableHeap::MoveTuple(Row &row, const RowId &rid, const RowId &tuple_rid, Transaction *txn) {
+  if (!InsertRow(row, txn)) return false;
+  RowId new_rid = row.GetRowId();
+  auto new_page = buffer_pool_manager_->FetchPage(new_rid.GetPageId());
+  reinterpret_cast<TablePage *>(new_page)->MarkMoved(new_rid);
+  buffer_pool_manager_->UnpinPage(new_rid.GetPageId(), true);//将该页unpin
+  //the tuple moved by an earlier update is not needed any more
+  if (!(tuple_rid == rid))
+  {
+    auto old_page = buffer_pool_manager_->FetchPage(tuple_rid.GetPageId());
+    reinterpret_cast<TablePage *>(old_page)->ApplyDelete(tuple_rid, txn, log_manager_);
+    buffer_pool_manager_->UnpinPage(tuple_rid.GetPageId(), true);//将该页unpin
+  }
+  auto this_page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  reinterpret_cast<TablePage *>(this_page)->SetForwardRid(rid, new_rid);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);//将该页unpin
+  row.SetRowId(rid);
+  return true;
+}
+
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Step1: Find the page which contains the tuple.
-   auto this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto this_page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // Step2: Delete the tuple from the page.
-  this_page->ApplyDelete(rid, txn, log_manager_);
+  if (layout_ == TableLayout::kPaxLayout) {
+    reinterpret_cast<PaxPage *>(this_page)->ApplyDelete(rid, txn, log_manager_);
+  } else {
+    auto table_page = reinterpret_cast<TablePage *>(this_page);
+    RowId tuple_rid;
+    if (table_page->GetForwardRid(rid, &tuple_rid, true)) {
+      // the moved tuple goes together with its forwarding slot
+      ApplyDelete(tuple_rid, txn);
+    } else if (has_overflow_columns_) {
+      Row old_row(rid);
+      if (table_page->ReadTuple(&old_row, storage_schema_)) {
+        FreeOverflowFields(old_row);
+      }
+    }
+    table_page->ApplyDelete(rid, txn, log_manager_);
+  }
   buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);//将该页unpin
 }
 
@@ -108,13 +512,17 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
 
 void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   assert(page != nullptr);
   // Rollback the delete.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  if (layout_ == TableLayout::kPaxLayout) {
+    reinterpret_cast<PaxPage *>(page)->RollbackDelete(rid, txn, log_manager_);
+  } else {
+    reinterpret_cast<TablePage *>(page)->RollbackDelete(rid, txn, log_manager_);
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
 }
 
 //wsx_start3
@@ -128,37 +536,129 @@ void TableHeap::FreeHeap() {
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   RowId this_rid = row->GetRowId();
-  // std::cout << "TableHeap::GetTuple this_rid.GetPageId(): " << this_rid.GetPageId() << std::endl;
-  auto this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_rid.GetPageId()));
-  buffer_pool_manager_->UnpinPage(this_rid.GetPageId(), false);//将该页unpin
+  auto this_page = buffer_pool_manager_->FetchPage(this_rid.GetPageId());
   if (this_page == nullptr) return false;
-  return this_page->GetTuple(row, schema_, txn, lock_manager_);
+  bool ret = GetTuple(this_page, row, txn);
+  buffer_pool_manager_->UnpinPage(this_rid.GetPageId(), false);//将该页unpin
+  if (ret) LoadFields(row, nullptr);
+  return ret;
 }
 
 TableIterator TableHeap::Begin(Transaction *txn) {
+  return Begin(txn, nullptr, nullptr);
+}
 
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &projection) {
+  return Begin(txn, &projection, nullptr);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const TableSample &sample) {
+  return Begin(txn, nullptr, &sample);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> &projection, const TableSample &sample) {
+  return Begin(txn, &projection, &sample);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const std::vector<uint32_t> *projection, const TableSample *sample) {
   RowId first_rid;
-  page_id_t this_page_id = first_page_id_;
-  auto this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_page_id));//get first page
-  while (!this_page->GetFirstTupleRid(&first_rid))//if false, the page's record is delete all, then change to next page
+  auto this_page = SeekTuple(buffer_pool_manager_->FetchPage(first_page_id_), &first_rid, false, sample);
+  if (this_page == nullptr)
   {
-    this_page_id = this_page->GetNextPageId();
-    buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
-    if (this_page_id == INVALID_PAGE_ID)
-    {
-      return End();//find next page is invalid, return null
-    } 
-    this_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(this_page_id));//get next page
+    return End();//the table or the sample is empty
   }
-  
   Row *first_row = new Row(first_rid);
-  if (this_page->GetTuple(first_row, schema_, txn, lock_manager_))
+  bool gettuple_ret = GetTuple(this_page, first_row, txn);
+  buffer_pool_manager_->UnpinPage(this_page->GetPageId(), false);//将该页unpin
+  if (!gettuple_ret)
   {
-    buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
-    return TableIterator(this, first_row);
+    delete first_row;
+    return End();
+  }
+  LoadFields(first_row, projection);
+  return TableIterator(this, first_row, projection, sample);
+}
+
+bool TableHeap::ScanBatch(Transaction *txn, const std::vector<ColumnPredicate> &predicates,
+                          const std::vector<uint32_t> *projection, const std::function<void(const Row &)> &consumer) {
+  if (layout_ != TableLayout::kPaxLayout) {
+    return false;
+  }
+  for (auto &predicate : predicates) {
+    if (predicate.column_index_ >= storage_schema_->GetColumnCount() || predicate.operand_.IsNull() ||
+        storage_schema_->GetColumn(predicate.column_index_)->GetType() != predicate.operand_.GetType()) {
+      return false;
+    }
+  }
+  uint32_t words = PaxLayout::GetBitmapSize(pax_layout_.GetCapacity()) / sizeof(uint64_t);
+  std::vector<uint64_t> selection(words), match(words);
+  Row row;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<PaxPage *>(buffer_pool_manager_->FetchPage(page_id));
+    uint32_t count = page->GetTupleCount();
+    uint32_t count_words = (count + 63) / 64;
+    memcpy(selection.data(), page->GetLiveBitmap(), count_words * sizeof(uint64_t));
+    for (auto &predicate : predicates) {
+      FilterPage(page, predicate, count, match.data());
+      const uint64_t *nulls = page->GetNullBitmap(pax_layout_, predicate.column_index_);
+      bool null_matches = predicate.op_ == CompareOp::kNotEquals;
+      for (uint32_t w = 0; w < count_words; w++) {
+        selection[w] &= null_matches ? match[w] | nulls[w] : match[w] & ~nulls[w];
+      }
+    }
+    for (uint32_t w = 0; w < count_words; w++) {
+      for (uint64_t bits = selection[w]; bits != 0; bits &= bits - 1) {
+        row.SetRowId(RowId(page_id, w * 64 + __builtin_ctzll(bits)));
+        page->GetTuple(&row, pax_layout_, txn, lock_manager_);
+        LoadFields(&row, projection);
+        consumer(row);
+      }
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return true;
+}
+
+void TableHeap::FilterPage(PaxPage *page, const ColumnPredicate &predicate, uint32_t count, uint64_t *match) {
+  uint32_t column_index = predicate.column_index_;
+  const char *values = page->GetValues(pax_layout_, column_index);
+  const Field &operand = predicate.operand_;
+  switch (operand.GetType()) {
+    case TypeId::kTypeInt:
+      FilterInt32(reinterpret_cast<const int32_t *>(values), count, predicate.op_, operand.GetIntVal(), match);
+      break;
+    case TypeId::kTypeFloat:
+      FilterFloat(reinterpret_cast<const float *>(values), count, predicate.op_, operand.GetFloatVal(), match);
+      break;
+    default:
+      FilterChar(values, pax_layout_.GetValueWidth(column_index), count, predicate.op_, operand.GetData(),
+                 operand.GetLength(), match);
+      break;
+  }
+}
+
+Page *TableHeap::SeekTuple(Page *page, RowId *rid, bool after_rid, const TableSample *sample) {
+  bool found = (sample == nullptr || sample->KeepsPage(page->GetPageId())) &&
+               (after_rid ? GetNextTupleRid(page, *rid, rid) : GetFirstTupleRid(page, rid));
+  while (true) {
+    while (found && sample != nullptr && !sample->KeepsRow(*rid)) {
+      found = GetNextTupleRid(page, *rid, rid);
+    }
+    if (found) {
+      return page;
+    }
+    // no more tuple in this page, go to the next page kept by the sample
+    page_id_t next_page_id = GetNextPageId(page);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    page = buffer_pool_manager_->FetchPage(next_page_id);
+    found = (sample == nullptr || sample->KeepsPage(next_page_id)) && GetFirstTupleRid(page, rid);
   }
-  buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
-  return End();
 }
 
 TableIterator TableHeap::End() {
@@ -2,11 +2,24 @@
 #include "storage/table_iterator.h"
 #include "storage/table_heap.h"
 
-TableIterator::TableIterator(TableHeap *tableheap, Row *row): tableheap_(tableheap), row_(row) {}
+TableIterator::TableIterator(TableHeap *tableheap, Row *row, const std::vector<uint32_t> *projection,
+                             const TableSample *sample)
+        : tableheap_(tableheap), row_(row), project_all_(projection == nullptr), sampled_(sample != nullptr) {
+  if (projection != nullptr) {
+    projection_ = *projection;
+  }
+  if (sample != nullptr) {
+    sample_ = *sample;
+  }
+}
 
 TableIterator::TableIterator(const TableIterator &other) {
   tableheap_ = other.tableheap_;
   row_ = other.row_;
+  project_all_ = other.project_all_;
+  projection_ = other.projection_;
+  sampled_ = other.sampled_;
+  sample_ = other.sample_;
 }
 
 TableIterator::~TableIterator() {
@@ -27,41 +40,22 @@ Row *TableIterator::operator->() {
 }
 
 TableIterator &TableIterator::operator++() {
-  RowId this_rid = row_->GetRowId();
-  ASSERT(!(this_rid == INVALID_ROWID), "TableIterator::operator++, this_rid != INVALID_ROWID\n");
-  page_id_t this_page_id = this_rid.GetPageId();
-  auto this_page = reinterpret_cast<TablePage *>(tableheap_->buffer_pool_manager_->FetchPage(this_page_id));
-
-  RowId *next_rid = new RowId();
-  if (!this_page->GetNextTupleRid(row_->GetRowId(), next_rid))//there is no next record in this page, so need to change to next page
+  RowId next_rid = row_->GetRowId();
+  ASSERT(!(next_rid == INVALID_ROWID), "TableIterator::operator++, this_rid != INVALID_ROWID\n");
+  auto this_page = tableheap_->buffer_pool_manager_->FetchPage(next_rid.GetPageId());
+  this_page = tableheap_->SeekTuple(this_page, &next_rid, true, sampled_ ? &sample_ : nullptr);
+  if (this_page == nullptr)//no record after this one, so is the end
   {
-    do
-    {
-      page_id_t next_page_id = this_page->GetNextPageId();
-      tableheap_->buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
-      this_page_id = next_page_id;
-      // std::cout << "TableIterator::operator++ this_page_id: " << this_page_id << std::endl;
-      if (this_page_id == INVALID_PAGE_ID) //find next page is invalid, so is the end
-      {
-        // std::cout << "TableIterator::operator++ this_page_id == INVALID_PAGE_ID\n";
-        row_->SetRowId(INVALID_ROWID);
-        delete next_rid;
-        return *this;
-      }
-      // std::cout << "go to next page!!!!!!!!!!!!\n";
-      this_page = reinterpret_cast<TablePage *>(tableheap_->buffer_pool_manager_->FetchPage(this_page_id));//get next page
-    } while (!this_page->GetFirstTupleRid(next_rid));//if false, means this page is deleted all, so go next
+    row_->SetRowId(INVALID_ROWID);
+    return *this;
   }
 
   //after get next rid, we need update the row and return
-  row_->SetRowId(*next_rid);
-  // std::cout << "TableIterator::operator++" << std::endl;
-  bool updateRow_ret = this_page->GetTuple(row_, tableheap_->schema_, nullptr, tableheap_->lock_manager_);
+  row_->SetRowId(next_rid);
+  bool updateRow_ret = tableheap_->GetTuple(this_page, row_, nullptr);
   ASSERT(updateRow_ret == true, "wsx_tableiterator++ error!");
-  // std::cout << "TableIterator::operator++1" << std::endl;
-
-  delete next_rid;
-  tableheap_->buffer_pool_manager_->UnpinPage(this_page_id, false);//将该页unpin
+  tableheap_->buffer_pool_manager_->UnpinPage(this_page->GetPageId(), false);//将该页unpin
+  tableheap_->LoadFields(row_, project_all_ ? nullptr : &projection_);
   return *this;
 }
 
@@ -96,7 +90,7 @@ TableIterator &TableIterator::operator++() {
 //   after get next rid, we need update the row and return
 //   std::cout << "TableIterator::operator++(int) next_rid->GetSlotNum(): " << next_rid->GetSlotNum() << std::endl;
 //   row_->SetRowId(*next_rid);
-//   bool updateRow_ret = this_page->GetTuple(row_, tableheap_->schema_, nullptr, tableheap_->lock_manager_);
+//   bool updateRow_ret = tableheap_->GetTuple(this_page, row_, nullptr);
 //   ASSERT(updateRow_ret == true, "wsx_tableiterator++ error!");
 
 //   delete next_rid;
@@ -117,6 +117,32 @@ TEST(CatalogTest, CatalogIndexTest) {
   ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST, r2);
   auto r3 = catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info);
   ASSERT_EQ(DB_SUCCESS, r3);
+  // the key width fits the key schema, a single int key that is not nullable takes 4 bytes
+  ASSERT_EQ(64u, index_info->GetKeySize());
+  IndexInfo *id_index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-2", {"id"}, &txn, id_index_info));
+  ASSERT_EQ(4u, id_index_info->GetKeySize());
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    ASSERT_EQ(DB_SUCCESS, id_index_info->GetIndex()->InsertEntry(Row(fields), RowId(2000, i), nullptr));
+  }
+  // included columns are kept after the key, they are not key columns and must fit in the widest key
+  IndexInfo *covering_index_info = nullptr;
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-3", {"id"}, &txn, covering_index_info,
+                                               IndexType::kBPlusTree, true, {"id"}));
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-3", {"id"}, &txn, covering_index_info,
+                                               IndexType::kBPlusTree, true, {"name"}));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-3", {"id"}, &txn, covering_index_info,
+                                                IndexType::kBPlusTree, true, {"account"}));
+  ASSERT_EQ(16u, covering_index_info->GetKeySize());
+  // a hash index only finds equal keys
+  IndexInfo *hash_index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-4", {"id"}, &txn, hash_index_info, IndexType::kHash));
+  ASSERT_FALSE(hash_index_info->IsOrdered());
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    ASSERT_EQ(DB_SUCCESS, hash_index_info->GetIndex()->InsertEntry(Row(fields), RowId(3000, i), nullptr));
+  }
   for (int i = 0; i < 10; i++) {
     std::vector<Field> fields{
             Field(TypeId::kTypeInt, i),
@@ -157,5 +183,84 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(DB_SUCCESS, index_info_02->GetIndex()->ScanKey(row, ret_02, &txn));
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-2", index_info_02));
+  ASSERT_EQ(4u, index_info_02->GetKeySize());
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    std::vector<RowId> id_ret;
+    ASSERT_EQ(DB_SUCCESS, index_info_02->GetIndex()->ScanKey(Row(fields), id_ret, &txn));
+    ASSERT_EQ(RowId(2000, i).Get(), id_ret[0].Get());
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-3", index_info_02));
+  ASSERT_EQ(1u, index_info_02->GetKeyColumnCount());
+  ASSERT_EQ(2u, index_info_02->GetIndexKeySchema()->GetColumnCount());
+  ASSERT_EQ(2u, index_info_02->GetColIndex(1));
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-1", "index-4", index_info_02));
+  ASSERT_EQ(IndexType::kHash, index_info_02->GetIndexType());
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    std::vector<RowId> hash_ret;
+    ASSERT_EQ(DB_SUCCESS, index_info_02->GetIndex()->ScanKey(Row(fields), hash_ret, &txn));
+    ASSERT_EQ(RowId(3000, i).Get(), hash_ret[0].Get());
+  }
+  delete db_02;
+}
+TEST(CatalogTest, CatalogAnalyzeTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  TableStatistics *statistics = nullptr;
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->AnalyzeTable("table-1", statistics));
+  catalog_01->CreateTable("table-1", schema.get(), nullptr, table_info, 0);
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  // ids are 0..1999, names take 100 distinct values, every fourth account is null
+  const int row_nums = 2000;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i % 100);
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+            i % 4 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, static_cast<float>(i % 10))
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", statistics));
+  ASSERT_EQ(statistics, table_info->GetStatistics());
+  ASSERT_EQ(static_cast<uint32_t>(row_nums), statistics->GetRowCount());
+  ASSERT_EQ(0, statistics->GetNullFraction(0));
+  ASSERT_DOUBLE_EQ(0.25, statistics->GetNullFraction(2));
+  ASSERT_NEAR(row_nums, statistics->GetColumn(0).distinct_count_, row_nums * 0.05);
+  ASSERT_NEAR(100, statistics->GetColumn(1).distinct_count_, 5);
+  ASSERT_NEAR(0.01, statistics->EstimateEqualsSelectivity(1), 0.001);
+  const std::vector<Field> &bounds = statistics->GetColumn(0).bounds_;
+  ASSERT_EQ(TableStatistics::HISTOGRAM_BUCKETS + 1, bounds.size());
+  ASSERT_EQ(0, bounds.front().GetIntVal());
+  ASSERT_EQ(row_nums - 1, bounds.back().GetIntVal());
+  for (size_t i = 1; i < bounds.size(); i++) {
+    ASSERT_EQ(CmpBool::kTrue, bounds[i - 1].CompareLessThan(bounds[i]));
+  }
+  ASSERT_NEAR(0.3, statistics->EstimateLessThanSelectivity(0, Field(TypeId::kTypeInt, row_nums * 3 / 10)), 0.05);
+  ASSERT_EQ(0, statistics->EstimateLessThanSelectivity(0, Field(TypeId::kTypeInt, 0)));
+  ASSERT_EQ(1, statistics->EstimateLessThanSelectivity(0, Field(TypeId::kTypeInt, row_nums)));
+  delete db_01;
+  // statistics are kept with the catalog
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  TableInfo *table_info_02 = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info_02));
+  TableStatistics *loaded = table_info_02->GetStatistics();
+  ASSERT_NE(nullptr, loaded);
+  ASSERT_EQ(static_cast<uint32_t>(row_nums), loaded->GetRowCount());
+  ASSERT_DOUBLE_EQ(0.25, loaded->GetNullFraction(2));
+  Field min_name(TypeId::kTypeChar, const_cast<char *>("name-0"), 6, false);
+  ASSERT_EQ(CmpBool::kTrue, loaded->GetColumn(1).bounds_.front().CompareEquals(min_name));
+  ASSERT_EQ(TableStatistics::HISTOGRAM_BUCKETS + 1, loaded->GetColumn(0).bounds_.size());
   delete db_02;
-}
\ No newline at end of file
+}
@@ -0,0 +1,163 @@
+#include <string>
+
+#include "executor/execute_engine.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+FILE *yyin;
+}
+
+// the database file is named after the database, it must not be the name of the test binary
+static const std::string db_name = "execute_engine_test_db";
+
+// parse and execute one statement as main does
+static dberr_t ExecuteSql(ExecuteEngine &engine, const std::string &sql) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  ExecuteContext context;
+  dberr_t ret = MinisqlParserGetError() ? DB_FAILED : engine.Execute(MinisqlGetParserRootNode(), &context);
+  MinisqlParserFinish();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return ret;
+}
+
+// number of rows a select prints
+static int SelectCount(ExecuteEngine &engine, const std::string &sql, bool &used_index) {
+  testing::internal::CaptureStdout();
+  dberr_t ret = ExecuteSql(engine, sql);
+  std::string output = testing::internal::GetCapturedStdout();
+  EXPECT_EQ(DB_SUCCESS, ret);
+  used_index = output.find("可利用索引") != std::string::npos;
+  size_t pos = output.find("一共查到 ");
+  if (pos == std::string::npos) {
+    return -1;
+  }
+  return atoi(output.c_str() + pos + strlen("一共查到 "));
+}
+
+TEST(ExecuteEngineTest, NotEqualsNullTest) {
+  ExecuteEngine engine;
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "use " + db_name + ";"));
+  // a null is not equal to anything, the row scan, the batch scan of a pax table and the index scan agree
+  for (std::string layout : {"row", "pax"}) {
+    std::string table = "t_" + layout;
+    ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create table " + table + "(id int, c int, primary key(id)) using " +
+                                             layout + ";"));
+    for (int i = 0; i < 30; i++) {
+      std::string c = i % 3 == 0 ? "null" : std::to_string(i % 5);
+      ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into " + table + " values(" + std::to_string(i) + ", " + c +
+                                               ");"));
+    }
+  }
+  testing::internal::GetCapturedStdout();
+  // 10 nulls, 4 of the other 20 rows have c = 2. A null only meets <>, unless another condition on c rejects it.
+  const std::string conditions[] = {"c <> 2", "c <> -1", "c = 2", "c < 3", "c >= 0", "c <> 2 and c > 1"};
+  const int expected[] = {26, 30, 4, 12, 20, 8};
+  for (std::string table : {"t_row", "t_pax"}) {
+    bool used_index;
+    for (int i = 0; i < 6; i++) {
+      ASSERT_EQ(expected[i], SelectCount(engine, "select id from " + table + " where " + conditions[i] + ";", used_index))
+                << table << " " << conditions[i];
+      ASSERT_FALSE(used_index);
+    }
+    testing::internal::CaptureStdout();
+    ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create index " + table + "_c on " + table + "(c);"));
+    testing::internal::GetCapturedStdout();
+    for (int i = 0; i < 6; i++) {
+      ASSERT_EQ(expected[i], SelectCount(engine, "select id from " + table + " where " + conditions[i] + ";", used_index))
+                << table << " " << conditions[i];
+      ASSERT_TRUE(used_index);
+    }
+  }
+  testing::internal::CaptureStdout();
+  ExecuteSql(engine, "drop database " + db_name + ";");
+  testing::internal::GetCapturedStdout();
+  remove(db_name.c_str());
+}
+
+TEST(ExecuteEngineTest, LongLiteralTest) {
+  ExecuteEngine engine;
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "use " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create table t(id int, name char(2) unique, primary key(id));"));
+  // the key of a char(2) index is a few bytes wide
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create index i on t(name);"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into t values(1, \"ab\");"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into t values(2, \"b\");"));
+  // a value longer than its column is rejected and leaves no trace
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "insert into t values(3, \"abcdefghij\");"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into t values(3, \"zz\");"));
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "update t set name = \"abcdefghij\" where id = 1;"));
+  testing::internal::GetCapturedStdout();
+  // a literal too long for the index key is compared by a scan, it is still ordered against the values
+  const std::string conditions[] = {"name = \"abcdefghijkl\"", "name > \"abcdefghijkl\"", "name < \"abcdefghijkl\"",
+                                    "name <> \"abcdefghijkl\"", "name = \"zz\""};
+  const int expected[] = {0, 2, 1, 3, 1};
+  const bool indexed[] = {false, false, false, false, true};
+  for (int i = 0; i < 5; i++) {
+    bool used_index;
+    ASSERT_EQ(expected[i], SelectCount(engine, "select id from t where " + conditions[i] + ";", used_index))
+              << conditions[i];
+    ASSERT_EQ(indexed[i], used_index) << conditions[i];
+  }
+  bool used_index;
+  ASSERT_EQ(3, SelectCount(engine, "select id from t;", used_index));
+  testing::internal::CaptureStdout();
+  ExecuteSql(engine, "drop database " + db_name + ";");
+  testing::internal::GetCapturedStdout();
+  remove(db_name.c_str());
+}
+
+TEST(ExecuteEngineTest, NullInsertTest) {
+  ExecuteEngine engine;
+  testing::internal::CaptureStdout();
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create database " + db_name + ";"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "use " + db_name + ";"));
+  // a unique column takes no null, its index never sees one
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create table u(id int, name char(2) unique, primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create index u_name on u(name);"));
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "insert into u values(1, null);"));
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "insert into u values(null, \"ab\");"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into u values(1, \"ab\");"));
+  // a row whose index entry is rejected leaves neither the heap nor the other indexes, nor its key behind
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create table w(id int, v char(62), primary key(id));"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create index w_v on w(v);"));
+  const std::string long_value(60, 'x');
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into w values(1, \"a\");"));
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "insert into w values(2, \"" + long_value + "\");"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into w values(2, \"b\");"));
+  // rows with nulls are deleted and updated
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "create table t(id int, name char(2), primary key(id));"));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into t values(" + std::to_string(i) + ", null);"));
+  }
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "delete from t where id = 1;"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "update t set name = \"cd\" where id = 2;"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "update t set id = 5 where id = 3;"));
+  ASSERT_EQ(DB_FAILED, ExecuteSql(engine, "insert into t values(5, \"ef\");"));
+  ASSERT_EQ(DB_SUCCESS, ExecuteSql(engine, "insert into t values(3, \"ef\");"));
+  testing::internal::GetCapturedStdout();
+  bool used_index;
+  ASSERT_EQ(1, SelectCount(engine, "select id from u;", used_index));
+  // the heap and the indexes agree
+  ASSERT_EQ(2, SelectCount(engine, "select id from w;", used_index));
+  ASSERT_EQ(2, SelectCount(engine, "select id from w where v <> \"zz\";", used_index));
+  ASSERT_TRUE(used_index);
+  ASSERT_EQ(2, SelectCount(engine, "select id from w where id > 0;", used_index));
+  ASSERT_TRUE(used_index);
+  ASSERT_EQ(4, SelectCount(engine, "select id from t;", used_index));
+  // ids 0 and 5 are null
+  ASSERT_EQ(4, SelectCount(engine, "select id from t where name <> \"zz\";", used_index));
+  ASSERT_EQ(2, SelectCount(engine, "select id from t where name > \"a\";", used_index));
+  ASSERT_EQ(1, SelectCount(engine, "select id from t where name = \"cd\";", used_index));
+  testing::internal::CaptureStdout();
+  ExecuteSql(engine, "drop database " + db_name + ";");
+  testing::internal::GetCapturedStdout();
+  remove(db_name.c_str());
+}
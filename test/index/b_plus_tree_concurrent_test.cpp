@@ -0,0 +1,236 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/basic_comparator.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bp_tree_concurrent_test.db";
+
+using IntTree = BPlusTree<int, int, BasicComparator<int>>;
+
+/**
+ * Run task(thread_id) on num_threads threads and wait for all of them
+ */
+template<typename Task>
+void LaunchParallel(int num_threads, Task task) {
+  vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back(task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @return keys of tree in scan order
+ */
+vector<int> ScanKeys(IntTree &tree) {
+  vector<int> keys;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    keys.push_back((*iter).first);
+  }
+  return keys;
+}
+
+TEST(BPlusTreeConcurrentTests, InsertTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // small nodes split all the time
+  IntTree tree(0, engine.bpm_, comparator, 5, 5);
+  const int n = 4000, num_threads = 4;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  LaunchParallel(num_threads, [&](int id) {
+    for (int i = id; i < n; i += num_threads) {
+      ASSERT_TRUE(tree.Insert(keys[i], keys[i] * 2));
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(tree.GetValue(i, ans));
+    ASSERT_EQ(i * 2, ans[0]);
+  }
+  vector<int> scanned = ScanKeys(tree);
+  ASSERT_EQ(static_cast<size_t>(n), scanned.size());
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i, scanned[i]);
+  }
+}
+
+TEST(BPlusTreeConcurrentTests, RemoveTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntTree tree(0, engine.bpm_, comparator, 5, 5);
+  const int n = 4000, num_threads = 4;
+  for (int i = 0; i < n; i++) {
+    tree.Insert(i, i);
+  }
+  // remove the even keys, and then the rest of the first half
+  vector<int> removes;
+  for (int i = 0; i < n; i += 2) {
+    removes.push_back(i);
+  }
+  for (int i = 1; i < n / 2; i += 2) {
+    removes.push_back(i);
+  }
+  ShuffleArray(removes);
+  LaunchParallel(num_threads, [&](int id) {
+    for (size_t i = id; i < removes.size(); i += num_threads) {
+      tree.Remove(removes[i]);
+    }
+  });
+  ASSERT_TRUE(tree.Check());
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i >= n / 2 && i % 2 == 1, tree.GetValue(i, ans));
+  }
+  vector<int> scanned = ScanKeys(tree);
+  ASSERT_EQ(static_cast<size_t>(n / 4), scanned.size());
+  for (int i = 0; i < n / 4; i++) {
+    ASSERT_EQ(n / 2 + 1 + 2 * i, scanned[i]);
+  }
+}
+
+/**
+ * Readers look up and scan the tree while writers split and merge its nodes
+ */
+void RunMixed(BPlusTreeMode mode) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntTree tree(0, engine.bpm_, comparator, 5, 5, mode);
+  // keys divisible by 3 stay in the tree, the others are inserted and removed while readers run
+  const int n = 3000;
+  for (int i = 0; i < n; i += 3) {
+    tree.Insert(i, i);
+  }
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+  std::thread reader([&] {
+    while (!done) {
+      vector<int> ans;
+      for (int i = 0; i < n; i += 30) {
+        if (!tree.GetValue(i, ans)) failures++;
+      }
+      // a scan sees every stable key in increasing order
+      int last = -1, stable = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        int key = (*iter).first;
+        if (key <= last) failures++;
+        if (key % 3 == 0) stable++;
+        last = key;
+      }
+      if (stable != n / 3) failures++;
+    }
+  });
+  LaunchParallel(4, [&](int id) {
+    for (int round = 0; round < 3; round++) {
+      for (int i = id + 1; i < n; i += 4) {
+        if (i % 3 != 0) tree.Insert(i, i);
+      }
+      for (int i = id + 1; i < n; i += 4) {
+        if (i % 3 != 0) tree.Remove(i);
+      }
+    }
+  });
+  done = true;
+  reader.join();
+  ASSERT_EQ(0, failures.load());
+  ASSERT_TRUE(tree.Check());
+  vector<int> scanned = ScanKeys(tree);
+  ASSERT_EQ(static_cast<size_t>(n / 3), scanned.size());
+  for (int i = 0; i < n / 3; i++) {
+    ASSERT_EQ(3 * i, scanned[i]);
+  }
+}
+
+TEST(BPlusTreeConcurrentTests, MixedTest) {
+  RunMixed(BPlusTreeMode::kLatchCrabbing);
+}
+
+TEST(BPlusTreeConcurrentTests, OptimisticMixedTest) {
+  RunMixed(BPlusTreeMode::kOptimistic);
+}
+
+void RunLookupThroughput(BPlusTreeMode mode) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntTree tree(0, engine.bpm_, comparator, 255, 255, mode);
+  const int n = 50000, lookups = 50000;
+  for (int i = 0; i < n; i++) {
+    tree.Insert(i, i);
+  }
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    std::atomic<int> found{0};
+    auto start = std::chrono::steady_clock::now();
+    LaunchParallel(num_threads, [&](int id) {
+      vector<int> ans;
+      uint32_t seed = id + 1;
+      for (int i = 0; i < lookups; i++) {
+        seed = seed * 1103515245 + 12345;
+        ans.clear();
+        found += tree.GetValue(static_cast<int>(seed % n), ans);
+      }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(num_threads * lookups, found.load());
+    std::cout << num_threads << " threads: " << static_cast<int>(num_threads * lookups / seconds) << " lookups/s"
+              << std::endl;
+  }
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeConcurrentTests, LookupThroughputTest) {
+  RunLookupThroughput(BPlusTreeMode::kLatchCrabbing);
+}
+
+TEST(BPlusTreeConcurrentTests, OptimisticLookupThroughputTest) {
+  RunLookupThroughput(BPlusTreeMode::kOptimistic);
+}
+
+TEST(BPlusTreeConcurrentTests, CoalesceUnderIteratorTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  IntTree tree(0, engine.bpm_, comparator, 4, 4, BPlusTreeMode::kOptimistic);
+  for (int i = 0; i < 8; i++) {
+    tree.Insert(i, i);
+  }
+  tree.Remove(7);
+  tree.Remove(6);
+  // the leaves are [0, 1] [2, 3] [4, 5], the last one is merged into its left sibling and deleted once key 5 is gone
+  const int n = 6;
+  Page *leaf = tree.FindLeafPage(n - 1);
+  page_id_t leaf_page_id = leaf->GetPageId();
+  leaf->RUnlatch();
+  engine.bpm_->UnpinPage(leaf_page_id, false);
+  std::thread writer;
+  {
+    auto iter = tree.Begin(n - 1);
+    // the remove waits for the leaf the iterator is on
+    writer = std::thread([&] { tree.Remove(n - 1); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(n - 1, (*iter).first);
+    // an optimistic reader pins the leaf without latching it
+    EXPECT_NE(nullptr, engine.bpm_->FetchPage(leaf_page_id));
+  }
+  // the remove finishes while the leaf is still pinned, the page is deleted by its last unpin
+  writer.join();
+  ASSERT_FALSE(engine.bpm_->IsPageFree(leaf_page_id));
+  engine.bpm_->UnpinPage(leaf_page_id, false);
+  ASSERT_TRUE(engine.bpm_->IsPageFree(leaf_page_id));
+  ASSERT_TRUE(tree.Check());
+  vector<int> scanned = ScanKeys(tree);
+  ASSERT_EQ(static_cast<size_t>(n - 1), scanned.size());
+  for (int i = 0; i < n - 1; i++) {
+    ASSERT_EQ(i, scanned[i]);
+  }
+}
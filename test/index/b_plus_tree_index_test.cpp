@@ -1,3 +1,4 @@
+#include <memory>
 #include <string>
 
 #include "common/instance.h"
@@ -34,6 +35,67 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   ASSERT_EQ(0, comparator(k1, k2));
 }
 
+TEST(BPlusTreeTests, GenericComparatorOrderTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false),
+          ALLOC_COLUMN(heap)("nick", TypeId::kTypeChar, 16, 3, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1, 2, 3, 0};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  GenericComparator<64> comparator(key_schema);
+  const char *names[] = {"mini", "minisql", "b", ""};
+  const float accounts[] = {-1.5f, -0.0f, 2.25f};
+  // embedded 0 bytes are escaped
+  const char *nicks[] = {"mi\0ni", "mi", "mi\0"};
+  const uint32_t nick_lengths[] = {5, 2, 3};
+  std::vector<GenericKey<64>> keys;
+  std::vector<std::unique_ptr<Row>> rows;
+  for (uint32_t i = 0; i < 36; i++) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeChar, const_cast<char *>(names[i % 4]), strlen(names[i % 4]), true),
+            Field(TypeId::kTypeFloat, accounts[i % 3]),
+            i % 5 == 0 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, const_cast<char *>(nicks[i % 3]), nick_lengths[i % 3], true),
+            Field(TypeId::kTypeInt, static_cast<int32_t>(i % 7) - 3)
+    };
+    rows.emplace_back(new Row(fields));
+    keys.emplace_back();
+    keys.back().SerializeFromKey(*rows.back(), key_schema);
+  }
+  // same order as comparing the fields one by one, a null sorts first
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    for (uint32_t j = 0; j < keys.size(); j++) {
+      int expected = 0;
+      for (uint32_t c = 0; c < index_key_map.size() && expected == 0; c++) {
+        Field *l = rows[i]->GetField(c), *r = rows[j]->GetField(c);
+        if (l->IsNull() || r->IsNull()) {
+          expected = static_cast<int>(r->IsNull()) - static_cast<int>(l->IsNull());
+          continue;
+        }
+        if (l->CompareLessThan(*r) == CmpBool::kTrue) expected = -1;
+        if (l->CompareGreaterThan(*r) == CmpBool::kTrue) expected = 1;
+      }
+      int actual = comparator(keys[i], keys[j]);
+      ASSERT_EQ(expected, (actual > 0) - (actual < 0)) << i << " " << j;
+    }
+  }
+  // the encoding is decoded back to the same fields
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    Row key;
+    keys[i].DeserializeToKey(key, key_schema);
+    ASSERT_EQ(index_key_map.size(), key.GetFieldCount());
+    for (uint32_t c = 0; c < index_key_map.size(); c++) {
+      ASSERT_EQ(rows[i]->GetField(c)->IsNull(), key.GetField(c)->IsNull());
+      if (!key.GetField(c)->IsNull()) {
+        ASSERT_EQ(CmpBool::kTrue, key.GetField(c)->CompareEquals(*rows[i]->GetField(c)));
+      }
+    }
+  }
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   using INDEX_KEY_TYPE = GenericKey<32>;
   using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
@@ -78,4 +140,275 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexNonUniqueTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, false);
+  auto *bulk_index = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, false);
+  // "a" is a prefix of "ab", their entries must not mix
+  const char *names[] = {"ab", "a", "b"};
+  const int n = 600;
+  auto fields_of = [&](int i) {
+    return std::vector<Field>{Field(TypeId::kTypeChar, const_cast<char *>(names[i % 3]), strlen(names[i % 3]), true)};
+  };
+  auto key_of = [&](int i) {
+    std::vector<Field> fields = fields_of(i);
+    return Row(fields);
+  };
+  // row ids are inserted out of order
+  auto rid_of = [](int i) { return RowId(1000 + (i * 7) % n, i); };
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(i), rid_of(i), nullptr));
+  }
+  int next = 0;
+  ASSERT_EQ(DB_SUCCESS, bulk_index->BulkInsert([&](std::vector<Field> &key_fields, RowId &row_id) {
+    if (next == n) {
+      return false;
+    }
+    key_fields.clear();
+    key_fields.emplace_back(fields_of(next)[0]);
+    row_id = rid_of(next++);
+    return true;
+  }, 0.9, nullptr));
+  for (auto idx : {index, bulk_index}) {
+    for (int k = 0; k < 3; k++) {
+      std::vector<RowId> ret;
+      ASSERT_EQ(DB_SUCCESS, idx->ScanKey(key_of(k), ret, nullptr));
+      ASSERT_EQ(static_cast<size_t>(n / 3), ret.size());
+      for (size_t j = 0; j < ret.size(); j++) {
+        ASSERT_EQ(static_cast<uint32_t>(k), ret[j].GetSlotNum() % 3);
+        if (j > 0) {
+          ASSERT_LT(ret[j - 1].GetPageId(), ret[j].GetPageId());
+        }
+      }
+    }
+    std::vector<RowId> ret;
+    std::vector<Field> missing_fields{Field(TypeId::kTypeChar, const_cast<char *>("c"), 1, true)};
+    Row missing(missing_fields);
+    ASSERT_EQ(DB_KEY_NOT_FOUND, idx->ScanKey(missing, ret, nullptr));
+    ASSERT_TRUE(ret.empty());
+  }
+  // remove the entries of the even rows, a key keeps the entries of its other rows
+  for (int i = 0; i < n; i += 2) {
+    Row key = key_of(i);
+    key.SetRowId(rid_of(i));
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, nullptr));
+  }
+  for (int k = 0; k < 3; k++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(k), ret, nullptr));
+    ASSERT_EQ(static_cast<size_t>(n / 6), ret.size());
+    for (auto &rid : ret) {
+      ASSERT_EQ(1u, rid.GetSlotNum() % 2);
+    }
+  }
+  // the iterator returns every entry, ordered by key
+  int count = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+    count++;
+  }
+  ASSERT_EQ(n / 2, count);
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexCoveringTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  // key id, name and account are included
+  std::vector<uint32_t> index_key_map{0, 1, 2};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, true, 2);
+  const char *names[] = {"mini", "minisql", ""};
+  const int n = 300;
+  auto row_of = [&](int i, const char *name) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true),
+            i % 4 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, i * 0.5f)
+    };
+    Row row(fields);
+    row.SetRowId(RowId(1000, i));
+    return row;
+  };
+  auto key_of = [](int i) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    return Row(fields);
+  };
+  // keys are inserted in descending order, their included values are not ordered
+  for (int i = n - 1; i >= 0; i--) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row_of(i, names[i % 3]), RowId(1000, i), nullptr));
+  }
+  // the key is unique whatever the included values are
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(row_of(7, "other"), RowId(2000, 7), nullptr));
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(row_of(7, names[7 % 3]), RowId(1000, 7), nullptr));
+  // lookups take the key columns only
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(i), ret, nullptr));
+    ASSERT_EQ(1u, ret.size());
+    ASSERT_EQ(static_cast<uint32_t>(i), ret[0].GetSlotNum());
+  }
+  // the included values are decoded from the leaves
+  int i = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter, i++) {
+    Row row;
+    (*iter).first.DeserializeToKey(row, index_schema);
+    ASSERT_EQ(3u, row.GetFieldCount());
+    ASSERT_EQ(i, row.GetField(0)->GetIntVal());
+    ASSERT_EQ(std::string(names[i % 3]), std::string(row.GetField(1)->GetCharVal(), row.GetField(1)->GetLength()));
+    ASSERT_EQ(i % 4 == 0, row.GetField(2)->IsNull());
+    if (i % 4 != 0) {
+      ASSERT_EQ(i * 0.5f, row.GetField(2)->GetFloatVal());
+    }
+  }
+  ASSERT_EQ(n, i);
+  // an entry is removed by its key and included values
+  for (int j = 0; j < n; j += 2) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(row_of(j, names[j % 3]), nullptr));
+  }
+  for (int j = 0; j < n; j++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(j % 2 == 0 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(key_of(j), ret, nullptr));
+  }
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(row_of(0, "other"), RowId(2000, 0), nullptr));
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexScanRangeTest) {
+  using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> id_key_map{0};
+  auto *id_schema = Schema::ShallowCopySchema(&table_schema, id_key_map, &heap);
+  // each id has 3 entries, with a null id
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, id_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, false);
+  const int n = 200;
+  for (int i = 0; i < 3 * n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i / 3)};
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(1000, i), nullptr));
+  }
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(null_fields), RowId(2000, 0), nullptr));
+  auto key_of = [](int i) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    return Row(fields);
+  };
+  auto scan = [&](const Row *lower, const Row *upper, bool lower_inclusive, bool upper_inclusive) {
+    std::vector<int32_t> ids;
+    index->ScanRange(lower, upper, lower_inclusive, upper_inclusive, [&](RowId row_id, const Row *key) {
+      EXPECT_EQ(nullptr, key);
+      ids.push_back(row_id.GetPageId() == 2000 ? -1 : static_cast<int32_t>(row_id.GetSlotNum() / 3));
+      return true;
+    }, nullptr);
+    return ids;
+  };
+  auto expected = [](int begin, int end) {
+    std::vector<int32_t> ids;
+    for (int i = begin; i < end; i++) {
+      ids.insert(ids.end(), 3, i);
+    }
+    return ids;
+  };
+  Row k10 = key_of(10), k20 = key_of(20), k_outside = key_of(n + 5);
+  // every entry of a key at a bound is in or out of the range
+  ASSERT_EQ(expected(10, 21), scan(&k10, &k20, true, true));
+  ASSERT_EQ(expected(11, 20), scan(&k10, &k20, false, false));
+  ASSERT_EQ(expected(10, 11), scan(&k10, &k10, true, true));
+  ASSERT_TRUE(scan(&k20, &k10, true, true).empty());
+  ASSERT_TRUE(scan(&k_outside, nullptr, true, true).empty());
+  Row k195 = key_of(195);
+  ASSERT_EQ(expected(196, n), scan(&k195, nullptr, false, true));
+  std::vector<int32_t> all = expected(0, 20);
+  all.insert(all.begin(), -1);
+  ASSERT_EQ(all, scan(nullptr, &k20, true, false));
+  // an exclusive null bound skips the null keys
+  Row null_key(null_fields);
+  ASSERT_EQ(expected(0, 20), scan(&null_key, &k20, false, false));
+  // a callback returning false stops the scan
+  int count = 0;
+  index->ScanRange(&k10, nullptr, true, true, [&](RowId, const Row *) { return ++count < 5; }, nullptr);
+  ASSERT_EQ(5, count);
+
+  // a char key is not mixed with the keys it is a prefix of, decoded keys have the included column
+  std::vector<uint32_t> name_key_map{1, 0};
+  auto *name_schema = Schema::ShallowCopySchema(&table_schema, name_key_map, &heap);
+  auto *name_index = ALLOC(heap, BP_TREE_INDEX)(1, name_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, false, 1);
+  const char *names[] = {"a", "ab", "abc", "b", "ba"};
+  for (int i = 0; i < 10; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(names[i % 5]), strlen(names[i % 5]), true),
+                              Field(TypeId::kTypeInt, i)};
+    ASSERT_EQ(DB_SUCCESS, name_index->InsertEntry(Row(fields), RowId(1000, i), nullptr));
+  }
+  auto name_of = [&](const char *name) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true)};
+    return Row(fields);
+  };
+  Row ab = name_of("ab"), b = name_of("b");
+  std::vector<std::string> scanned;
+  name_index->ScanRange(&ab, &b, false, false, [&](RowId row_id, const Row *key) {
+    EXPECT_EQ(static_cast<int32_t>(row_id.GetSlotNum()), key->GetField(1)->GetIntVal());
+    scanned.emplace_back(key->GetField(0)->GetCharVal(), key->GetField(0)->GetLength());
+    return true;
+  }, nullptr, true);
+  ASSERT_EQ(std::vector<std::string>({"abc", "abc"}), scanned);
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexKeyTooLongTest) {
+  using BP_TREE_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 2, 1, true, true)
+  };
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  // a nullable char(2) key takes at most 5 bytes
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  auto name_of = [](const char *name) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name), strlen(name), true)};
+    return Row(fields);
+  };
+  Row ab = name_of("ab"), too_long = name_of("abcdefghijkl");
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(ab, RowId(1000, 0), nullptr));
+  // a key longer than the key width is rejected, not found, and no scan bound
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(too_long, RowId(1000, 1), nullptr));
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(too_long, ret, nullptr));
+  ASSERT_TRUE(ret.empty());
+  int count = 0;
+  auto callback = [&](RowId, const Row *) { return ++count > 0; };
+  ASSERT_EQ(DB_FAILED, index->ScanRange(&too_long, nullptr, false, true, callback, nullptr));
+  ASSERT_EQ(DB_FAILED, index->ScanRange(nullptr, &too_long, true, false, callback, nullptr));
+  ASSERT_EQ(0, count);
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(too_long, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(ab, ret, nullptr));
+  ASSERT_EQ(1u, ret.size());
+  // the row id appended by a non-unique index must fit too
+  auto *non_unique = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_, BPlusTreeMode::kLatchCrabbing, false);
+  ASSERT_EQ(DB_FAILED, non_unique->InsertEntry(ab, RowId(1000, 0), nullptr));
+}
@@ -2,6 +2,7 @@
 #include "gtest/gtest.h"
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
+#include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -67,4 +68,155 @@ TEST(BPlusTreeTests, SampleTest) {
     //printf("no. %2d = %4d yes. %2d = %4d\n", i, kv_map[delete_seq[i]], i, ans[ans.size() - 1]);
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 6, 5);
+  // a small memory limit spills the keys into several sorted runs
+  ExternalSorter<int, int, BasicComparator<int>> sorter(comparator, 64 * sizeof(std::pair<int, int>));
+  const int n = 1000;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int i = 0; i < n; i++) {
+    sorter.Add(keys[i], keys[i] * 2);
+  }
+  // a duplicated key keeps the first value added
+  sorter.Add(keys[0], -1);
+  sorter.Finish();
+  ASSERT_GT(sorter.GetRunCount(), 1u);
+  ASSERT_EQ(static_cast<size_t>(n), sorter.Size());
+  ASSERT_TRUE(tree.BulkLoad(sorter, 0.7));
+  ASSERT_TRUE(tree.Check());
+  // all keys are found
+  vector<int> ans;
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_TRUE(tree.GetValue(i, ans));
+    ASSERT_EQ(i * 2, ans[0]);
+  }
+  // the loaded tree is a normal tree for later inserts and removes
+  for (int i = n; i < n + 100; i++) {
+    ASSERT_TRUE(tree.Insert(i, i * 2));
+  }
+  for (int i = 0; i < n; i += 2) {
+    tree.Remove(i);
+  }
+  for (int i = 0; i < n + 100; i++) {
+    ans.clear();
+    ASSERT_EQ(i >= n || i % 2 == 1, tree.GetValue(i, ans));
+  }
+  ASSERT_TRUE(tree.Check());
+  // keys are scanned in order
+  vector<int> scanned, expected;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    scanned.push_back((*iter).first);
+  }
+  for (int i = 0; i < n + 100; i++) {
+    if (i >= n || i % 2 == 1) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, scanned);
+  // only an empty tree is bulk loaded
+  ExternalSorter<int, int, BasicComparator<int>> empty(comparator, 1024);
+  empty.Finish();
+  ASSERT_FALSE(tree.BulkLoad(empty, 1.0));
+}
+
+TEST(BPlusTreeTests, SlottedPageTest) {
+  using KeyType = GenericKey<64>;
+  using ValueType = RowId;
+  using KeyComparator = GenericComparator<64>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 60, 0, false, false)};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, {0}, &heap);
+  KeyComparator comparator(key_schema);
+  // long keys sharing most of their bytes, as in a char index
+  const int n = 2000;
+  vector<KeyType> keys(n);
+  char name[64];
+  for (int i = 0; i < n; i++) {
+    snprintf(name, sizeof(name), "warehouse-0001/district-0007/customer-%06d", i);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, name, strlen(name), true)};
+    keys[i].SerializeFromKey(Row(fields), key_schema);
+  }
+  // a leaf keeps the keys without the common prefix of its fences and trailing 0 bytes
+  char data[PAGE_SIZE];
+  auto *leaf = reinterpret_cast<BPlusTreeSlottedLeafPage<KeyType, ValueType, KeyComparator> *>(data);
+  leaf->Init(0);
+  leaf->Rebuild(nullptr, 0, &keys[0], &keys[n - 1]);
+  int count = 0;
+  while (!leaf->IsOverflow()) {
+    leaf->Insert(keys[count], RowId(0, count), comparator);
+    count++;
+  }
+  ASSERT_GT(count, static_cast<int>(2 * LEAF_PAGE_SIZE));
+  for (int i = 0; i < count; i++) {
+    ASSERT_EQ(0, comparator(keys[i], leaf->KeyAt(i)));
+    ASSERT_EQ(i, leaf->ValueAt(i).GetSlotNum());
+  }
+  BPlusTree<KeyType, ValueType, KeyComparator> tree(0, engine.bpm_, comparator);
+  vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  ShuffleArray(order);
+  for (int i : order) {
+    ASSERT_TRUE(tree.Insert(keys[i], RowId(0, i)));
+  }
+  ASSERT_TRUE(tree.Check());
+  // removing most keys merges and redistributes the pages
+  ShuffleArray(order);
+  vector<bool> removed(n, false);
+  for (int i = 0; i < n * 9 / 10; i++) {
+    tree.Remove(keys[order[i]]);
+    removed[order[i]] = true;
+  }
+  ASSERT_TRUE(tree.Check());
+  vector<ValueType> ans;
+  for (int i = 0; i < n; i++) {
+    ans.clear();
+    ASSERT_EQ(!removed[i], tree.GetValue(keys[i], ans));
+    if (!removed[i]) {
+      ASSERT_EQ(i, ans[0].GetSlotNum());
+    }
+  }
+  vector<int> scanned, expected;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    scanned.push_back((*iter).second.GetSlotNum());
+  }
+  for (int i = 0; i < n; i++) {
+    if (!removed[i]) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, scanned);
+  // a bulk loaded tree has the same keys
+  BPlusTree<KeyType, ValueType, KeyComparator> loaded(1, engine.bpm_, comparator);
+  ExternalSorter<KeyType, ValueType, KeyComparator> sorter(comparator, 256 * sizeof(std::pair<KeyType, ValueType>));
+  for (int i : order) {
+    sorter.Add(keys[i], RowId(0, i));
+  }
+  sorter.Finish();
+  ASSERT_TRUE(loaded.BulkLoad(sorter, 0.7));
+  ASSERT_TRUE(loaded.Check());
+  for (int i = 0; i < n; i += 2) {
+    loaded.Remove(keys[i]);
+  }
+  ASSERT_TRUE(loaded.Check());
+  scanned.clear();
+  for (auto iter = loaded.Begin(keys[n / 2 + 1]); iter != loaded.End(); ++iter) {
+    scanned.push_back((*iter).second.GetSlotNum());
+  }
+  ASSERT_EQ(static_cast<size_t>(n / 4), scanned.size());
+  for (int i = 0; i < n / 4; i++) {
+    ASSERT_EQ(n / 2 + 1 + 2 * i, scanned[i]);
+  }
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/extendible_hash_index.h"
+
+static const std::string db_name = "hash_index_test.db";
+
+TEST(ExtendibleHashIndexTests, UniqueKeyTest) {
+  using HASH_INDEX = ExtendibleHashIndex<8>;
+  // a small buffer pool fails if pages are left pinned
+  DBStorageEngine engine(db_name, true, 32);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, HASH_INDEX)(0, index_schema, engine.bpm_);
+  const int n = 20000;
+  std::vector<int> keys(n);
+  for (int i = 0; i < n; i++) {
+    keys[i] = i * 3 - n;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  auto key_of = [](int i) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    return Row(fields);
+  };
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(keys[i]), RowId(keys[i] + n, i), nullptr));
+  }
+  // the buckets split and the directory grew
+  uint32_t global_depth = index->GetGlobalDepth();
+  ASSERT_GT(global_depth, 3u);
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(key_of(keys[0]), RowId(1, 1), nullptr));
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(keys[i]), ret, nullptr));
+    ASSERT_EQ(1u, ret.size());
+    ASSERT_EQ(RowId(keys[i] + n, i), ret[0]);
+  }
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(key_of(1 - n), ret, nullptr));
+  ASSERT_TRUE(ret.empty());
+  // remove the first half, the rest stays
+  for (int i = 0; i < n / 2; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key_of(keys[i]), nullptr));
+  }
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    ASSERT_EQ(i < n / 2 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(key_of(keys[i]), ret, nullptr));
+  }
+  // the empty buckets merged and the directory shrank
+  for (int i = n / 2; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key_of(keys[i]), nullptr));
+  }
+  ASSERT_LT(index->GetGlobalDepth(), global_depth);
+  for (int i = 0; i < n; i += 100) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(keys[i]), RowId(keys[i] + n, i), nullptr));
+  }
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    ASSERT_EQ(i % 100 == 0 ? DB_SUCCESS : DB_KEY_NOT_FOUND, index->ScanKey(key_of(keys[i]), ret, nullptr));
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(ExtendibleHashIndexTests, NonUniqueKeyTest) {
+  using HASH_INDEX = ExtendibleHashIndex<16>;
+  DBStorageEngine engine(db_name, true, 32);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1, 0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  // id is an included column, the key is name
+  auto *index = ALLOC(heap, HASH_INDEX)(0, index_schema, engine.bpm_, false, 1);
+  // "a" is a prefix of "ab", their entries must not mix. The entries of a key outgrow a bucket, they overflow.
+  const char *names[] = {"ab", "a", "b"};
+  const int n = 3000;
+  auto key_of = [&](int i, bool include) {
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(names[i % 3]), strlen(names[i % 3]), true)};
+    if (include) {
+      fields.emplace_back(TypeId::kTypeInt, i);
+    }
+    return Row(fields);
+  };
+  auto rid_of = [](int i) { return RowId(1000 + i, i); };
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(i, true), rid_of(i), nullptr));
+  }
+  // an entry is rejected twice, another row of the key is not
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(key_of(0, true), rid_of(0), nullptr));
+  for (int k = 0; k < 3; k++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(k, false), ret, nullptr));
+    ASSERT_EQ(static_cast<size_t>(n / 3), ret.size());
+    for (auto &rid : ret) {
+      ASSERT_EQ(static_cast<uint32_t>(k), rid.GetSlotNum() % 3);
+    }
+  }
+  // remove the entries of the even rows, a key keeps the entries of its other rows
+  for (int i = 0; i < n; i += 2) {
+    Row key = key_of(i, true);
+    key.SetRowId(rid_of(i));
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, nullptr));
+  }
+  for (int k = 0; k < 3; k++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(k, false), ret, nullptr));
+    ASSERT_EQ(static_cast<size_t>(n / 6), ret.size());
+    for (auto &rid : ret) {
+      ASSERT_EQ(1u, rid.GetSlotNum() % 2);
+    }
+  }
+  // a key longer than the key width is rejected and not found
+  std::vector<Field> long_fields{Field(TypeId::kTypeChar, const_cast<char *>("abcdefghijklmnopq"), 17, true)};
+  Row too_long(long_fields);
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(too_long, RowId(1, 1), nullptr));
+  std::vector<RowId> long_ret;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(too_long, long_ret, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(too_long, nullptr));
+  // hash indexes keep no order
+  std::vector<Field> bound_fields{Field(TypeId::kTypeChar, const_cast<char *>("a"), 1, true)};
+  Row bound(bound_fields);
+  ASSERT_EQ(DB_FAILED, index->ScanRange(&bound, nullptr, true, true, [](RowId, const Row *) { return true; }, nullptr));
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+}
+
+TEST(ExtendibleHashIndexTests, ReopenTest) {
+  using HASH_INDEX = ExtendibleHashIndex<8>;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto key_of = [](int i) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    return Row(fields);
+  };
+  const int n = 5000;
+  {
+    DBStorageEngine engine(db_name);
+    auto *index = ALLOC(heap, HASH_INDEX)(3, index_schema, engine.bpm_);
+    for (int i = 0; i < n; i++) {
+      ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key_of(i), RowId(i, 0), nullptr));
+    }
+  }
+  // the directory is found in the index roots page
+  DBStorageEngine engine(db_name, false);
+  auto *index = ALLOC(heap, HASH_INDEX)(3, index_schema, engine.bpm_);
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key_of(i), ret, nullptr));
+    ASSERT_EQ(RowId(i, 0), ret[0]);
+  }
+}
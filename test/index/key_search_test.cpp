@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/rowid.h"
+#include "gtest/gtest.h"
+#include "index/basic_comparator.h"
+#include "index/key_search.h"
+#include "utils/mem_heap.h"
+
+/**
+ * Search the sorted keys of values for every value in probes and check the bounds against a linear scan
+ */
+template<size_t KeySize>
+void CheckKeySearch(Schema *key_schema, const std::vector<Field> &values, const std::vector<Field> &probes) {
+  using Pair = std::pair<GenericKey<KeySize>, RowId>;
+  GenericComparator<KeySize> comparator(key_schema);
+  auto encode = [&](const Field &value) {
+    std::vector<Field> fields{Field(value)};
+    GenericKey<KeySize> key;
+    key.SerializeFromKey(Row(fields), key_schema);
+    return key;
+  };
+  std::vector<Pair> array;
+  for (uint32_t i = 0; i < values.size(); i++) {
+    array.emplace_back(encode(values[i]), RowId(i, i));
+  }
+  std::sort(array.begin(), array.end(), [&](const Pair &l, const Pair &r) { return comparator(l.first, r.first) < 0; });
+  const int size = static_cast<int>(array.size());
+  for (const auto &probe : probes) {
+    auto key = encode(probe);
+    for (int begin : {0, 1, size / 3}) {
+      int lower = begin, upper = begin;
+      while (lower < size && comparator(array[lower].first, key) < 0) lower++;
+      while (upper < size && comparator(array[upper].first, key) <= 0) upper++;
+      ASSERT_EQ(lower, KeyLowerBound(array.data(), begin, size, key, comparator));
+      ASSERT_EQ(upper, KeyUpperBound(array.data(), begin, size, key, comparator));
+    }
+  }
+}
+
+TEST(KeySearchTest, IntKeySearchTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false)};
+  Schema schema(columns);
+  std::vector<Field> values, probes;
+  // negative and positive keys, larger than a window of prefixes
+  for (int32_t i = -100; i < 100; i += 3) {
+    values.emplace_back(TypeId::kTypeInt, i * 1000);
+  }
+  for (int32_t i = -110; i < 110; i++) {
+    probes.emplace_back(TypeId::kTypeInt, i * 1000 + (i % 2) * 7);
+  }
+  probes.emplace_back(TypeId::kTypeInt);
+  ASSERT_TRUE(GenericComparator<8>(&schema).PrefixIsExact());
+  CheckKeySearch<8>(&schema, values, probes);
+  CheckKeySearch<16>(&schema, values, probes);
+  CheckKeySearch<64>(&schema, values, probes);
+}
+
+TEST(KeySearchTest, CharKeySearchTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 24, 0, true, false)};
+  Schema schema(columns);
+  // many keys share their first 7 bytes, the comparator orders them
+  std::vector<std::string> strings;
+  for (int i = 0; i < 60; i++) {
+    strings.push_back("prefix_" + std::to_string(i * 7 % 60));
+    strings.push_back(std::string(1, static_cast<char>('a' + i % 26)) + std::to_string(i));
+  }
+  std::vector<Field> values, probes;
+  for (auto &s : strings) {
+    values.emplace_back(TypeId::kTypeChar, const_cast<char *>(s.data()), s.size(), true);
+    probes.emplace_back(TypeId::kTypeChar, const_cast<char *>(s.data()), s.size() - 1, true);
+    probes.emplace_back(TypeId::kTypeChar, const_cast<char *>(s.data()), s.size(), true);
+  }
+  ASSERT_FALSE(GenericComparator<64>(&schema).PrefixIsExact());
+  CheckKeySearch<32>(&schema, values, probes);
+  CheckKeySearch<64>(&schema, values, probes);
+}
+
+TEST(KeySearchTest, BasicKeySearchTest) {
+  BasicComparator<int> comparator;
+  std::vector<std::pair<int, int>> array;
+  for (int i = 0; i < 50; i++) {
+    array.emplace_back(i * 2, i);
+  }
+  ASSERT_EQ(0, KeyLowerBound(array.data(), 0, 50, -1, comparator));
+  ASSERT_EQ(5, KeyLowerBound(array.data(), 0, 50, 10, comparator));
+  ASSERT_EQ(6, KeyUpperBound(array.data(), 0, 50, 10, comparator));
+  ASSERT_EQ(6, KeyLowerBound(array.data(), 0, 50, 11, comparator));
+  ASSERT_EQ(50, KeyUpperBound(array.data(), 0, 50, 98, comparator));
+}
@@ -0,0 +1,103 @@
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "page/table_page.h"
+
+TEST(PageTests, TablePageSlotReuseTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  // fill the page
+  std::vector<RowId> rids;
+  for (int i = 0;; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    if (!table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) {
+      break;
+    }
+    ASSERT_EQ(static_cast<uint32_t>(i), row.GetRowId().GetSlotNum());
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_GT(rids.size(), 64);
+  ASSERT_LE(rids.size(), TablePage::MAX_SLOT_NUM);
+  // delete some of them, crossing bitmap word boundaries
+  std::unordered_set<uint32_t> deleted{0, 1, 63, 64, 65, static_cast<uint32_t>(rids.size() - 1)};
+  for (auto slot : deleted) {
+    ASSERT_TRUE(table_page.MarkDelete(rids[slot], nullptr, nullptr, nullptr));
+    table_page.ApplyDelete(rids[slot], nullptr, nullptr);
+  }
+  // iteration skips the holes
+  RowId rid;
+  size_t count = 0;
+  for (bool ok = table_page.GetFirstTupleRid(&rid); ok; ok = table_page.GetNextTupleRid(rid, &rid)) {
+    ASSERT_TRUE(deleted.find(rid.GetSlotNum()) == deleted.end());
+    Row row(rid);
+    ASSERT_TRUE(table_page.GetTuple(&row, schema.get(), nullptr, nullptr));
+    ASSERT_EQ(static_cast<int32_t>(rid.GetSlotNum()), row.GetField(0)->GetIntVal());
+    count++;
+  }
+  ASSERT_EQ(rids.size() - deleted.size(), count);
+  // holes are reused from the lowest slot
+  std::vector<uint32_t> reused;
+  for (size_t i = 0; i < deleted.size(); i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, -1)};
+    Row row(fields);
+    ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+    reused.push_back(row.GetRowId().GetSlotNum());
+  }
+  std::vector<uint32_t> expected{0, 1, 63, 64, 65, static_cast<uint32_t>(rids.size() - 1)};
+  ASSERT_EQ(expected, reused);
+}
+
+TEST(PageTests, TablePageLazyCompactionTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+                                   ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  auto make_row = [](int id, size_t len) {
+    std::string name(len, static_cast<char>('a' + id % 26));
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), len, true)};
+    return Row(fields);
+  };
+  std::vector<RowId> rids;
+  for (int i = 0;; i++) {
+    Row row = make_row(i, 16);
+    if (!table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) {
+      break;
+    }
+    rids.push_back(row.GetRowId());
+  }
+  // free every other tuple, no contiguous space is gained from the holes
+  for (size_t i = 0; i < rids.size(); i += 2) {
+    ASSERT_TRUE(table_page.MarkDelete(rids[i], nullptr, nullptr, nullptr));
+    table_page.ApplyDelete(rids[i], nullptr, nullptr);
+  }
+  // growing a tuple needs the fragmented space to be compacted
+  for (size_t i = 1; i < rids.size(); i += 2) {
+    Row new_row = make_row(static_cast<int>(i), 32);
+    Row old_row(rids[i]);
+    ASSERT_EQ(1, table_page.UpdateTuple(new_row, &old_row, schema.get(), nullptr, nullptr, nullptr));
+  }
+  // reuse the freed slots with the remaining space
+  for (size_t i = 0; i < rids.size(); i += 2) {
+    Row row = make_row(static_cast<int>(i), 4);
+    if (!table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr)) {
+      break;
+    }
+    ASSERT_EQ(rids[i], row.GetRowId());
+  }
+  RowId rid;
+  for (bool ok = table_page.GetFirstTupleRid(&rid); ok; ok = table_page.GetNextTupleRid(rid, &rid)) {
+    Row row(rid);
+    ASSERT_TRUE(table_page.GetTuple(&row, schema.get(), nullptr, nullptr));
+    int id = row.GetField(0)->GetIntVal();
+    ASSERT_EQ(static_cast<int>(rid.GetSlotNum()), id);
+    Row expected = make_row(id, id % 2 == 1 ? 32 : 4);
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(*expected.GetField(1)));
+  }
+}
@@ -0,0 +1,89 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/filter_kernels.h"
+
+namespace {
+
+const CompareOp ops[] = {CompareOp::kEquals, CompareOp::kNotEquals, CompareOp::kLessThan,
+                         CompareOp::kGreaterThan, CompareOp::kLessThanEquals, CompareOp::kGreaterThanEquals};
+
+template<typename T>
+bool Expected(T value, CompareOp op, T operand) {
+  switch (op) {
+    case CompareOp::kEquals:
+      return value == operand;
+    case CompareOp::kNotEquals:
+      return value != operand;
+    case CompareOp::kLessThan:
+      return value < operand;
+    case CompareOp::kGreaterThan:
+      return value > operand;
+    case CompareOp::kLessThanEquals:
+      return value <= operand;
+    default:
+      return value >= operand;
+  }
+}
+
+template<typename T>
+void CheckMatch(const std::vector<T> &values, uint32_t count, CompareOp op, T operand,
+                const std::vector<uint64_t> &match) {
+  for (uint32_t i = 0; i < count; i++) {
+    ASSERT_EQ(Expected(values[i], op, operand), (match[i / 64] >> (i % 64)) & 1) << i;
+  }
+  // no bit past the last value
+  if (count % 64 != 0) {
+    ASSERT_EQ(0u, match[count / 64] >> (count % 64));
+  }
+}
+
+}  // namespace
+
+TEST(FilterKernelsTest, NumericFilterTest) {
+  std::mt19937 random(7);
+  for (uint32_t count : {0u, 1u, 7u, 8u, 63u, 64u, 65u, 100u, 1000u}) {
+    std::vector<int32_t> ints(count);
+    std::vector<float> floats(count);
+    for (uint32_t i = 0; i < count; i++) {
+      ints[i] = static_cast<int32_t>(random() % 21) - 10;
+      floats[i] = static_cast<float>(ints[i]) / 4;
+    }
+    std::vector<uint64_t> match((count + 63) / 64 + 1, ~0ULL);
+    for (auto op : ops) {
+      for (int32_t operand : {-11, -3, 0, 4, 10}) {
+        FilterInt32(ints.data(), count, op, operand, match.data());
+        CheckMatch(ints, count, op, operand, match);
+        FilterInt32Scalar(ints.data(), count, op, operand, match.data());
+        CheckMatch(ints, count, op, operand, match);
+        FilterFloat(floats.data(), count, op, operand / 4.f, match.data());
+        CheckMatch(floats, count, op, operand / 4.f, match);
+        FilterFloatScalar(floats.data(), count, op, operand / 4.f, match.data());
+        CheckMatch(floats, count, op, operand / 4.f, match);
+      }
+    }
+  }
+}
+
+TEST(FilterKernelsTest, CharFilterTest) {
+  const uint32_t width = sizeof(uint32_t) + 4;
+  const char *strings[] = {"", "a", "ab", "abc", "abd", "b", "abcd"};
+  const uint32_t count = 70;
+  std::vector<char> values(width * count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t len = strlen(strings[i % 7]);
+    memcpy(&values[i * width], &len, sizeof(uint32_t));
+    memcpy(&values[i * width + sizeof(uint32_t)], strings[i % 7], len);
+  }
+  std::vector<uint64_t> match(2);
+  for (auto op : ops) {
+    for (auto operand : strings) {
+      FilterChar(values.data(), width, count, op, operand, strlen(operand), match.data());
+      for (uint32_t i = 0; i < count; i++) {
+        ASSERT_EQ(Expected(strcmp(strings[i % 7], operand), op, 0), (match[i / 64] >> (i % 64)) & 1);
+      }
+    }
+  }
+}
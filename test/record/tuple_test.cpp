@@ -117,4 +117,124 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TupleTest, RowReuseAndMoveTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  Schema schema(columns);
+  std::vector<Field> first_fields = {
+          Field(TypeId::kTypeInt, 1),
+          Field(TypeId::kTypeChar, chars[1], strlen(chars[1]), false)
+  };
+  std::vector<Field> second_fields = {
+          Field(TypeId::kTypeInt, 2),
+          Field(TypeId::kTypeChar)
+  };
+  char first_buf[PAGE_SIZE], second_buf[PAGE_SIZE];
+  Row(first_fields).SerializeTo(first_buf, &schema);
+  Row(second_fields).SerializeTo(second_buf, &schema);
+  // deserializing again replaces the values of the fields but keeps the fields
+  Row row;
+  row.DeserializeFrom(first_buf, &schema);
+  Field *id = row.GetField(0), *name = row.GetField(1);
+  row.DeserializeFrom(second_buf, &schema);
+  ASSERT_EQ(id, row.GetField(0));
+  ASSERT_EQ(name, row.GetField(1));
+  ASSERT_EQ(2, row.GetField(0)->GetIntVal());
+  ASSERT_TRUE(row.GetField(1)->IsNull());
+  row.DeserializeFrom(first_buf, &schema);
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(first_fields[1]));
+  // a moved row takes the fields over without copying them
+  row.SetRowId(RowId(1, 2));
+  Row moved(std::move(row));
+  ASSERT_EQ(0u, row.GetFieldCount());
+  ASSERT_EQ(name, moved.GetField(1));
+  ASSERT_EQ(RowId(1, 2), moved.GetRowId());
+  Row copy;
+  copy = moved;
+  ASSERT_NE(name, copy.GetField(1));
+  ASSERT_EQ(CmpBool::kTrue, copy.GetField(1)->CompareEquals(first_fields[1]));
+  Row assigned(second_fields);
+  assigned = std::move(moved);
+  ASSERT_EQ(name, assigned.GetField(1));
+  ASSERT_EQ(CmpBool::kTrue, assigned.GetField(1)->CompareEquals(first_fields[1]));
+  ASSERT_EQ(2, moved.GetField(0)->GetIntVal());
+}
+
+TEST(TupleTest, WideRowTest) {
+  SimpleMemHeap heap;
+  // more than 32 columns with nulls spread over all of them
+  const uint32_t column_nums = 40;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < column_nums; i++) {
+    std::string name = "col" + std::to_string(i);
+    if (i % 3 == 0) {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 16, i, true, false));
+      if (i % 4 == 0) {
+        fields.emplace_back(TypeId::kTypeChar, nullptr, 0, false);
+      } else {
+        fields.emplace_back(TypeId::kTypeChar, chars[i % 3 + 1], strlen(chars[i % 3 + 1]), false);
+      }
+    } else {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+      if (i % 4 == 0) {
+        fields.emplace_back(TypeId::kTypeInt);
+      } else {
+        fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i * 7));
+      }
+    }
+  }
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+  Row row2;
+  ASSERT_EQ(size, row2.DeserializeFrom(buffer, schema.get()));
+  ASSERT_EQ(column_nums, row2.GetFieldCount());
+  for (uint32_t i = 0; i < column_nums; i++) {
+    ASSERT_EQ(fields[i].IsNull(), row2.GetField(i)->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+  // random access to a single field
+  for (uint32_t i = column_nums; i-- > 0;) {
+    Field *field = Row::DeserializeField(buffer, schema.get(), i, &heap);
+    ASSERT_EQ(fields[i].IsNull(), field->IsNull());
+    if (!fields[i].IsNull()) {
+      ASSERT_EQ(CmpBool::kTrue, field->CompareEquals(fields[i]));
+    }
+  }
+}
+
+TEST(TupleTest, SchemaColumnIndexTest) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns;
+  for (uint32_t i = 0; i < 40; i++) {
+    columns.push_back(ALLOC_COLUMN(heap)("col" + std::to_string(i), TypeId::kTypeInt, i, true, false));
+  }
+  Schema schema(columns);
+  char buffer[PAGE_SIZE];
+  schema.SerializeTo(buffer);
+  Schema *deserialized = nullptr;
+  Schema::DeserializeFrom(buffer, deserialized, &heap);
+  Schema *shallow = Schema::ShallowCopySchema(&schema, {31, 7}, &heap);
+  // the name index is built by every way a schema is created
+  uint32_t index;
+  for (uint32_t i = 0; i < 40; i++) {
+    ASSERT_EQ(DB_SUCCESS, schema.GetColumnIndex("col" + std::to_string(i), index));
+    ASSERT_EQ(i, index);
+    ASSERT_EQ(DB_SUCCESS, deserialized->GetColumnIndex("col" + std::to_string(i), index));
+    ASSERT_EQ(i, index);
+  }
+  ASSERT_EQ(DB_SUCCESS, shallow->GetColumnIndex("col7", index));
+  ASSERT_EQ(1u, index);
+  ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST, shallow->GetColumnIndex("col8", index));
+  ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST, schema.GetColumnIndex("col40", index));
+}
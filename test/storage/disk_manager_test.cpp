@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <unordered_set>
 
 #include "gtest/gtest.h"
@@ -55,4 +56,24 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, IsPageFreeTest) {
+  std::string db_name = "disk_free_test.db";
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  int extent_nums = 2;
+  for (uint32_t i = 0; i < DiskManager::BITMAP_SIZE * extent_nums; i++) {
+    disk_mgr->AllocatePage();
+  }
+  // pages past the first few of an extent and pages of the second extent are looked up in their own bitmap
+  std::vector<page_id_t> freed{3, 100, static_cast<page_id_t>(DiskManager::BITMAP_SIZE - 1),
+                               static_cast<page_id_t>(DiskManager::BITMAP_SIZE + 5)};
+  for (auto page_id : freed) {
+    disk_mgr->DeAllocatePage(page_id);
+  }
+  for (uint32_t i = 0; i < DiskManager::BITMAP_SIZE * extent_nums; i++) {
+    bool is_freed = std::find(freed.begin(), freed.end(), static_cast<page_id_t>(i)) != freed.end();
+    ASSERT_EQ(is_freed, disk_mgr->IsPageFree(i)) << "page " << i;
+  }
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <iostream>
 using namespace std;
 
@@ -89,3 +91,545 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(delete_success, true);
 }
+
+TEST(TableHeapTest, PaxTableHeapTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 5000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap,
+                                            TableLayout::kPaxLayout);
+  ASSERT_GT(table_heap->GetPaxLayout().GetCapacity(), 0);
+  std::unordered_map<int64_t, int32_t> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    char characters[16];
+    int32_t len = RandomUtils::RandomInt(0, 16);
+    RandomUtils::RandomString(characters, len);
+    Fields fields{
+            Field(TypeId::kTypeInt, i),
+            i % 10 == 0 ? Field(TypeId::kTypeChar, nullptr, 0, false)
+                        : Field(TypeId::kTypeChar, characters, len, true),
+            Field(TypeId::kTypeFloat, static_cast<float>(i))
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    row_ids[row.GetRowId().Get()] = i;
+  }
+  // a char value longer than the column is rejected
+  char too_long[32] = "this string is far too long";
+  Fields bad_fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, too_long, 32, true),
+                    Field(TypeId::kTypeFloat, 0.f)};
+  Row bad_row(bad_fields);
+  ASSERT_FALSE(table_heap->InsertTuple(bad_row, nullptr));
+  // update in place and delete
+  RowId upd_rid, del_rid;
+  for (auto &kv : row_ids) {
+    if (kv.second == 100) upd_rid = RowId(kv.first);
+    if (kv.second == 200) del_rid = RowId(kv.first);
+  }
+  Fields new_fields{Field(TypeId::kTypeInt, 100), Field(TypeId::kTypeChar, const_cast<char *>("updated"), 7, true),
+                    Field(TypeId::kTypeFloat, -1.f)};
+  Row new_row(new_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, upd_rid, nullptr));
+  ASSERT_EQ(upd_rid, new_row.GetRowId());
+  ASSERT_TRUE(table_heap->MarkDelete(del_rid, nullptr));
+  table_heap->ApplyDelete(del_rid, nullptr);
+  // full scan
+  int count = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    int32_t id = it->GetField(0)->GetIntVal();
+    ASSERT_NE(200, id);
+    ASSERT_EQ(row_ids[it->GetRowId().Get()], id);
+    ASSERT_EQ(id % 10 == 0 && id != 100, it->GetField(1)->IsNull());
+    if (id == 100) {
+      ASSERT_EQ(CmpBool::kTrue, it->GetField(1)->CompareEquals(*new_row.GetField(1)));
+    } else {
+      ASSERT_EQ(static_cast<float>(id), it->GetField(2)->GetFloatVal());
+    }
+    count++;
+  }
+  ASSERT_EQ(row_nums - 1, count);
+  // column access reads the id minipage only
+  int64_t id_sum = 0;
+  const PaxLayout &layout = table_heap->GetPaxLayout();
+  for (page_id_t page_id = table_heap->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    auto page = reinterpret_cast<PaxPage *>(engine.bpm_->FetchPage(page_id));
+    auto ids = reinterpret_cast<const int32_t *>(page->GetValues(layout, 0));
+    const uint64_t *live = page->GetLiveBitmap();
+    for (uint32_t slot = 0; slot < page->GetTupleCount(); slot++) {
+      if ((live[slot / 64] >> (slot % 64)) & 1) id_sum += ids[slot];
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    engine.bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  ASSERT_EQ(static_cast<int64_t>(row_nums) * (row_nums - 1) / 2 - 200, id_sum);
+}
+
+TEST(TableHeapTest, OverflowTableHeapTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 300;
+  const uint32_t max_len = 2 * PAGE_SIZE;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("doc", TypeId::kTypeChar, max_len, 1, true, false),
+          ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 16, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  // every third doc is too long to be kept in the tuple, some of them take more than one overflow page
+  auto make_doc = [&](int id) {
+    uint32_t len = id % 3 == 0 ? OVERFLOW_THRESHOLD + 1 + id * 97 % max_len : id % 50;
+    std::string doc(std::min(len, max_len), static_cast<char>('a' + id % 26));
+    doc[0] = static_cast<char>('A' + id % 26);
+    return doc;
+  };
+  std::unordered_map<int64_t, int32_t> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    std::string doc = make_doc(i);
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(doc.c_str()), doc.size(), true),
+                  Field(TypeId::kTypeChar, const_cast<char *>("note"), 4, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    ASSERT_TRUE(row.GetOverflowRefs().empty());
+    row_ids[row.GetRowId().Get()] = i;
+  }
+  // point reads load every value
+  for (auto &kv : row_ids) {
+    Row row(RowId(kv.first));
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    std::string doc = make_doc(kv.second);
+    ASSERT_EQ(doc, std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+    ASSERT_EQ(0, memcmp("note", row.GetField(2)->GetData(), 4));
+  }
+  // a scan without the doc column does not read the overflow pages
+  std::vector<page_id_t> overflow_pages;
+  RowId long_rid, short_rid;
+  std::vector<uint32_t> projection{0, 2};
+  for (auto it = table_heap->Begin(nullptr, projection); it != table_heap->End(); ++it) {
+    int32_t id = it->GetField(0)->GetIntVal();
+    bool is_long = id % 3 == 0;
+    ASSERT_EQ(is_long ? 1u : 0u, it->GetOverflowRefs().size());
+    ASSERT_EQ(is_long, it->GetField(1)->IsNull());
+    ASSERT_FALSE(it->GetField(2)->IsNull());
+    if (is_long) {
+      ASSERT_EQ(make_doc(id).size(), it->GetOverflowRefs()[0].second.length_);
+      overflow_pages.push_back(it->GetOverflowRefs()[0].second.page_id_);
+      if (id == 3) long_rid = it->GetRowId();
+    } else if (id == 4) {
+      short_rid = it->GetRowId();
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(row_nums / 3), overflow_pages.size());
+  // deleting a long value frees its overflow pages
+  ASSERT_TRUE(table_heap->MarkDelete(long_rid, nullptr));
+  table_heap->ApplyDelete(long_rid, nullptr);
+  ASSERT_TRUE(engine.bpm_->IsPageFree(overflow_pages[1]));
+  ASSERT_FALSE(engine.bpm_->IsPageFree(overflow_pages[2]));
+  // a short value grows out of line in place
+  std::string new_doc(max_len, 'z');
+  Fields new_fields{Field(TypeId::kTypeInt, 4),
+                    Field(TypeId::kTypeChar, const_cast<char *>(new_doc.c_str()), new_doc.size(), true),
+                    Field(TypeId::kTypeChar, nullptr, 0, false)};
+  Row new_row(new_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, short_rid, nullptr));
+  ASSERT_EQ(short_rid, new_row.GetRowId());
+  Row read_row(short_rid);
+  ASSERT_TRUE(table_heap->GetTuple(&read_row, nullptr));
+  ASSERT_EQ(new_doc, std::string(read_row.GetField(1)->GetData(), read_row.GetField(1)->GetLength()));
+  ASSERT_TRUE(read_row.GetField(2)->IsNull());
+  int count = 0;
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    ASSERT_TRUE(it->GetOverflowRefs().empty());
+    ASSERT_NE(3, it->GetField(0)->GetIntVal());
+    count++;
+  }
+  ASSERT_EQ(row_nums - 1, count);
+}
+
+TEST(TableHeapTest, OverflowUpdateTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const uint32_t max_len = 2 * PAGE_SIZE;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("doc", TypeId::kTypeChar, max_len, 1, true, false),
+          ALLOC_COLUMN(heap)("big", TypeId::kTypeChar, max_len, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::string doc(PAGE_SIZE + 100, 'd');
+  std::string big(OVERFLOW_THRESHOLD + 100, 'b');
+  auto make_row = [&](int id, const std::string &doc_value) {
+    Fields fields{Field(TypeId::kTypeInt, id),
+                  Field(TypeId::kTypeChar, const_cast<char *>(doc_value.c_str()), doc_value.size(), true),
+                  Field(TypeId::kTypeChar, const_cast<char *>(big.c_str()), big.size(), true)};
+    return Row(fields);
+  };
+  auto read_refs = [&](const RowId &rid) {
+    std::vector<uint32_t> projection{0};
+    for (auto it = table_heap->Begin(nullptr, projection); it != table_heap->End(); ++it) {
+      if (it->GetRowId() == rid) return it->GetOverflowRefs();
+    }
+    return std::vector<std::pair<uint32_t, OverflowRef>>();
+  };
+  Row row = make_row(0, doc);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  RowId rid = row.GetRowId();
+  auto refs = read_refs(rid);
+  ASSERT_EQ(2u, refs.size());
+  // only the column that changed gets a new chain, the unchanged one keeps its pages
+  Row same_row = make_row(1, doc);
+  ASSERT_TRUE(table_heap->UpdateTuple(same_row, rid, nullptr));
+  auto same_refs = read_refs(rid);
+  ASSERT_EQ(2u, same_refs.size());
+  for (size_t i = 0; i < refs.size(); i++) {
+    ASSERT_EQ(refs[i].first, same_refs[i].first);
+    ASSERT_EQ(refs[i].second.page_id_, same_refs[i].second.page_id_);
+  }
+  std::string new_doc(PAGE_SIZE + 200, 'n');
+  Row new_row = make_row(1, new_doc);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, rid, nullptr));
+  auto new_refs = read_refs(rid);
+  ASSERT_EQ(2u, new_refs.size());
+  ASSERT_NE(refs[0].second.page_id_, new_refs[0].second.page_id_);
+  ASSERT_EQ(refs[1].second.page_id_, new_refs[1].second.page_id_);
+  ASSERT_TRUE(engine.bpm_->IsPageFree(refs[0].second.page_id_));
+  ASSERT_FALSE(engine.bpm_->IsPageFree(refs[1].second.page_id_));
+  Row read_row(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&read_row, nullptr));
+  ASSERT_EQ(1, read_row.GetField(0)->GetIntVal());
+  ASSERT_EQ(new_doc, std::string(read_row.GetField(1)->GetData(), read_row.GetField(1)->GetLength()));
+  ASSERT_EQ(big, std::string(read_row.GetField(2)->GetData(), read_row.GetField(2)->GetLength()));
+  // deleting the row frees the chain that was kept across the updates
+  ASSERT_TRUE(table_heap->MarkDelete(rid, nullptr));
+  table_heap->ApplyDelete(rid, nullptr);
+  ASSERT_TRUE(engine.bpm_->IsPageFree(refs[1].second.page_id_));
+}
+
+TEST(TableHeapTest, LongestValueTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("doc", TypeId::kTypeChar, VARCHAR_MAX_LEN, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  // the longest value a char column takes spans several pages
+  ASSERT_GT(VARCHAR_MAX_LEN - 1, 3u * PAGE_SIZE);
+  std::string doc(VARCHAR_MAX_LEN - 1, 'x');
+  for (size_t i = 0; i < doc.size(); i += 97) {
+    doc[i] = static_cast<char>('a' + i % 26);
+  }
+  Fields fields{Field(TypeId::kTypeInt, 1),
+                Field(TypeId::kTypeChar, const_cast<char *>(doc.c_str()), doc.size(), true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  Row read_row(row.GetRowId());
+  ASSERT_TRUE(table_heap->GetTuple(&read_row, nullptr));
+  ASSERT_EQ(doc, std::string(read_row.GetField(1)->GetData(), read_row.GetField(1)->GetLength()));
+}
+
+TEST(TableHeapTest, ForwardingUpdateTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 1000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 200, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("short name"), 10, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // the first page is full, growing its tuples moves them to other pages but keeps their RowIds
+  std::string long_name(200, 'x');
+  for (int i = 0; i < 10; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  Field(TypeId::kTypeChar, const_cast<char *>(long_name.c_str()), long_name.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->UpdateTuple(row, rids[i], nullptr));
+    ASSERT_EQ(rids[i], row.GetRowId());
+  }
+  // a moved tuple is updated again through its forwarding slot
+  std::string other_name(150, 'y');
+  Fields fields{Field(TypeId::kTypeInt, 0),
+                Field(TypeId::kTypeChar, const_cast<char *>(other_name.c_str()), other_name.size(), true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(row, rids[0], nullptr));
+  ASSERT_EQ(rids[0], row.GetRowId());
+  // and deleted through it
+  ASSERT_TRUE(table_heap->MarkDelete(rids[1], nullptr));
+  table_heap->ApplyDelete(rids[1], nullptr);
+  Row deleted_row(rids[1]);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted_row, nullptr));
+  for (int i = 0; i < 10; i++) {
+    if (i == 1) continue;
+    Row read_row(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&read_row, nullptr));
+    ASSERT_EQ(i, read_row.GetField(0)->GetIntVal());
+    ASSERT_EQ(i == 0 ? other_name : long_name,
+              std::string(read_row.GetField(1)->GetData(), read_row.GetField(1)->GetLength()));
+  }
+  // a scan sees every tuple once, at its original RowId
+  std::vector<int> seen(row_nums, 0);
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    int32_t id = it->GetField(0)->GetIntVal();
+    ASSERT_EQ(rids[id], it->GetRowId());
+    seen[id]++;
+  }
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(i == 1 ? 0 : 1, seen[i]);
+  }
+}
+
+TEST(TableHeapTest, DictionaryTableHeapTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 1000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("status", TypeId::kTypeChar, 32, 1, true, false)
+  };
+  columns[1]->SetDictEncoded(true);
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_NE(INVALID_PAGE_ID, table_heap->GetDictionaryPageId());
+  std::vector<std::string> statuses{"pending", "shipped", "delivered", "cancelled-by-customer"};
+  std::unordered_map<int64_t, int32_t> row_ids;
+  for (int i = 0; i < row_nums; i++) {
+    const std::string &status = statuses[i % statuses.size()];
+    Fields fields{Field(TypeId::kTypeInt, i),
+                  i % 10 == 0 ? Field(TypeId::kTypeChar, nullptr, 0, false)
+                              : Field(TypeId::kTypeChar, const_cast<char *>(status.c_str()), status.size(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    row_ids[row.GetRowId().Get()] = i;
+  }
+  // every distinct value got one code
+  std::vector<uint32_t> codes;
+  for (auto &status : statuses) {
+    uint32_t code;
+    ASSERT_TRUE(table_heap->GetDictionaryCode(1, status.c_str(), status.size(), &code));
+    codes.push_back(code);
+  }
+  ASSERT_EQ(statuses.size(), std::unordered_set<uint32_t>(codes.begin(), codes.end()).size());
+  uint32_t code;
+  ASSERT_FALSE(table_heap->GetDictionaryCode(1, "returned", 8, &code));
+  // point reads and full scans decode the values
+  for (auto &kv : row_ids) {
+    Row row(RowId(kv.first));
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(TypeId::kTypeChar, row.GetField(1)->GetType());
+    if (kv.second % 10 == 0) {
+      ASSERT_TRUE(row.GetField(1)->IsNull());
+    } else {
+      const std::string &status = statuses[kv.second % statuses.size()];
+      ASSERT_EQ(status, std::string(row.GetField(1)->GetData(), row.GetField(1)->GetLength()));
+    }
+  }
+  // a scan without the column returns its codes
+  std::vector<uint32_t> projection{0};
+  for (auto it = table_heap->Begin(nullptr, projection); it != table_heap->End(); ++it) {
+    int32_t id = it->GetField(0)->GetIntVal();
+    ASSERT_EQ(TypeId::kTypeInt, it->GetField(1)->GetType());
+    if (id % 10 == 0) {
+      ASSERT_TRUE(it->GetField(1)->IsNull());
+    } else {
+      ASSERT_EQ(static_cast<int32_t>(codes[id % statuses.size()]), it->GetField(1)->GetIntVal());
+    }
+  }
+  // update to a new value, then reload the heap and its dictionary from disk
+  RowId rid(row_ids.begin()->first);
+  Fields new_fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, const_cast<char *>("returned"), 8, true)};
+  Row new_row(new_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, rid, nullptr));
+  TableHeap *loaded_heap = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), schema.get(), nullptr,
+                                             nullptr, &heap, TableLayout::kRowLayout,
+                                             table_heap->GetDictionaryPageId());
+  ASSERT_TRUE(loaded_heap->GetDictionaryCode(1, "returned", 8, &code));
+  ASSERT_TRUE(loaded_heap->GetDictionaryCode(1, statuses[0].c_str(), statuses[0].size(), &code));
+  ASSERT_EQ(codes[0], code);
+  Row read_row(rid);
+  ASSERT_TRUE(loaded_heap->GetTuple(&read_row, nullptr));
+  ASSERT_EQ(-1, read_row.GetField(0)->GetIntVal());
+  ASSERT_EQ("returned", std::string(read_row.GetField(1)->GetData(), read_row.GetField(1)->GetLength()));
+}
+
+TEST(TableHeapTest, DictionaryFailedWriteTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("status", TypeId::kTypeChar, 32, 0, true, false),
+          ALLOC_COLUMN(heap)("note", TypeId::kTypeChar, 4, 1, true, false)
+  };
+  columns[0]->SetDictEncoded(true);
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap,
+                                            TableLayout::kPaxLayout);
+  auto make_row = [](const char *status, const char *note) {
+    Fields fields{Field(TypeId::kTypeChar, const_cast<char *>(status), strlen(status), true),
+                  Field(TypeId::kTypeChar, const_cast<char *>(note), strlen(note), true)};
+    return Row(fields);
+  };
+  Row row = make_row("pending", "ok");
+  ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  RowId rid = row.GetRowId();
+  // the note does not fit the pax layout, the new status must not get a code
+  uint32_t code;
+  Row bad_row = make_row("lost", "too long");
+  ASSERT_FALSE(table_heap->InsertTuple(bad_row, nullptr));
+  ASSERT_FALSE(table_heap->GetDictionaryCode(0, "lost", 4, &code));
+  Row bad_update = make_row("lost", "too long");
+  ASSERT_FALSE(table_heap->UpdateTuple(bad_update, rid, nullptr));
+  ASSERT_FALSE(table_heap->GetDictionaryCode(0, "lost", 4, &code));
+  // the code a failed write would have used goes to the next new value
+  Row update = make_row("shipped", "ok");
+  ASSERT_TRUE(table_heap->UpdateTuple(update, rid, nullptr));
+  ASSERT_TRUE(table_heap->GetDictionaryCode(0, "shipped", 7, &code));
+  ASSERT_EQ(1u, code);
+  TableHeap *loaded_heap = TableHeap::Create(engine.bpm_, table_heap->GetFirstPageId(), schema.get(), nullptr,
+                                             nullptr, &heap, TableLayout::kPaxLayout,
+                                             table_heap->GetDictionaryPageId());
+  ASSERT_FALSE(loaded_heap->GetDictionaryCode(0, "lost", 4, &code));
+  Row read_row(rid);
+  ASSERT_TRUE(loaded_heap->GetTuple(&read_row, nullptr));
+  ASSERT_EQ("shipped", std::string(read_row.GetField(0)->GetData(), read_row.GetField(0)->GetLength()));
+}
+
+TEST(TableHeapTest, SampleScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 20000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  std::unordered_map<page_id_t, int> page_sizes;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("sample"), 6, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    page_sizes[row.GetRowId().GetPageId()]++;
+  }
+  ASSERT_GT(page_sizes.size(), 50u);
+  auto scan = [&](const TableSample &sample) {
+    std::vector<int32_t> ids;
+    for (auto it = table_heap->Begin(nullptr, sample); it != table_heap->End(); ++it) {
+      ids.push_back(it->GetField(0)->GetIntVal());
+    }
+    return ids;
+  };
+  // block sampling returns whole pages
+  TableSample block{TableSample::Method::kBlock, 20, 7};
+  std::unordered_map<page_id_t, int> sampled_pages;
+  for (auto it = table_heap->Begin(nullptr, block); it != table_heap->End(); ++it) {
+    sampled_pages[it->GetRowId().GetPageId()]++;
+  }
+  ASSERT_GT(sampled_pages.size(), 0u);
+  ASSERT_LT(sampled_pages.size(), page_sizes.size() / 2);
+  for (auto &kv : sampled_pages) {
+    ASSERT_EQ(page_sizes[kv.first], kv.second);
+  }
+  // the same seed gives the same sample, another one a different sample
+  ASSERT_EQ(scan(block), scan(block));
+  ASSERT_NE(scan(block), scan(TableSample{TableSample::Method::kBlock, 20, 8}));
+  // bernoulli sampling keeps about the given share of rows, spread over the pages
+  TableSample bernoulli{TableSample::Method::kBernoulli, 10, 7};
+  std::vector<int32_t> ids = scan(bernoulli);
+  ASSERT_NEAR(row_nums / 10, static_cast<int>(ids.size()), row_nums / 50);
+  ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  ASSERT_LT(ids.front(), row_nums / 10);
+  ASSERT_GT(ids.back(), row_nums - row_nums / 10);
+  // a projected sample reads the same rows
+  std::vector<uint32_t> projection{0};
+  size_t count = 0;
+  for (auto it = table_heap->Begin(nullptr, projection, bernoulli); it != table_heap->End(); ++it) {
+    ASSERT_EQ(ids[count++], it->GetField(0)->GetIntVal());
+  }
+  ASSERT_EQ(ids.size(), count);
+  ASSERT_TRUE(scan(TableSample{TableSample::Method::kBernoulli, 0, 7}).empty());
+  ASSERT_EQ(static_cast<size_t>(row_nums), scan(TableSample{TableSample::Method::kBlock, 100, 7}).size());
+}
+
+TEST(TableHeapTest, BatchScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap,
+                                            TableLayout::kPaxLayout);
+  const char *names[] = {"a", "bb", "ccc", "bba"};
+  std::vector<RowId> rids;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{
+            Field(TypeId::kTypeInt, i),
+            i % 7 == 0 ? Field(TypeId::kTypeChar) : Field(TypeId::kTypeChar, const_cast<char *>(names[i % 4]),
+                                                          strlen(names[i % 4]), true),
+            i % 11 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, static_cast<float>(i % 100) - 50)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  for (int i = 0; i < row_nums; i += 13) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], nullptr));
+    table_heap->ApplyDelete(rids[i], nullptr);
+  }
+  auto check = [&](std::vector<ColumnPredicate> &predicates) {
+    std::vector<int32_t> expected, actual;
+    for (auto it = table_heap->Begin(nullptr), end = table_heap->End(); it != end; ++it) {
+      bool matches = true;
+      for (auto &p : predicates) {
+        TypeId type = schema->GetColumn(p.column_index_)->GetType();
+        matches = matches && GetMatchKernel(type, p.op_)(*it->GetField(p.column_index_), p.operand_);
+      }
+      if (matches) expected.push_back(it->GetField(0)->GetIntVal());
+    }
+    ASSERT_TRUE(table_heap->ScanBatch(nullptr, predicates, nullptr, [&](const Row &row) {
+      actual.push_back(row.GetField(0)->GetIntVal());
+    }));
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected, actual);
+  };
+  std::vector<ColumnPredicate> predicates;
+  predicates.emplace_back(0, CompareOp::kGreaterThanEquals, Field(TypeId::kTypeInt, 1234));
+  check(predicates);
+  predicates.emplace_back(2, CompareOp::kLessThan, Field(TypeId::kTypeFloat, 10.f));
+  check(predicates);
+  predicates.emplace_back(1, CompareOp::kNotEquals, Field(TypeId::kTypeChar, const_cast<char *>("bb"), 2, false));
+  check(predicates);
+  predicates.clear();
+  predicates.emplace_back(1, CompareOp::kEquals, Field(TypeId::kTypeChar, const_cast<char *>("bba"), 3, false));
+  check(predicates);
+  predicates.clear();
+  predicates.emplace_back(1, CompareOp::kGreaterThan, Field(TypeId::kTypeChar, const_cast<char *>("bb"), 2, false));
+  predicates.emplace_back(2, CompareOp::kEquals, Field(TypeId::kTypeFloat, 8.f));
+  check(predicates);
+  // the operand must have the type of the column, and only PAX tables are scanned by batch
+  predicates.clear();
+  predicates.emplace_back(0, CompareOp::kEquals, Field(TypeId::kTypeFloat, 1.f));
+  ASSERT_FALSE(table_heap->ScanBatch(nullptr, predicates, nullptr, [](const Row &) {}));
+  TableHeap *row_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  ASSERT_FALSE(row_heap->ScanBatch(nullptr, {}, nullptr, [](const Row &) {}));
+}
@@ -0,0 +1,51 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "utils/mem_heap.h"
+
+TEST(MemHeapTest, ArenaMemHeapTest) {
+  ArenaMemHeap heap(64);
+  auto first = static_cast<char *>(heap.Allocate(3));
+  auto second = static_cast<char *>(heap.Allocate(8));
+  ASSERT_EQ(first + ArenaMemHeap::ALIGNMENT, second);
+  // larger than a chunk, served by a new chunk
+  auto large = static_cast<char *>(heap.Allocate(1000));
+  memset(large, 'x', 1000);
+  memset(second, 'y', 8);
+  ASSERT_EQ('x', large[999]);
+  int destroyed = 0;
+  struct Counter {
+    explicit Counter(int *count) : count_(count) {}
+    ~Counter() { (*count_)++; }
+    int *count_;
+  };
+  heap.New<Counter>(&destroyed);
+  std::string value(100, 'z');
+  auto copy = heap.New<std::string>(value);
+  ASSERT_EQ(value, *copy);
+  heap.Reset();
+  ASSERT_EQ(1, destroyed);
+  // the first chunk is reused after reset
+  ASSERT_EQ(first, heap.Allocate(16));
+  heap.Reset();
+  ASSERT_EQ(1, destroyed);
+}
+
+TEST(MemHeapTest, PoolMemHeapTest) {
+  PoolMemHeap heap;
+  void *small = heap.Allocate(10);
+  void *medium = heap.Allocate(100);
+  void *large = heap.Allocate(PoolMemHeap::MAX_BLOCK_SIZE + 1);
+  memset(large, 0, PoolMemHeap::MAX_BLOCK_SIZE + 1);
+  heap.Free(small);
+  heap.Free(medium);
+  heap.Free(large);
+  heap.Free(nullptr);
+  // freed blocks are reused by allocations of the same size class
+  ASSERT_EQ(medium, heap.Allocate(128));
+  ASSERT_EQ(small, heap.Allocate(16));
+  void *other = heap.Allocate(16);
+  ASSERT_NE(small, other);
+  heap.Free(other);
+  ASSERT_EQ(other, heap.Allocate(1));
+}